@@ -24,7 +24,7 @@
 #include "bitmap_font.hpp"
 #include "ui.hpp"
 
-Ability::Ability() : activated(false), hovered(false), ability_texture(nullptr)
+Ability::Ability() : activated(false), hovered(false), ability_texture(nullptr), ability_id(ABILITY_NONE)
 {
 	cooldown = std::make_pair(0, 0);
 	ability_desc = "Description";
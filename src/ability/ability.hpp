@@ -18,14 +18,16 @@
 #ifndef ABILITY_HPP
 #define ABILITY_HPP
 
+#include "ability_registry.hpp"
+
 class Actor;
 class Hero;
 class Level;
 
 typedef struct
 {
-	uint8_t xpos;
-	uint8_t ypos;
+	coord_t xpos;
+	coord_t ypos;
 	Actor *target;
 }
 TargetNode;
@@ -47,6 +49,8 @@ public:
 	bool init_texture(const std::string &icon, SDL_Color color);
 
 	std::string get_ability_name() const { return ability_name; }
+	AbilityID get_ability_id() const { return ability_id; }
+	void set_ability_id(AbilityID id) { ability_id = id; }
 
 	bool get_hovered() const { return hovered; }
 	void set_hovered(bool h) { hovered = h; }
@@ -56,6 +60,7 @@ protected:
 	bool hovered;
 
 	SDL_Texture *ability_texture;
+	AbilityID ability_id;
 	std::string ability_name;
 	std::string ability_desc;
 
@@ -75,8 +75,8 @@ void AbilityDismount::apply(Hero *hero, bool cancel)
 		hero->set_ability_activated(true);
 		hero->clear_pathfinder();
 
-		const uint8_t xpos = hero->get_grid_x();
-		const uint8_t ypos = hero->get_grid_y();
+		const coord_t xpos = hero->get_grid_x();
+		const coord_t ypos = hero->get_grid_y();
 
 		if (!level->get_wall(xpos, ypos - 1, true)) valid_nodes.push_back(std::make_pair(xpos, ypos - 1));
 		if (!level->get_wall(xpos, ypos + 1, true)) valid_nodes.push_back(std::make_pair(xpos, ypos + 1));
@@ -97,8 +97,8 @@ void AbilityDismount::render(uint16_t xpos, uint16_t ypos, SDL_Keycode key) cons
 }
 bool AbilityDismount::get_click(uint16_t mouse_x, uint16_t mouse_y)
 {
-	const int8_t map_x = (mouse_x + camera.get_cam_x()) / 32;
-	const int8_t map_y = (mouse_y + camera.get_cam_y()) / 32;
+	const int32_t map_x = (mouse_x + camera.get_cam_x()) / 32;
+	const int32_t map_y = (mouse_y + camera.get_cam_y()) / 32;
 
 	for (auto node : valid_nodes)
 	{
@@ -106,7 +106,7 @@ bool AbilityDismount::get_click(uint16_t mouse_x, uint16_t mouse_y)
 		{
 			if (temp_hero != nullptr)
 			{
-				temp_hero->remove_ability("dismount");
+				temp_hero->remove_ability(ABILITY_DISMOUNT);
 				temp_hero->add_action(ACTION_MOVE, map_x, map_y, 1);
 				temp_hero->set_moves(0);
 			}
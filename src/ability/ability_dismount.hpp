@@ -39,7 +39,7 @@ public:
 	virtual void clear(Hero *hero);
 
 private:
-	std::vector<std::pair<uint8_t, uint8_t> > valid_nodes;
+	std::vector<std::pair<coord_t, coord_t> > valid_nodes;
 	Texture *target_texture;
 	Hero *temp_hero;
 };
@@ -24,6 +24,7 @@
 #include "scene_manager.hpp"
 #include "texture_manager.hpp"
 #include "level.hpp"
+#include "stencil.hpp"
 #include "scenario.hpp"
 
 AbilityDispel::AbilityDispel() : target_texture(nullptr), temp_hero(nullptr)
@@ -70,22 +71,19 @@ void AbilityDispel::apply(Hero *hero, bool cancel)
 		if (level == nullptr)
 			return;
 
-		const uint8_t x = hero->get_grid_x();
-		const uint8_t y = hero->get_grid_y();
+		const coord_t x = hero->get_grid_x();
+		const coord_t y = hero->get_grid_y();
 
-		for (int8_t ypos = -2; ypos < 3; ypos++)
+		const uint32_t targets = level->find_actors(x, y, ACTOR_NULL, Stencil::get_square());
+		for (uint8_t bit = 0; targets != 0 && bit < STENCIL_SIZE * STENCIL_SIZE; bit++)
 		{
-			for (int8_t xpos = -2; xpos < 3; xpos++)
+			if ((targets >> bit) & 1)
 			{
-				Actor *temp_actor = level->get_actor(x + xpos, y + ypos);
-				if (temp_actor != nullptr)
-				{
-					TargetNode tn;
-					tn.xpos = x + xpos;
-					tn.ypos = y + ypos;
-					tn.target = temp_actor;
-					valid_nodes.push_back(tn);
-				}
+				TargetNode tn;
+				tn.xpos = x + get_stencil_x(bit);
+				tn.ypos = y + get_stencil_y(bit);
+				tn.target = level->get_actor(tn.xpos, tn.ypos);
+				valid_nodes.push_back(tn);
 			}
 		}
 		hero->clear_pathfinder();
@@ -105,8 +103,8 @@ void AbilityDispel::render(uint16_t xpos, uint16_t ypos, SDL_Keycode key) const
 }
 bool AbilityDispel::get_click(uint16_t mouse_x, uint16_t mouse_y)
 {
-	const int8_t map_x = (mouse_x + camera.get_cam_x()) / 32;
-	const int8_t map_y = (mouse_y + camera.get_cam_y()) / 32;
+	const int32_t map_x = (mouse_x + camera.get_cam_x()) / 32;
+	const int32_t map_y = (mouse_y + camera.get_cam_y()) / 32;
 
 	for (auto node : valid_nodes)
 	{
@@ -59,7 +59,7 @@ void AbilityManager::render_ui(Hero *hero) const
 
 		for (auto *a : loaded_abilities)
 		{
-			if (hero->has_ability(a->get_ability_name()))
+			if (hero->has_ability(a->get_ability_id()))
 			{
 				a->render(xpos, ypos, hotkeys[ypos / 48 - 1]);
 				ypos += 48;
@@ -94,7 +94,11 @@ void AbilityManager::load_ability(const std::string &ability)
 	if (new_ability != nullptr)
 	{
 		if (new_ability->init())
+		{
+			// Looked up once here, the per frame checks only test the hero's ability bits
+			new_ability->set_ability_id(ability_registry.intern(new_ability->get_ability_name()));
 			loaded_abilities.push_back(new_ability);
+		}
 		else delete new_ability;
 	}
 }
@@ -113,7 +117,7 @@ bool AbilityManager::input_keyboard_down(Hero *hero, SDL_Keycode key)
 	uint8_t i = 0;
 	for (Ability *a : loaded_abilities)
 	{
-		if (hero->has_ability(a->get_ability_name()))
+		if (hero->has_ability(a->get_ability_id()))
 		{
 			if (key == hotkeys[i])
 			{
@@ -134,7 +138,7 @@ bool AbilityManager::get_overlap(Hero *hero, int16_t mouse_x, int16_t mouse_y) c
 
 	for (Ability *a : loaded_abilities)
 	{
-		if (!hero->has_ability(a->get_ability_name()))
+		if (!hero->has_ability(a->get_ability_id()))
 			continue;
 
 		if (mouse_x > xpos && mouse_y > ypos && mouse_y < ypos + 48)
@@ -154,7 +158,7 @@ bool AbilityManager::get_click(Hero *hero, int16_t mouse_x, int16_t mouse_y) con
 
 	for (Ability *a : loaded_abilities)
 	{
-		if (!hero->has_ability(a->get_ability_name()))
+		if (!hero->has_ability(a->get_ability_id()))
 			continue;
 
 		if (mouse_x > xpos && mouse_y > ypos && mouse_y < ypos + 48)
@@ -0,0 +1,66 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+#include "engine.hpp"
+#include "ability_registry.hpp"
+
+#include "logging.hpp"
+
+AbilityRegistry ability_registry;
+
+AbilityRegistry::AbilityRegistry()
+{
+	const std::string builtin[ABILITY_BUILTIN_COUNT] = {
+		"sleep", "shoot", "dispel", "sprout", "poison", "dismount", "level-up", "weakness", "necromancy"
+	};
+	for (const std::string &name : builtin)
+		intern(name);
+}
+AbilityRegistry::~AbilityRegistry()
+{
+
+}
+AbilityID AbilityRegistry::intern(const std::string &name)
+{
+	auto it = ids.find(name);
+	if (it != ids.end())
+		return it->second;
+
+	if (names.size() >= MAX_ABILITIES)
+	{
+		logging.cerr("Too many abilities, can't register " + name);
+		return ABILITY_NONE;
+	}
+	const AbilityID id = names.size();
+	names.push_back(name);
+	ids[name] = id;
+	return id;
+}
+AbilityID AbilityRegistry::find(const std::string &name) const
+{
+	auto it = ids.find(name);
+	if (it != ids.end())
+		return it->second;
+	return ABILITY_NONE;
+}
+const std::string& AbilityRegistry::get_name(AbilityID id) const
+{
+	static const std::string unknown = "???";
+	if (id >= names.size())
+		return unknown;
+	return names[id];
+}
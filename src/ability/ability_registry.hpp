@@ -0,0 +1,63 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ABILITY_REGISTRY_HPP
+#define ABILITY_REGISTRY_HPP
+
+#include <bitset>
+#include <unordered_map>
+#include <vector>
+
+typedef uint8_t AbilityID;
+
+const uint8_t MAX_ABILITIES = 64;
+const AbilityID ABILITY_NONE = 0xFF;
+
+typedef std::bitset<MAX_ABILITIES> AbilitySet;
+
+// The built in abilities are interned first and in this order, so the code can use them without a lookup
+enum BuiltinAbility
+{
+	ABILITY_SLEEP,
+	ABILITY_SHOOT,
+	ABILITY_DISPEL,
+	ABILITY_SPROUT,
+	ABILITY_POISON,
+	ABILITY_DISMOUNT,
+	ABILITY_LEVEL_UP,
+	ABILITY_WEAKNESS,
+	ABILITY_NECROMANCY,
+	ABILITY_BUILTIN_COUNT
+};
+
+class AbilityRegistry
+{
+public:
+	AbilityRegistry();
+	~AbilityRegistry();
+
+	AbilityID intern(const std::string &name);
+	AbilityID find(const std::string &name) const;
+	const std::string& get_name(AbilityID id) const;
+
+private:
+	std::vector<std::string> names;
+	std::unordered_map<std::string, AbilityID> ids;
+};
+extern AbilityRegistry ability_registry;
+
+#endif // ABILITY_REGISTRY_HPP
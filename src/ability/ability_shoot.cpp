@@ -24,6 +24,7 @@
 #include "scene_manager.hpp"
 #include "texture_manager.hpp"
 #include "level.hpp"
+#include "stencil.hpp"
 #include "scenario.hpp"
 
 AbilityShoot::AbilityShoot() : target_texture(nullptr), temp_hero(nullptr)
@@ -70,31 +71,20 @@ void AbilityShoot::apply(Hero *hero, bool cancel)
 		if (level == nullptr)
 			return;
 
-		const int8_t offset_x[12] = { -1, 0, 1, -2, -2, -2, 2, 2, 2, -1, 0, 1 };
-		const int8_t offset_y[12] = { -2, -2, -2, -1, 0, 1, -1, 0, 1, 2, 2, 2 };
 		valid_nodes.clear();
 
-		//   xxx
-		//  x...x    x = valid positions included in (offset_x[i], offset_y[i])
-		//  x.@.x    . = FoV blocking positions (just change any 2 into 1 in the offsets)
-		//  x...x    @ = hero position
-		//   xxx
+		const coord_t x = hero->get_grid_x();
+		const coord_t y = hero->get_grid_y();
 
-		const uint8_t x = hero->get_grid_x();
-		const uint8_t y = hero->get_grid_y();
+		// Every tile of the ring that isn't a wall and has no wall in the way
+		const Stencil &ranged = Stencil::get_ranged();
+		const uint32_t walls = level->get_wall_window(x, y);
+		const uint32_t open = ranged.get_open_cells(walls) & ~walls;
 
-		for (uint8_t i = 0; i < 12; i++)
+		for (uint8_t bit : ranged.get_order())
 		{
-			uint8_t block_x = x + offset_x[i];
-			if (offset_x[i] == -2) block_x += 1;
-			else if (offset_x[i] == 2) block_x -= 1;
-
-			uint8_t block_y = y + offset_y[i];
-			if (offset_y[i] == -2) block_y += 1;
-			else if (offset_y[i] == 2) block_y -= 1;
-
-			if (!level->get_wall(block_x, block_y) && !level->get_wall(x + offset_x[i], y + offset_y[i]))
-				valid_nodes.push_back(std::make_pair(x + offset_x[i], y + offset_y[i]));
+			if ((open >> bit) & 1)
+				valid_nodes.push_back(std::make_pair(x + get_stencil_x(bit), y + get_stencil_y(bit)));
 		}
 		hero->clear_pathfinder();
 		hero->set_ability_activated(true);
@@ -113,8 +103,8 @@ void AbilityShoot::render(uint16_t xpos, uint16_t ypos, SDL_Keycode key) const
 }
 bool AbilityShoot::get_click(uint16_t mouse_x, uint16_t mouse_y)
 {
-	const int8_t map_x = (mouse_x + camera.get_cam_x()) / 32;
-	const int8_t map_y = (mouse_y + camera.get_cam_y()) / 32;
+	const int32_t map_x = (mouse_x + camera.get_cam_x()) / 32;
+	const int32_t map_y = (mouse_y + camera.get_cam_y()) / 32;
 
 	for (auto node : valid_nodes)
 	{
@@ -76,8 +76,8 @@ void AbilitySprout::apply(Hero *hero, bool cancel)
 		hero->set_ability_activated(true);
 		hero->clear_pathfinder();
 
-		const uint8_t xpos = hero->get_grid_x();
-		const uint8_t ypos = hero->get_grid_y();
+		const coord_t xpos = hero->get_grid_x();
+		const coord_t ypos = hero->get_grid_y();
 
 		if (!level->get_wall(xpos, ypos - 1, true)) valid_nodes.push_back(std::make_pair(xpos, ypos - 1));
 		if (!level->get_wall(xpos, ypos + 1, true)) valid_nodes.push_back(std::make_pair(xpos, ypos + 1));
@@ -98,8 +98,8 @@ void AbilitySprout::render(uint16_t xpos, uint16_t ypos, SDL_Keycode key) const
 }
 bool AbilitySprout::get_click(uint16_t mouse_x, uint16_t mouse_y)
 {
-	const int8_t map_x = (mouse_x + camera.get_cam_x()) / 32;
-	const int8_t map_y = (mouse_y + camera.get_cam_y()) / 32;
+	const int32_t map_x = (mouse_x + camera.get_cam_x()) / 32;
+	const int32_t map_y = (mouse_y + camera.get_cam_y()) / 32;
 
 	for (auto node : valid_nodes)
 	{
@@ -114,7 +114,7 @@ bool AbilitySprout::get_click(uint16_t mouse_x, uint16_t mouse_y)
 				return true;
 
 			const std::string crops[6] = { "1", "2", "3", "4", "5", "6" };
-			const std::string crop_name = "level/decor/crop_" + crops[engine.get_rng() % 6] + ".png";
+			const std::string crop_name = "level/decor/crop_" + crops[engine.get_rng(RNG_COSMETIC) % 6] + ".png";
 			engine.get_actor_manager()->spawn_actor(level, ACTOR_PROP, node.first, node.second, crop_name);
 
 			if (temp_hero != nullptr)
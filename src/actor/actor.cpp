@@ -17,6 +17,7 @@
 
 #include "engine.hpp"
 #include "actor.hpp"
+#include "actor_manager.hpp"
 #include "mount.hpp"
 #include "level.hpp"
 #include "texture.hpp"
@@ -26,22 +27,15 @@
 #include "message_log.hpp"
 #include "ui.hpp"
 
-#include <algorithm> // Actor::remove_ability()
-
-uint16_t Actor::ID = 0;
+uint32_t Actor::ID = 0;
 
 Actor::Actor() :
-	actor_type(ACTOR_NULL), actor_ID(ID++), delete_me(false), in_camera(false), turn_done(false),
+	actor_type(ACTOR_NULL), actor_ID(ID++), handle(ACTOR_HANDLE_NONE), position(nullptr), animation(nullptr), vitals(nullptr), projectile(nullptr), ai(nullptr), delete_me(false),
 	name("???"), hovered(HOVER_NONE), anim_frames(0), anim_timer(0), texture(nullptr), bubble(nullptr),
-	status_icon(nullptr), status(STATUS_NONE), bubble_timer(0), combat_level(1), experience(0),
-	max_damage(1), max_moves(1), projectile(nullptr), proj_type(PROJECTILE_ARROW), mount(nullptr)
+	status_icon(nullptr), bubble_timer(0), combat_level(1), experience(0),
+	max_damage(1), max_moves(1), proj_type(PROJECTILE_ARROW), mount(nullptr)
 {
-	facing_right = (engine.get_rng() % 2 == 0);
 	current_action = { ACTION_NULL, 0, 0, 0 };
-	proj_rect = { 0, 0, 16, 16 };
-
-	moves = std::make_pair(0, 0);
-	health = std::make_pair(1, 1);
 }
 Actor::~Actor()
 {
@@ -54,10 +48,10 @@ void Actor::free()
 		engine.get_texture_manager()->free_texture(texture->get_name());
 		texture = nullptr;
 	}
-	if (projectile != nullptr)
+	if (projectile != nullptr && projectile->texture != nullptr)
 	{
-		engine.get_texture_manager()->free_texture(projectile->get_name());
-		projectile = nullptr;
+		engine.get_texture_manager()->free_texture(projectile->texture->get_name());
+		projectile->texture = nullptr;
 	}
 	if (bubble != nullptr)
 	{
@@ -77,7 +71,7 @@ void Actor::free()
 	if (!action_queue.empty())
 		std::queue<Action>().swap(action_queue);
 }
-bool Actor::init(ActorType at, uint8_t xpos, uint8_t ypos, const std::string &texture_name)
+bool Actor::init(ActorType at, coord_t xpos, coord_t ypos, const std::string &texture_name)
 {
 	if (texture_name.length() > 0)
 	{
@@ -86,22 +80,29 @@ bool Actor::init(ActorType at, uint8_t xpos, uint8_t ypos, const std::string &te
 			return false;
 	}
 	actor_type = at;
-	x = xpos * 32; y = ypos * 32;
-	grid_x = xpos; grid_y = ypos;
-	prev_x = xpos; prev_y = ypos;
-	frame_rect = { 0, 0, 16, 16 };
-	bubble_rect = { 0, 0, 16, 16 };
-
-	abilities.clear();
-	add_ability("sleep");
+	position->x = xpos * 32; position->y = ypos * 32;
+	position->grid_x = xpos; position->grid_y = ypos;
+	position->prev_x = xpos; position->prev_y = ypos;
+	animation->frame_rect = { 0, 0, 16, 16 };
+	animation->bubble_rect = { 0, 0, 16, 16 };
+	animation->idle_mode = (at == ACTOR_PROP) ? IDLE_STILL : IDLE_BOB;
+	animation->facing_right = (engine.get_rng(RNG_COSMETIC) % 2 == 0);
+
+	// Heroes are played, everyone else gets their turns from the AI systems
+	switch (at)
+	{
+		case ACTOR_HERO: ai->mode = AI_PLAYER; break;
+		case ACTOR_MONSTER: ai->mode = AI_MONSTER; break;
+		case ACTOR_MOUNT: ai->mode = AI_WANDER; break;
+		default: ai->mode = AI_NONE; break;
+	}
+
+	abilities.reset();
+	add_ability(ABILITY_SLEEP);
 	return true;
 }
 void Actor::update(Level *level)
 {
-	if (camera.get_in_camera_grid(grid_x, grid_y))
-		in_camera = true;
-	else in_camera = false;
-
 	if (current_action.type == ACTION_NULL && !action_queue.empty())
 	{
 		current_action = action_queue.front();
@@ -121,68 +122,70 @@ void Actor::update(Level *level)
 		if (clear_action)
 			current_action.type = ACTION_NULL;
 	}
+	animation->acting = current_action.type != ACTION_NULL;
 }
 void Actor::render() const
 {
-	if (texture != nullptr && in_camera && !delete_me)
+	if (texture != nullptr && position->in_camera && !delete_me)
 	{
 		if (mount == nullptr) // No mount, just render normally
 		{
 			texture->render(
-				x - camera.get_cam_x(), y - camera.get_cam_y(), &frame_rect,
-				2, facing_right ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE, 0.0
+				position->x - camera.get_cam_x(), position->y - camera.get_cam_y(), &animation->frame_rect,
+				2, animation->facing_right ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE, 0.0
 			);
 		}
 		else // When rendering a mount, we need to "split" our own texture into two
 		{
-			const uint8_t half_width = frame_rect.w / 2;
-			const SDL_Rect rect_left = { frame_rect.x, frame_rect.y, half_width, frame_rect.h };
-			const SDL_Rect rect_right = { frame_rect.x + half_width, frame_rect.y, half_width, frame_rect.h };
+			const uint8_t half_width = animation->frame_rect.w / 2;
+			const SDL_Rect rect_left = { animation->frame_rect.x, animation->frame_rect.y, half_width, animation->frame_rect.h };
+			const SDL_Rect rect_right = { animation->frame_rect.x + half_width, animation->frame_rect.y, half_width, animation->frame_rect.h };
 
 			texture->render(
-				x - camera.get_cam_x() + (facing_right ? frame_rect.w : 0),
-				y - camera.get_cam_y() - frame_rect.h, // Raise ourselves half a tile to appear on "top" of the mount
-				&rect_left, 2, facing_right ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE, 0.0
+				position->x - camera.get_cam_x() + (animation->facing_right ? animation->frame_rect.w : 0),
+				position->y - camera.get_cam_y() - animation->frame_rect.h, // Raise ourselves half a tile to appear on "top" of the mount
+				&rect_left, 2, animation->facing_right ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE, 0.0
 			);
 			mount->render(); // And render the mount in the middle, to create the illusion of sitting on top of it
 
 			texture->render(
-				x - camera.get_cam_x() + (half_width * 2) + (facing_right ? -frame_rect.w : 0),
-				y - camera.get_cam_y() - frame_rect.h, // Raise ourselves half a tile to appear on "top" of the mount
-				&rect_right, 2, facing_right ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE, 0.0
+				position->x - camera.get_cam_x() + (half_width * 2) + (animation->facing_right ? -animation->frame_rect.w : 0),
+				position->y - camera.get_cam_y() - animation->frame_rect.h, // Raise ourselves half a tile to appear on "top" of the mount
+				&rect_right, 2, animation->facing_right ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE, 0.0
 			);
 		}
 		if (bubble != nullptr)
-			bubble->render(x - camera.get_cam_x(), y - camera.get_cam_y() - 32, &bubble_rect);
+			bubble->render(position->x - camera.get_cam_x(), position->y - camera.get_cam_y() - 32, &animation->bubble_rect);
 
 		if (status_icon != nullptr)
-			status_icon->render(x - camera.get_cam_x(), y - camera.get_cam_y(), &bubble_rect);
+			status_icon->render(position->x - camera.get_cam_x(), position->y - camera.get_cam_y(), &animation->bubble_rect);
 	}
 }
 void Actor::render_ui(uint16_t xpos, uint16_t ypos) const
 {
-	if (projectile != nullptr)
-	{
-		projectile->render(
-			proj_x - camera.get_cam_x(), proj_y - camera.get_cam_y(), &proj_rect,
-			2, facing_right ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE, proj_angle
-		);
-	}
+	// Projectiles are drawn by ActorWorld::render_projectiles()
 }
 void Actor::death(Level *level)
 {
 
+}
+void Actor::set_delete(bool del)
+{
+	// Queue ourselves up so the manager doesn't have to look through every actor after each turn
+	if (del && !delete_me && engine.get_actor_manager() != nullptr)
+		engine.get_actor_manager()->queue_delete(this);
+	delete_me = del;
 }
 void Actor::start_turn()
 {
 	// Called when our turn to move begins.
-	turn_done = true;
+	ai->turn_done = true;
 }
 bool Actor::take_turn(Level *level)
 {
 	// Called continuously every frame when it's our turn.
 	// Return true once we're done with our turn.
-	return (turn_done && action_queue.empty());
+	return (ai->turn_done && action_queue.empty());
 }
 void Actor::end_turn()
 {
@@ -196,27 +199,27 @@ void Actor::end_turn()
 			bubble = nullptr;
 		}
 	}
-	if (status == STATUS_POISON)
+	if (vitals->status == STATUS_POISON)
 	{
-		if (health.first > 1)
+		if (vitals->health.first > 1)
 		{
-			health.first -= 1;
+			vitals->health.first -= 1;
 			if (ui.get_message_log() != nullptr)
 				ui.get_message_log()->add_message("The %Bpoison%F does %61%F damage to the " + name + "!");
 		}
 	}
-	else if (status == STATUS_WITHER)
+	else if (vitals->status == STATUS_WITHER)
 	{
-		health.first -= 1;
-		if (health.first < 1)
-			delete_me = true;
+		vitals->health.first -= 1;
+		if (vitals->health.first < 1)
+			set_delete(true);
 	}
-	else if (status == STATUS_REGEN)
+	else if (vitals->status == STATUS_REGEN)
 	{
-		if (health.first < health.second)
+		if (vitals->health.first < vitals->health.second)
 		{
 			add_health(1);
-			if (health.first == health.second)
+			if (vitals->health.first == vitals->health.second)
 				set_status(STATUS_NONE);
 		}
 	}
@@ -227,9 +230,9 @@ void Actor::interact(Level *level, Point pos)
 }
 uint8_t Actor::get_damage() const
 {
-	return (max_damage > 1) ? (engine.get_rng() % max_damage) + 1 : max_damage;
+	return (max_damage > 1) ? (engine.get_rng(RNG_COMBAT) % max_damage) + 1 : max_damage;
 }
-void Actor::add_action(ActionType at, uint8_t xpos, uint8_t ypos, int8_t value)
+void Actor::add_action(ActionType at, coord_t xpos, coord_t ypos, int8_t value)
 {
 	Action a = { at, xpos, ypos, value };
 	action_queue.push(a);
@@ -238,86 +241,66 @@ bool Actor::actions_empty() const
 {
 	return (action_queue.empty() && current_action.type == ACTION_NULL);
 }
-void Actor::action_idle()
-{
-	if (bubble_rect.y == 0)
-		bubble_rect.y = 16;
-	else bubble_rect.y = 0;
-
-	if (actor_type == ACTOR_HERO && moves.first <= 0)
-		frame_rect.y = 16;
-
-	else if (actor_type == ACTOR_PROP)
-		frame_rect.y = 0;
-
-	else if (current_action.type == ACTION_NULL)
-	{
-		if (frame_rect.y == 0)
-			frame_rect.y = 16;
-		else frame_rect.y = 0;
-		bubble_rect = frame_rect;
-	}
-}
 bool Actor::action_move(Level *level)
 {
 	anim_timer += engine.get_dt();
-	while (anim_timer > 18 || !in_camera)
+	while (anim_timer > 18 || !position->in_camera)
 	{
 		anim_timer -= 18;
 		if (anim_frames == 0)
 		{
-			turn_done = true;
+			ai->turn_done = true;
 
-			if (grid_x != current_action.xpos)
-				facing_right = (grid_x < current_action.xpos);
+			if (position->grid_x != current_action.xpos)
+				animation->facing_right = (position->grid_x < current_action.xpos);
 
 			if (mount != nullptr && current_action.action_value == 1)
 			{
-				level->set_actor(grid_x, grid_y, mount);
+				level->set_actor(position->grid_x, position->grid_y, mount);
 				mount->set_rider(nullptr);
 				set_mount(nullptr);
 			}
-			else level->set_actor(grid_x, grid_y, nullptr);
+			else level->set_actor(position->grid_x, position->grid_y, nullptr);
 
-			prev_x = grid_x;
-			prev_y = grid_y;
-			grid_x = current_action.xpos;
-			grid_y = current_action.ypos;
+			position->prev_x = position->grid_x;
+			position->prev_y = position->grid_y;
+			position->grid_x = current_action.xpos;
+			position->grid_y = current_action.ypos;
 
-			level->set_actor(grid_x, grid_y, this, false);
+			level->set_actor(position->grid_x, position->grid_y, this, false);
 
-			if (!in_camera)
+			if (!position->in_camera)
 			{
 				anim_frames = 16;
 				break;
 			}
-			frame_rect.y = 16;
+			animation->frame_rect.y = 16;
 		}
 		else if (anim_frames == 4)
-			frame_rect.y = 0;
+			animation->frame_rect.y = 0;
 		else if (anim_frames == 12)
-			frame_rect.y = 16;
+			animation->frame_rect.y = 16;
 
 		if (anim_frames % 2 == 0)
 		{
 			if (anim_frames < 8)
-				y -= anim_frames;
-			else y += anim_frames - 8;
+				position->y -= anim_frames;
+			else position->y += anim_frames - 8;
 		}
-		if (prev_x < grid_x) x += ((grid_x - prev_x) * 16) / 8;
-		else if (prev_x > grid_x) x -= ((prev_x - grid_x) * 16) / 8;
-		if (prev_y < grid_y) y += ((grid_y - prev_y) * 16) / 8;
-		else if (prev_y > grid_y) y -= ((prev_y - grid_y) * 16) / 8;
+		if (position->prev_x < position->grid_x) position->x += ((position->grid_x - position->prev_x) * 16) / 8;
+		else if (position->prev_x > position->grid_x) position->x -= ((position->prev_x - position->grid_x) * 16) / 8;
+		if (position->prev_y < position->grid_y) position->y += ((position->grid_y - position->prev_y) * 16) / 8;
+		else if (position->prev_y > position->grid_y) position->y -= ((position->prev_y - position->grid_y) * 16) / 8;
 
 		anim_frames += 1;
 	}
 	if (anim_frames >= 16)
 	{
-		frame_rect.y = 0;
+		animation->frame_rect.y = 0;
 		anim_timer = 0;
 		anim_frames = 0;
-		x = grid_x * 32;
-		y = grid_y * 32;
+		position->x = position->grid_x * 32;
+		position->y = position->grid_y * 32;
 		return true;
 	}
 	return false;
@@ -325,17 +308,17 @@ bool Actor::action_move(Level *level)
 bool Actor::action_attack(Level *level)
 {
 	anim_timer += engine.get_dt();
-	while (anim_timer > 18 || !in_camera)
+	while (anim_timer > 18 || !position->in_camera)
 	{
 		anim_timer -= 18;
 		if (anim_frames == 0)
 		{
-			if (grid_x != current_action.xpos)
-				facing_right = (grid_x < current_action.xpos);
+			if (position->grid_x != current_action.xpos)
+				animation->facing_right = (position->grid_x < current_action.xpos);
 		}
 		else if (anim_frames == 6)
 		{
-			turn_done = true;
+			ai->turn_done = true;
 
 			Actor *temp_actor = level->get_actor(current_action.xpos, current_action.ypos);
 			if (temp_actor != nullptr)
@@ -345,17 +328,17 @@ bool Actor::action_attack(Level *level)
 		{
 			if (anim_frames < 6) // Moving towards target
 			{
-				if (grid_x < current_action.xpos) x += 6;
-				else if (grid_x > current_action.xpos) x -= 6;
-				if (grid_y < current_action.ypos) y += 6;
-				else if (grid_y > current_action.ypos) y -= 6;
+				if (position->grid_x < current_action.xpos) position->x += 6;
+				else if (position->grid_x > current_action.xpos) position->x -= 6;
+				if (position->grid_y < current_action.ypos) position->y += 6;
+				else if (position->grid_y > current_action.ypos) position->y -= 6;
 			}
 			else // Moving away from target
 			{
-				if (grid_x < current_action.xpos) x -= 6;
-				else if (grid_x > current_action.xpos) x += 6;
-				if (grid_y < current_action.ypos) y -= 6;
-				else if (grid_y > current_action.ypos) y += 6;
+				if (position->grid_x < current_action.xpos) position->x -= 6;
+				else if (position->grid_x > current_action.xpos) position->x += 6;
+				if (position->grid_y < current_action.ypos) position->y -= 6;
+				else if (position->grid_y > current_action.ypos) position->y += 6;
 			}
 		}
 		anim_frames += 1;
@@ -364,8 +347,8 @@ bool Actor::action_attack(Level *level)
 	{
 		anim_timer = 0;
 		anim_frames = 0;
-		x = grid_x * 32;
-		y = grid_y * 32;
+		position->x = position->grid_x * 32;
+		position->y = position->grid_y * 32;
 		return true;
 	}
 	return false;
@@ -373,74 +356,75 @@ bool Actor::action_attack(Level *level)
 bool Actor::action_shoot(Level *level)
 {
 	anim_timer += engine.get_dt();
-	while (anim_timer > 18 || !in_camera)
+	while (anim_timer > 18 || !position->in_camera)
 	{
 		anim_timer -= 18;
 		if (anim_frames == 0)
 		{
-			if (projectile == nullptr) switch (proj_type)
+			if (projectile->texture == nullptr) switch (proj_type)
 			{
 				case PROJECTILE_SHURIKEN:
-					projectile = engine.get_texture_manager()->load_texture("item/shuriken.png");
+					projectile->texture = engine.get_texture_manager()->load_texture("item/shuriken.png");
 					break;
 				case PROJECTILE_DART:
-					projectile = engine.get_texture_manager()->load_texture("item/dart.png");
+					projectile->texture = engine.get_texture_manager()->load_texture("item/dart.png");
 					break;
 				case PROJECTILE_FIREBALL:
-					projectile = engine.get_texture_manager()->load_texture("item/fireball.png");
+					projectile->texture = engine.get_texture_manager()->load_texture("item/fireball.png");
 					break;
 				default:
-					projectile = engine.get_texture_manager()->load_texture("item/arrow.png");
+					projectile->texture = engine.get_texture_manager()->load_texture("item/arrow.png");
 					break;
 			}
-			if (grid_x != current_action.xpos)
-				facing_right = (grid_x < current_action.xpos);
+			if (position->grid_x != current_action.xpos)
+				animation->facing_right = (position->grid_x < current_action.xpos);
 
-			proj_angle = facing_right ? 45.0 : -45.0;
+			projectile->angle = animation->facing_right ? 45.0 : -45.0;
+			projectile->flip = animation->facing_right ? SDL_FLIP_HORIZONTAL : SDL_FLIP_NONE;
 		}
 		if (anim_frames < 8)
 		{
-			if (grid_x < current_action.xpos) x += (anim_frames < 4) ? -2 : 2;
-			else if (grid_x > current_action.xpos) x += (anim_frames < 4) ? 2 : -2;
-			if (grid_y < current_action.ypos) y += (anim_frames < 4) ? -2 : 2;
-			else if (grid_y > current_action.ypos) y += (anim_frames < 4) ? 2 : -2;
+			if (position->grid_x < current_action.xpos) position->x += (anim_frames < 4) ? -2 : 2;
+			else if (position->grid_x > current_action.xpos) position->x += (anim_frames < 4) ? 2 : -2;
+			if (position->grid_y < current_action.ypos) position->y += (anim_frames < 4) ? -2 : 2;
+			else if (position->grid_y > current_action.ypos) position->y += (anim_frames < 4) ? 2 : -2;
 
-			proj_x = x;
-			proj_y = y;
+			projectile->x = position->x;
+			projectile->y = position->y;
 		}
 		else
 		{
 			if (anim_frames % 2 == 0)
 			{
 				if (anim_frames < 16)
-					proj_y -= 4;
-				else proj_y += 4;
+					projectile->y -= 4;
+				else projectile->y += 4;
 
 				if (proj_type == PROJECTILE_FIREBALL && anim_frames % 4 == 0)
-					proj_rect.y = (proj_rect.y == 0) ? 16 : 0;
+					projectile->rect.y = (projectile->rect.y == 0) ? 16 : 0;
 			}
-			if (grid_x < current_action.xpos) proj_x += ((current_action.xpos - grid_x) * 16) / 8;
-			else if (grid_x > current_action.xpos) proj_x -= ((grid_x - current_action.xpos) * 16) / 8;
-			if (grid_y < current_action.ypos) proj_y += ((current_action.ypos - grid_y) * 16) / 8;
-			else if (grid_y > current_action.ypos) proj_y -= ((grid_y - current_action.ypos) * 16) / 8;
+			if (position->grid_x < current_action.xpos) projectile->x += ((current_action.xpos - position->grid_x) * 16) / 8;
+			else if (position->grid_x > current_action.xpos) projectile->x -= ((position->grid_x - current_action.xpos) * 16) / 8;
+			if (position->grid_y < current_action.ypos) projectile->y += ((current_action.ypos - position->grid_y) * 16) / 8;
+			else if (position->grid_y > current_action.ypos) projectile->y -= ((position->grid_y - current_action.ypos) * 16) / 8;
 
 			const double increase = (proj_type == PROJECTILE_FIREBALL) ? 8.8 : 6.0;
-			proj_angle += facing_right ? increase : -increase;
+			projectile->angle += animation->facing_right ? increase : -increase;
 		}
 		anim_frames += 1;
 	}
 	if (anim_frames >= 24)
 	{
-		if (projectile != nullptr)
+		if (projectile->texture != nullptr)
 		{
-			engine.get_texture_manager()->free_texture(projectile->get_name());
-			projectile = nullptr;
+			engine.get_texture_manager()->free_texture(projectile->texture->get_name());
+			projectile->texture = nullptr;
 		}
 		Actor *temp_actor = level->get_actor(current_action.xpos, current_action.ypos);
 		if (temp_actor != nullptr)
 			attack(temp_actor);
 
-		turn_done = true;
+		ai->turn_done = true;
 		anim_timer = 0;
 		anim_frames = 0;
 		return true;
@@ -450,27 +434,27 @@ bool Actor::action_shoot(Level *level)
 bool Actor::action_interact(Level *level)
 {
 	anim_timer += engine.get_dt();
-	while (anim_timer > 18 || !in_camera)
+	while (anim_timer > 18 || !position->in_camera)
 	{
 		anim_timer -= 18;
 		if (anim_frames % 2 == 0)
 		{
 			if (anim_frames < 8)
-				y -= 2;
-			else y += 2;
+				position->y -= 2;
+			else position->y += 2;
 
 			if (anim_frames % 4 == 0)
-				facing_right = !facing_right;
+				animation->facing_right = !animation->facing_right;
 		}
 		anim_frames += 1;
 
 		if (anim_frames >= 16)
 		{
-			turn_done = true;
+			ai->turn_done = true;
 			anim_timer = 0;
 			anim_frames = 0;
-			x = grid_x * 32;
-			y = grid_y * 32;
+			position->x = position->grid_x * 32;
+			position->y = position->grid_y * 32;
 			interact(level, Point(current_action.xpos, current_action.ypos));
 			return true;
 		}
@@ -479,21 +463,15 @@ bool Actor::action_interact(Level *level)
 }
 void Actor::add_ability(const std::string &ability)
 {
-	if (!has_ability(ability))
-		abilities.push_back(ability);
+	add_ability(ability_registry.intern(ability));
 }
 void Actor::remove_ability(const std::string &ability)
 {
-	abilities.erase(std::remove(abilities.begin(), abilities.end(), ability), abilities.end());
+	remove_ability(ability_registry.find(ability));
 }
 bool Actor::has_ability(const std::string &ability) const
 {
-	for (auto a : abilities)
-	{
-		if (a == ability)
-			return true;
-	}
-	return false;
+	return has_ability(ability_registry.find(ability));
 }
 void Actor::attack(Actor *other)
 {
@@ -538,11 +516,11 @@ void Actor::attack(Actor *other)
 	}
 	uint8_t damage = get_damage();
 
-	const bool crit = engine.get_rng() % 20 == 0;
+	const bool crit = engine.get_rng(RNG_COMBAT) % 20 == 0;
 	if (crit) damage *= 2;
 
-	const int8_t result_health = other->health.first - damage;
-	other->health.first = result_health;
+	const int8_t result_health = other->vitals->health.first - damage;
+	other->vitals->health.first = result_health;
 
 	if (result_health < 1)
 	{
@@ -553,7 +531,7 @@ void Actor::attack(Actor *other)
 		if (experience >= combat_level * 10)
 		{
 			set_status(STATUS_LEVELUP);
-			add_ability("level-up");
+			add_ability(ABILITY_LEVEL_UP);
 		}
 	}
 	else ml->add_message("The " + name + std::string(crit ? " %ECRITS%F the " : " strikes the ") + other->name + " for %6" + std::to_string(damage) + "%F damage!");
@@ -565,11 +543,11 @@ void Actor::level_up()
 }
 void Actor::add_health(uint8_t amount)
 {
-	if (health.first + amount > health.second)
-		health.first = health.second;
-	else health.first += amount;
+	if (vitals->health.first + amount > vitals->health.second)
+		vitals->health.first = vitals->health.second;
+	else vitals->health.first += amount;
 
-	if (status == STATUS_POISON)
+	if (vitals->status == STATUS_POISON)
 		set_status(STATUS_NONE);
 }
 void Actor::load_bubble(const std::string &bubble_name, uint8_t timer)
@@ -623,7 +601,7 @@ void Actor::set_status(StatusType st)
 			break;
 		default: break;
 	}
-	status = st;
+	vitals->status = st;
 }
 void Actor::set_mount(Mount *m)
 {
@@ -18,6 +18,9 @@
 #ifndef ACTOR_HPP
 #define ACTOR_HPP
 
+#include "actor_components.hpp"
+#include "ability_registry.hpp"
+
 #include <queue>
 #include <vector>
 
@@ -33,6 +36,8 @@ enum ActorType
 	ACTOR_MOUNT,
 	ACTOR_PROP
 };
+const uint8_t ACTOR_TYPE_COUNT = ACTOR_PROP + 1;
+
 enum ActionType
 {
 	ACTION_NULL,
@@ -47,16 +52,6 @@ enum HoverType
 	HOVER_MAP,
 	HOVER_UI
 };
-enum StatusType
-{
-	STATUS_NONE,
-	STATUS_LEVELUP,
-	STATUS_POISON,
-	STATUS_WITHER,
-	STATUS_ARMORED,
-	STATUS_WEAK,
-	STATUS_REGEN
-};
 enum ProjectileType
 {
 	PROJECTILE_ARROW,
@@ -68,7 +63,7 @@ enum ProjectileType
 typedef struct
 {
 	ActionType type;
-	uint8_t xpos, ypos;
+	coord_t xpos, ypos;
 	int8_t action_value;
 }
 Action;
@@ -81,7 +76,7 @@ public:
 
 	void free();
 
-	virtual bool init(ActorType at, uint8_t xpos, uint8_t ypos, const std::string &texture_name = "");
+	virtual bool init(ActorType at, coord_t xpos, coord_t ypos, const std::string &texture_name = "");
 	virtual void update(Level *level);
 	virtual void render() const;
 	virtual void render_ui(uint16_t xpos, uint16_t ypos) const;
@@ -94,15 +89,20 @@ public:
 	virtual void interact(Level *level, Point pos);
 	virtual uint8_t get_damage() const;
 
-	void add_action(ActionType at, uint8_t xpos, uint8_t ypos, int8_t value = 0);
+	void add_action(ActionType at, coord_t xpos, coord_t ypos, int8_t value = 0);
 	bool actions_empty() const;
+	bool queue_empty() const { return action_queue.empty(); }
 
-	void action_idle();
 	bool action_move(Level *level);
 	bool action_attack(Level *level);
 	bool action_shoot(Level *level);
 	bool action_interact(Level *level);
 
+	void add_ability(AbilityID ability) { if (ability < MAX_ABILITIES) abilities.set(ability); }
+	void remove_ability(AbilityID ability) { if (ability < MAX_ABILITIES) abilities.reset(ability); }
+	bool has_ability(AbilityID ability) const { return ability < MAX_ABILITIES && abilities.test(ability); }
+
+	// Name based wrappers, they go through the registry on every call
 	void add_ability(const std::string &ability);
 	void remove_ability(const std::string &ability);
 	bool has_ability(const std::string &ability) const;
@@ -114,88 +114,87 @@ public:
 	void load_bubble(const std::string &bubble_name, uint8_t timer = 0);
 	void clear_bubble();
 
-	StatusType get_status() const { return status; }
+	StatusType get_status() const { return vitals->status; }
 	void set_status(StatusType st);
 
 	void set_mount(Mount *m);
 	void clear_mount();
 
 	bool get_delete() const { return delete_me; }
-	bool get_in_camera() const { return in_camera; }
-	bool get_facing_right() const { return facing_right; }
+	bool get_in_camera() const { return position->in_camera; }
+	bool get_facing_right() const { return animation->facing_right; }
 
 	HoverType get_hovered() const { return hovered; }
 	ActorType get_actor_type() const { return actor_type; }
-	SDL_Rect get_frame_rect() const { return frame_rect; }
-
-	uint16_t get_ID() const { return actor_ID; }
-	uint16_t get_x() const { return x; }
-	uint16_t get_y() const { return y; }
-	uint8_t get_grid_x() const { return grid_x; }
-	uint8_t get_grid_y() const { return grid_y; }
+	SDL_Rect get_frame_rect() const { return animation->frame_rect; }
+
+	uint32_t get_ID() const { return actor_ID; }
+	ActorHandle get_handle() const { return handle; }
+	int32_t get_x() const { return position->x; }
+	int32_t get_y() const { return position->y; }
+	coord_t get_grid_x() const { return position->grid_x; }
+	coord_t get_grid_y() const { return position->grid_y; }
 	Mount* get_mount() const { return mount; }
-	std::pair<int8_t, int8_t> get_moves() const { return moves; }
-	std::pair<int8_t, int8_t> get_health() const { return health; }
+	const std::string& get_name() const { return name; }
+	uint8_t get_max_moves() const { return max_moves; }
+	std::pair<int8_t, int8_t> get_moves() const { return vitals->moves; }
+	std::pair<int8_t, int8_t> get_health() const { return vitals->health; }
 	//uint8_t get_combat_level() const { return combat_level; }
 
-	void set_x(uint16_t xpos) { x = xpos; }
-	void set_y(uint16_t ypos) { y = ypos; }
-	void set_grid_x(uint8_t xpos) { grid_x = xpos; }
-	void set_grid_y(uint8_t ypos) { grid_y = ypos; }
-	void set_delete(bool del) { delete_me = del; }
-	void set_turn_done(bool done) { turn_done = done; }
+	void set_x(int32_t xpos) { position->x = xpos; }
+	void set_y(int32_t ypos) { position->y = ypos; }
+	void set_grid_x(coord_t xpos) { position->grid_x = xpos; }
+	void set_grid_y(coord_t ypos) { position->grid_y = ypos; }
+	void set_delete(bool del);
+	void set_handle(ActorHandle h) { handle = h; }
+	void attach(PositionComponent *pos, AnimationComponent *anim, VitalsComponent *vit, ProjectileComponent *proj, AIComponent *brain)
+		{ position = pos; animation = anim; vitals = vit; projectile = proj; ai = brain; }
+	void set_turn_done(bool done) { ai->turn_done = done; }
 	void set_hovered(HoverType ht) { hovered = ht; }
-	void set_moves(int8_t m) { moves.first = m; }
-	void set_health(int8_t h) { health.first = h; }
-	void set_health_max(int8_t h) { health.second = h; }
+	void set_moves(int8_t m) { vitals->moves.first = m; }
+	void set_health(int8_t h) { vitals->health.first = h; }
+	void set_health_max(int8_t h) { vitals->health.second = h; }
 
 protected:
-	bool delete_me;
-	bool in_camera;
-	bool turn_done;
-	bool facing_right;
-
 	HoverType hovered;
 	ActorType actor_type;
 
-	uint16_t actor_ID;
-	uint16_t x, y;
-	uint8_t grid_x, grid_y;
-	uint8_t prev_x, prev_y;
+	uint32_t actor_ID;
+	ActorHandle handle;
+	PositionComponent *position;
+	AnimationComponent *animation;
+	VitalsComponent *vitals;
+	ProjectileComponent *projectile;
+	AIComponent *ai;
 
 	uint8_t anim_frames;
 	uint8_t anim_timer;
 
 	Action current_action;
 	std::queue<Action> action_queue;
-	std::pair<int8_t, int8_t> moves;
-	std::pair<int8_t, int8_t> health;
 	std::string name;
 
-	SDL_Rect bubble_rect;
 	uint8_t bubble_timer;
 	Texture *bubble;
 	Texture *status_icon;
-	StatusType status;
 
 	uint8_t combat_level;
 	uint8_t experience;
 	uint8_t max_damage;
 	uint8_t max_moves;
-	std::vector<std::string> abilities;
+	AbilitySet abilities;
 
-	SDL_Rect frame_rect;
 	Texture *texture;
 
 	Mount *mount;
 
-	double proj_angle;
-	uint16_t proj_x, proj_y;
-	Texture *projectile;
 	ProjectileType proj_type;
-	SDL_Rect proj_rect;
 
-	static uint16_t ID;
+	static uint32_t ID;
+
+private:
+	// Only set through set_delete() so the manager gets told about it
+	bool delete_me;
 };
 
 #endif // ACTOR_HPP
@@ -0,0 +1,229 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "engine.hpp"
+#include "actor_ai.hpp"
+#include "level.hpp"
+
+#include "actor_manager.hpp"
+#include "monster.hpp"
+#include "mount.hpp"
+#include "dijkstra.hpp"
+#include "stencil.hpp"
+#include "message_log.hpp"
+#include "ui.hpp"
+
+ActorAI::ActorAI() : world(nullptr)
+{
+
+}
+ActorAI::~ActorAI()
+{
+
+}
+void ActorAI::init(ActorWorld *aw)
+{
+	world = aw;
+}
+void ActorAI::start_turn(Actor *actor)
+{
+	AIComponent *brain = world->get_ai(actor->get_handle());
+	VitalsComponent *vital = world->get_vitals(actor->get_handle());
+	if (brain == nullptr || vital == nullptr)
+		return;
+
+	switch (brain->mode)
+	{
+		case AI_PLAYER: actor->start_turn(); break;
+		case AI_MONSTER: start_monster(actor, *brain, *vital); break;
+		case AI_WANDER: start_wander(*brain, *vital); break;
+		default: brain->turn_done = true; break;
+	}
+}
+bool ActorAI::take_turn(Actor *actor, Level *level)
+{
+	AIComponent *brain = world->get_ai(actor->get_handle());
+	VitalsComponent *vital = world->get_vitals(actor->get_handle());
+	if (brain == nullptr || vital == nullptr)
+		return true;
+
+	switch (brain->mode)
+	{
+		case AI_PLAYER: return actor->take_turn(level);
+		case AI_MONSTER: return take_monster(actor, level, *brain, *vital);
+		case AI_WANDER: return take_wander(actor, level, *brain, *vital);
+		default: return true;
+	}
+}
+void ActorAI::start_monster(Actor *actor, AIComponent &brain, VitalsComponent &vital)
+{
+	brain.turn_done = true;
+
+	const uint8_t temp_moves = (actor->get_mount() != nullptr) ? actor->get_max_moves() + 1 : actor->get_max_moves();
+	vital.moves = std::make_pair(temp_moves, temp_moves);
+
+	if (brain.spell_timer > 0)
+		brain.spell_timer -= 1;
+}
+bool ActorAI::take_monster(Actor *actor, Level *level, AIComponent &brain, VitalsComponent &vital)
+{
+	if (brain.turn_done)
+	{
+		if (vital.moves.first > 0)
+			brain.turn_done = false;
+	}
+	else return false;
+
+	const coord_t grid_x = actor->get_grid_x();
+	const coord_t grid_y = actor->get_grid_y();
+
+	if (!brain.turn_done && actor->queue_empty())
+	{
+		if (vital.moves.first > 0 && actor->has_ability(ABILITY_SHOOT))
+		{
+			// Heroes in range and in line of fire come straight out of the hero grid and the wall window
+			const Stencil &ranged = Stencil::get_ranged();
+			const uint32_t targets = level->find_actors(grid_x, grid_y, ACTOR_HERO, ranged) &
+				ranged.get_open_cells(level->get_wall_window(grid_x, grid_y));
+
+			// Same order the ring is listed in, so the first hero found is the same one as before
+			if (targets != 0) for (uint8_t bit : ranged.get_order())
+			{
+				if ((targets >> bit) & 1)
+				{
+					actor->add_action(ACTION_SHOOT, grid_x + get_stencil_x(bit), grid_y + get_stencil_y(bit));
+					vital.moves.first = 0;
+					break;
+				}
+			}
+		}
+		if (vital.moves.first > 0 && actor->has_ability(ABILITY_WEAKNESS) && brain.spell_timer == 0)
+		{
+			// The last hero in the square that isn't weakened yet, walking the window bits from the bottom right
+			Actor *target = nullptr;
+			const uint32_t heroes = level->find_actors(grid_x, grid_y, ACTOR_HERO, Stencil::get_square());
+			for (uint32_t left = heroes; left != 0 && target == nullptr; )
+			{
+				// Jump straight to the highest hero bit, only tiles with a hero on them get looked up
+				const uint8_t bit = 31 - __builtin_clz(left);
+				left &= ~(1u << bit);
+
+				Actor *temp_actor = level->get_actor(grid_x + get_stencil_x(bit), grid_y + get_stencil_y(bit));
+				if (temp_actor != nullptr && temp_actor->get_status() != STATUS_WEAK)
+					target = temp_actor;
+			}
+			if (target != nullptr)
+			{
+				target->set_status(STATUS_WEAK);
+
+				actor->add_action(ACTION_INTERACT, grid_x, grid_y);
+				brain.spell_timer = 5;
+				vital.moves.first = 0;
+
+				if (ui.get_message_log() != nullptr)
+					ui.get_message_log()->add_message("The " + actor->get_name() + " casts %6Weakness%9!", DAWN_OCHER);
+			}
+		}
+		if (vital.moves.first > 0 && actor->has_ability(ABILITY_NECROMANCY) && brain.spell_timer == 0)
+		{
+			Actor *spawn = engine.get_actor_manager()->spawn_actor(level, ACTOR_MONSTER, grid_x, grid_y);
+			if (spawn != nullptr)
+			{
+				if (engine.get_rng(RNG_AI) % 10 != 0)
+					dynamic_cast<Monster*>(spawn)->init_class(MONSTER_SKELETON);
+				else dynamic_cast<Monster*>(spawn)->init_class(MONSTER_SKELETON_DISEASED);
+
+				actor->add_action(ACTION_INTERACT, grid_x, grid_y);
+				brain.spell_timer = 4;
+				vital.moves.first = 0;
+
+				if (ui.get_message_log() != nullptr)
+					ui.get_message_log()->add_message("The " + actor->get_name() + " summons a minion!", DAWN_OCHER);
+			}
+		}
+		if (vital.moves.first > 0 && level->get_dijkstra() != nullptr)
+		{
+			Point step_pos = level->get_dijkstra()->get_node_downhill(level, Point(grid_x, grid_y));
+			if (step_pos.x == grid_x && step_pos.y == grid_y)
+			{
+				if (level->get_wall_type(grid_x, grid_y) == NT_BASE)
+					actor->add_action(ACTION_INTERACT, step_pos.x, step_pos.y);
+				else actor->add_action(ACTION_MOVE, step_pos.x, step_pos.y);
+
+				vital.moves.first = 0;
+				return false;
+			}
+			Actor *temp_actor = level->get_actor(step_pos.x, step_pos.y);
+			if (temp_actor == nullptr)
+			{
+				actor->add_action(ACTION_MOVE, step_pos.x, step_pos.y);
+				vital.moves.first -= 1;
+			}
+			else
+			{
+				if (temp_actor->get_actor_type() == ACTOR_HERO || temp_actor->get_actor_type() == ACTOR_PROP)
+					actor->add_action(ACTION_ATTACK, step_pos.x, step_pos.y);
+
+				else if (temp_actor->get_actor_type() == ACTOR_MOUNT)
+				{
+					if (actor->get_mount() == nullptr)
+					{
+						actor->set_mount(dynamic_cast<Mount*>(temp_actor));
+						actor->add_action(ACTION_MOVE, step_pos.x, step_pos.y);
+					}
+					else brain.turn_done = true;
+				}
+				else brain.turn_done = true;
+				vital.moves.first = 0;
+			}
+		}
+	}
+	return actor->Actor::take_turn(level);
+}
+void ActorAI::start_wander(AIComponent &brain, VitalsComponent &vital)
+{
+	// Ridden mounts move with their rider instead
+	if (brain.rider == ACTOR_HANDLE_NONE)
+	{
+		brain.turn_done = false;
+		vital.moves = std::make_pair(1, 1);
+	}
+	else brain.turn_done = true;
+}
+bool ActorAI::take_wander(Actor *actor, Level *level, AIComponent &brain, VitalsComponent &vital)
+{
+	if (brain.turn_done)
+		return true;
+
+	if (actor->actions_empty() && vital.moves.first > 0)
+	{
+		if (engine.get_rng(RNG_AI) % 10 == 0)
+		{
+			const int8_t offset_x[4] = { 0, 0, -1, 1 };
+			const int8_t offset_y[4] = { -1, 1, 0, 0 };
+			const uint8_t i = engine.get_rng(RNG_AI) % 4;
+
+			if (!level->get_wall(actor->get_grid_x() + offset_x[i], actor->get_grid_y() + offset_y[i], true))
+				actor->add_action(ACTION_MOVE, actor->get_grid_x() + offset_x[i], actor->get_grid_y() + offset_y[i]);
+			else brain.turn_done = true;
+			vital.moves.first = 0;
+		}
+		else brain.turn_done = true;
+	}
+	return brain.turn_done;
+}
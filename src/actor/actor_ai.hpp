@@ -0,0 +1,48 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+
+#ifndef ACTOR_AI_HPP
+#define ACTOR_AI_HPP
+
+#include "actor_world.hpp"
+
+class Level;
+
+// Runs the turns of every actor by its AIComponent mode. Heroes still go through
+// their own start_turn/take_turn since those are driven by the player's input.
+class ActorAI
+{
+public:
+	ActorAI();
+	~ActorAI();
+
+	void init(ActorWorld *aw);
+
+	void start_turn(Actor *actor);
+	bool take_turn(Actor *actor, Level *level);
+
+private:
+	void start_monster(Actor *actor, AIComponent &brain, VitalsComponent &vital);
+	bool take_monster(Actor *actor, Level *level, AIComponent &brain, VitalsComponent &vital);
+	void start_wander(AIComponent &brain, VitalsComponent &vital);
+	bool take_wander(Actor *actor, Level *level, AIComponent &brain, VitalsComponent &vital);
+
+	ActorWorld *world;
+};
+
+#endif // ACTOR_AI_HPP
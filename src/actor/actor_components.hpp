@@ -0,0 +1,108 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ACTOR_COMPONENTS_HPP
+#define ACTOR_COMPONENTS_HPP
+
+#include <utility>
+
+class Texture;
+
+// Slot index in the low 32 bits and the slot's generation in the high 32,
+// so a handle to a deleted actor stops resolving once its slot is reused
+typedef uint64_t ActorHandle;
+const ActorHandle ACTOR_HANDLE_NONE = 0;
+
+inline uint32_t get_handle_slot(ActorHandle handle) { return handle & 0xFFFFFFFF; }
+inline uint32_t get_handle_generation(ActorHandle handle) { return handle >> 32; }
+
+enum IdleMode
+{
+	IDLE_BOB,
+	IDLE_STILL,
+	IDLE_RESTING
+};
+enum StatusType
+{
+	STATUS_NONE,
+	STATUS_LEVELUP,
+	STATUS_POISON,
+	STATUS_WITHER,
+	STATUS_ARMORED,
+	STATUS_WEAK,
+	STATUS_REGEN
+};
+// Who decides an actor's turns, the player through the hero's input or one of the ActorAI systems
+enum AIMode
+{
+	AI_NONE,
+	AI_PLAYER,
+	AI_MONSTER,
+	AI_WANDER
+};
+
+// Per-frame actor state, kept in the ActorWorld arrays instead of inside each Actor
+typedef struct
+{
+	int32_t x, y;
+	coord_t grid_x, grid_y;
+	coord_t prev_x, prev_y;
+	bool in_camera;
+}
+PositionComponent;
+
+typedef struct
+{
+	SDL_Rect frame_rect;
+	SDL_Rect bubble_rect;
+	IdleMode idle_mode;
+	bool acting;
+	bool facing_right;
+}
+AnimationComponent;
+
+// Health and moves as current/max pairs, read by the UI and abilities as often as by the actor
+typedef struct
+{
+	std::pair<int8_t, int8_t> health;
+	std::pair<int8_t, int8_t> moves;
+	StatusType status;
+}
+VitalsComponent;
+
+// A shot in flight, the texture is only loaded while the shoot action runs
+typedef struct
+{
+	Texture *texture;
+	int32_t x, y;
+	double angle;
+	SDL_Rect rect;
+	SDL_RendererFlip flip;
+}
+ProjectileComponent;
+
+// Turn state, so the AI systems can run an actor's turn without a take_turn override per class
+typedef struct
+{
+	AIMode mode;
+	bool turn_done;
+	uint8_t spell_timer;
+	ActorHandle rider;
+}
+AIComponent;
+
+#endif // ACTOR_COMPONENTS_HPP
@@ -26,7 +26,9 @@
 #include "prop.hpp"
 #include "camera.hpp"
 
-#include <algorithm> // for std::find & delete_actor()
+#include <algorithm> // for std::remove_if & delete_actors()
+#include <array>
+#include <unordered_set>
 
 ActorManager::ActorManager() : next_turn(false), current_actor(nullptr), ability_manager(nullptr)
 {
@@ -38,11 +40,9 @@ ActorManager::~ActorManager()
 }
 void ActorManager::free()
 {
-	for (uint8_t i = 0; i < actors.size(); i++)
-	{
-		if (actors[i] != nullptr)
-			delete actors[i];
-	}
+	for (Actor *a : actors)
+		actor_pool.destroy(a);
+	actor_world.free();
 	if (ability_manager != nullptr)
 	{
 		delete ability_manager;
@@ -50,10 +50,14 @@ void ActorManager::free()
 	}
 	actors.clear();
 	heroes.clear();
+	pending_deletes.clear();
+	turn_scheduler.free();
 	current_actor = nullptr;
 }
 void ActorManager::init()
 {
+	actor_ai.init(&actor_world);
+
 	ability_manager = new AbilityManager;
 	ability_manager->load_ability("sleep");
 	ability_manager->load_ability("shoot");
@@ -69,59 +73,41 @@ bool ActorManager::update(Level *level)
 	if (current_actor != nullptr && !next_turn)
 	{
 		Actor *prev_actor = current_actor;
-		while (current_actor->take_turn(level))
+		while (actor_ai.take_turn(current_actor, level))
 		{
 			current_actor->end_turn();
 
 			if (current_actor->get_actor_type() == ACTOR_HERO)
 				ability_manager->clear(dynamic_cast<Hero*>(current_actor));
 
-			const uint16_t current_ID = current_actor->get_ID();
-			Actor *temp_actor = nullptr;
-			Actor *first_actor = nullptr;
-
-			std::vector<Actor*> to_erase;
-			for (Actor *a : actors)
-			{
-				if (a->get_delete())
-					to_erase.push_back(a);
-			}
-			for (Actor *a : to_erase)
-			{
-				delete_actor(level, a);
+			if (delete_pending(level))
 				actors_deleted = true;
-			}
-			for (uint8_t i = 0; i < actors.size(); i++) if (actors[i] != nullptr)
-			{
-				if (actors[i]->get_ID() > current_ID && (temp_actor == nullptr || actors[i]->get_ID() < temp_actor->get_ID()))
-					temp_actor = actors[i];
-				if (first_actor == nullptr || actors[i]->get_ID() < first_actor->get_ID())
-					first_actor = actors[i];
-			}
-			if (temp_actor == nullptr)
-			{
-				current_actor = first_actor;
+
+			// Wrapping back around to the first actor means everyone has had their turn
+			bool round_over = false;
+			current_actor = turn_scheduler.advance(round_over);
+			if (round_over)
 				next_turn = true;
-			}
-			else current_actor = temp_actor;
 
 			if (current_actor != nullptr)
-				current_actor->start_turn();
+				actor_ai.start_turn(current_actor);
 
 			if (heroes.size() == 0 || current_actor == prev_actor)
 				break;
 		}
+		actor_world.update_culling();
 		for (Actor * a : actors)
 			a->update(level);
+		actor_world.follow_riders();
 	}
 	return actors_deleted;
 }
 void ActorManager::render(Level *level) const
 {
 	Actor *temp_actor = nullptr;
-	for (uint8_t y = 0; y < level->get_map_height(); y++)
+	for (coord_t y = 0; y < level->get_map_height(); y++)
 	{
-		for (uint8_t x = 0; x < level->get_map_width(); x++)
+		for (coord_t x = 0; x < level->get_map_width(); x++)
 		{
 			temp_actor = level->get_actor(x, y);
 			if (temp_actor != nullptr)
@@ -131,8 +117,7 @@ void ActorManager::render(Level *level) const
 }
 void ActorManager::animate()
 {
-	for (Actor *a : actors)
-		a->action_idle();
+	actor_world.animate();
 }
 void ActorManager::render_ui() const
 {
@@ -149,9 +134,8 @@ void ActorManager::render_ui() const
 			if (ability_manager != nullptr && (a == current_actor || heroes.size() == 1))
 				ability_manager->render_ui(dynamic_cast<Hero*>(a));
 		}
-		else if (a->get_actor_type() == ACTOR_MONSTER)
-			a->render_ui(0, 0);
 	}
+	actor_world.render_projectiles();
 }
 void ActorManager::clear_actors(Level *level, bool clear_heroes)
 {
@@ -165,30 +149,27 @@ void ActorManager::clear_actors(Level *level, bool clear_heroes)
 		}
 		else to_erase.push_back(a);
 	}
-	for (Actor *a : to_erase)
-		delete_actor(level, a);
+	delete_actors(level, to_erase);
 
 	if (clear_heroes)
 	{
 		actors.clear();
 		heroes.clear();
+		pending_deletes.clear();
+		turn_scheduler.free();
 		current_actor = nullptr;
 	}
 }
 void ActorManager::clear_heroes(Level *level)
 {
-	std::vector<Actor*> to_erase;
-	for (Actor *a : heroes)
-		to_erase.push_back(a);
-
-	for (Actor *a : to_erase)
-		delete_actor(level, a);
+	const std::vector<Actor*> to_erase = heroes;
+	delete_actors(level, to_erase);
 
 	heroes.clear();
 	//current_actor = nullptr;
 }
 //template <class T>
-Actor* ActorManager::spawn_actor(Level *level, ActorType at, uint8_t xpos, uint8_t ypos, const std::string &texture_name, bool place)
+Actor* ActorManager::spawn_actor(Level *level, ActorType at, coord_t xpos, coord_t ypos, const std::string &texture_name, bool place)
 {
 	if (level == nullptr)
 		return nullptr;
@@ -199,24 +180,19 @@ Actor* ActorManager::spawn_actor(Level *level, ActorType at, uint8_t xpos, uint8
 		xpos = spot.x;
 		ypos = spot.y;
 
-		Actor *temp = nullptr;
-		switch (at) // TODO - Maybe just pass the Actor class as a template?
-		{
-			case ACTOR_HERO: temp = new Hero; break;
-			case ACTOR_MONSTER: temp = new Monster; break;
-			case ACTOR_MOUNT: temp = new Mount; break;
-			case ACTOR_PROP: temp = new Prop; break;
-			default: break;
-		}
+		Actor *temp = actor_pool.create(at);
 		if (temp != nullptr)
 		{
+			actor_world.attach(temp);
 			if (temp->init(at, xpos, ypos, texture_name))
 			{
 				actors.push_back(temp);
+				turn_scheduler.insert(temp);
 				if (current_actor == nullptr)
 				{
 					current_actor = temp;
-					current_actor->start_turn();
+					turn_scheduler.set_current(temp);
+					actor_ai.start_turn(current_actor);
 				}
 				if (place)
 					level->set_actor(xpos, ypos, temp);
@@ -226,7 +202,8 @@ Actor* ActorManager::spawn_actor(Level *level, ActorType at, uint8_t xpos, uint8
 			}
 			else
 			{
-				delete temp;
+				actor_world.detach(temp);
+				actor_pool.destroy(temp);
 				temp = nullptr;
 			}
 		}
@@ -234,7 +211,7 @@ Actor* ActorManager::spawn_actor(Level *level, ActorType at, uint8_t xpos, uint8
 	}
 	return nullptr;
 }
-void ActorManager::place_actors(Level *level, std::pair<uint8_t, uint8_t> base_pos)
+void ActorManager::place_actors(Level *level, std::pair<coord_t, coord_t> base_pos)
 {
 	std::vector<Actor*> to_erase;
 	for (Actor *a : actors)
@@ -255,8 +232,7 @@ void ActorManager::place_actors(Level *level, std::pair<uint8_t, uint8_t> base_p
 			level->set_actor(spot.x, spot.y, a);
 		else to_erase.push_back(a);
 	}
-	for (Actor *a : to_erase)
-		delete_actor(level, a);
+	delete_actors(level, to_erase);
 }
 bool ActorManager::input_keyboard_down(SDL_Keycode key, Level *level)
 {
@@ -342,46 +318,90 @@ bool ActorManager::get_click(int16_t mouse_x, int16_t mouse_y) const
 }
 Point ActorManager::find_spot(Level *level, Point pos) const
 {
-	if (level->get_wall(pos.x, pos.y, true))
+	// The first free neighbour for every wall mask, tried column by column from the top left.
+	// Stored as (y + 1) * 3 + (x + 1), the center means there's no room at all.
+	static const std::array<uint8_t, 256> free_spot = []()
 	{
-		for (int8_t x = -1; x < 2; x++)
+		std::array<uint8_t, 256> spots;
+		for (uint16_t blocked = 0; blocked < 256; blocked++)
 		{
-			for (int8_t y = -1; y < 2; y++)
+			spots[blocked] = 4;
+			for (int8_t x = 1; x > -2; x--)
 			{
-				if (!level->get_wall(pos.x + x, pos.y + y, true))
-					return Point(pos.x + x, pos.y + y);
+				for (int8_t y = 1; y > -2; y--)
+				{
+					if ((x != 0 || y != 0) && !get_neighbor_bit(blocked, x, y))
+						spots[blocked] = (y + 1) * 3 + (x + 1);
+				}
 			}
 		}
-		return Point(0, 0);
+		return spots;
+	}();
+
+	if (level->get_wall(pos.x, pos.y, true))
+	{
+		const uint8_t spot = free_spot[level->get_wall_mask(pos.x, pos.y, true)];
+		if (spot == 4)
+			return Point(0, 0);
+		return Point(pos.x + spot % 3 - 1, pos.y + spot / 3 - 1);
 	}
 	return pos;
 }
-void ActorManager::delete_actor(Level *level, Actor *actor)
+void ActorManager::delete_actors(Level *level, const std::vector<Actor*> &to_erase)
 {
-	if (level == nullptr || actor == nullptr)
+	if (level == nullptr || to_erase.empty())
 		return;
 
-	if (actor->get_actor_type() == ACTOR_MONSTER)
-	{
-		MonsterClass mc = dynamic_cast<Monster*>(actor)->get_monster_class();
-		if (mc == MONSTER_PEST_SCORPION || mc == MONSTER_KOBOLD_TRUEFORM ||
-			mc == MONSTER_DWARF_KING || mc == MONSTER_PLATINO)
-			level->set_victory(true);
-	}
-	Mount *temp_mount = actor->get_mount();
-	if (temp_mount != nullptr)
+	bool hero_deleted = false;
+	for (Actor *actor : to_erase)
 	{
-		actor->clear_mount();
-		level->set_actor(actor->get_grid_x(), actor->get_grid_y(), temp_mount);
+		if (actor->get_actor_type() == ACTOR_MONSTER)
+		{
+			MonsterClass mc = dynamic_cast<Monster*>(actor)->get_monster_class();
+			if (mc == MONSTER_PEST_SCORPION || mc == MONSTER_KOBOLD_TRUEFORM ||
+				mc == MONSTER_DWARF_KING || mc == MONSTER_PLATINO)
+				level->set_victory(true);
+		}
+		Mount *temp_mount = actor->get_mount();
+		if (temp_mount != nullptr)
+		{
+			actor->clear_mount();
+			level->set_actor(actor->get_grid_x(), actor->get_grid_y(), temp_mount);
+		}
+		else level->set_actor(actor->get_grid_x(), actor->get_grid_y(), nullptr);
+
+		turn_scheduler.remove(actor);
+		hero_deleted = hero_deleted || actor->get_actor_type() == ACTOR_HERO;
 	}
-	else level->set_actor(actor->get_grid_x(), actor->get_grid_y(), nullptr);
+	// One pass over each list for the whole batch, a wave of corpses used to cost two passes each
+	const std::unordered_set<Actor*> erased(to_erase.begin(), to_erase.end());
+	auto is_erased = [&erased](Actor *a) { return erased.count(a) != 0; };
 
-	actors.erase(std::remove(actors.begin(), actors.end(), actor), actors.end());
-	heroes.erase(std::remove(heroes.begin(), heroes.end(), actor), heroes.end());
+	actors.erase(std::remove_if(actors.begin(), actors.end(), is_erased), actors.end());
+	heroes.erase(std::remove_if(heroes.begin(), heroes.end(), is_erased), heroes.end());
+	pending_deletes.erase(std::remove_if(pending_deletes.begin(), pending_deletes.end(), is_erased), pending_deletes.end());
 
-	if (actor->get_actor_type() == ACTOR_HERO && heroes.size() == 0)
+	if (hero_deleted && heroes.size() == 0)
 		level->set_damage_base(20);
 
-	actor->death(level);
-	delete actor;
+	for (Actor *actor : to_erase)
+	{
+		actor->death(level);
+		actor_world.detach(actor);
+		actor_pool.destroy(actor);
+	}
+}
+bool ActorManager::delete_pending(Level *level)
+{
+	if (level == nullptr || pending_deletes.empty())
+		return false;
+
+	// Dying can spawn something new, which could in turn be queued for deletion
+	while (!pending_deletes.empty())
+	{
+		std::vector<Actor*> to_erase;
+		to_erase.swap(pending_deletes);
+		delete_actors(level, to_erase);
+	}
+	return true;
 }
@@ -19,6 +19,10 @@
 #define ACTOR_MANAGER
 
 #include "actor.hpp"
+#include "actor_ai.hpp"
+#include "actor_pool.hpp"
+#include "actor_world.hpp"
+#include "turn_scheduler.hpp"
 
 #include <vector>
 
@@ -43,14 +47,16 @@ public:
 	void clear_heroes(Level *level);
 
 	//template <class T>
-	Actor* spawn_actor(Level *level, ActorType at, uint8_t xpos, uint8_t ypos, const std::string &texture_name = "", bool place = true);
-	void place_actors(Level *level, std::pair<uint8_t, uint8_t> base_pos);
+	Actor* spawn_actor(Level *level, ActorType at, coord_t xpos, coord_t ypos, const std::string &texture_name = "", bool place = true);
+	void place_actors(Level *level, std::pair<coord_t, coord_t> base_pos);
 
 	bool input_keyboard_down(SDL_Keycode key, Level *level);
 	bool input_mouse_button_down(uint16_t mouse_x, uint16_t mouse_y, Level *level);
 	bool input_joy_button_down(uint8_t index, uint8_t value, Level *level);
 	bool input_joy_hat_motion(uint8_t index, uint8_t value, Level *level);
 
+	Actor* get_actor(ActorHandle handle) const { return actor_pool.get(handle); }
+	void queue_delete(Actor *actor) { pending_deletes.push_back(actor); }
 	bool get_next_turn();
 
 	bool get_overlap(int16_t mouse_x, int16_t mouse_y) const;
@@ -58,12 +64,18 @@ public:
 
 private:
 	Point find_spot(Level *level, Point pos) const;
-	void delete_actor(Level *level, Actor *actor);
+	void delete_actors(Level *level, const std::vector<Actor*> &to_erase);
+	bool delete_pending(Level *level);
 
 	bool next_turn;
 	Actor *current_actor;
 	std::vector<Actor*> actors;
 	std::vector<Actor*> heroes;
+	std::vector<Actor*> pending_deletes;
+	ActorPool actor_pool;
+	ActorWorld actor_world;
+	ActorAI actor_ai;
+	TurnScheduler turn_scheduler;
 	AbilityManager *ability_manager;
 };
 
@@ -0,0 +1,127 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+#include "engine.hpp"
+#include "actor_pool.hpp"
+
+#include "hero.hpp"
+#include "monster.hpp"
+#include "mount.hpp"
+#include "prop.hpp"
+
+#include <algorithm> // for std::max & the free slot heap
+#include <functional>
+#include <cstddef>
+#include <new>
+
+// Big enough and aligned for the largest actor class
+const std::size_t ACTOR_SLOT_ALIGN = std::max({ alignof(Hero), alignof(Monster), alignof(Mount), alignof(Prop) });
+const std::size_t ACTOR_SLOT_SIZE =
+	(std::max({ sizeof(Hero), sizeof(Monster), sizeof(Mount), sizeof(Prop) }) + ACTOR_SLOT_ALIGN - 1) / ACTOR_SLOT_ALIGN * ACTOR_SLOT_ALIGN;
+
+static_assert(ACTOR_SLOT_ALIGN <= alignof(std::max_align_t), "operator new won't align the actor slabs");
+
+ActorPool::ActorPool() : live_count(0)
+{
+
+}
+ActorPool::~ActorPool()
+{
+	free();
+}
+void ActorPool::free()
+{
+	for (Actor *actor : slots)
+	{
+		if (actor != nullptr)
+			actor->~Actor();
+	}
+	for (uint8_t *slab : slabs)
+		::operator delete(slab);
+
+	slabs.clear();
+	slots.clear();
+	generations.clear();
+	free_slots.clear();
+	live_count = 0;
+}
+Actor* ActorPool::create(ActorType at)
+{
+	if (free_slots.empty())
+	{
+		if (slots.size() >= ACTOR_POOL_SLOTS)
+			return nullptr;
+		add_slab();
+	}
+	const uint32_t index = free_slots.front();
+	void *slot = slabs[index / ACTOR_SLAB_SLOTS] + (index % ACTOR_SLAB_SLOTS) * ACTOR_SLOT_SIZE;
+
+	Actor *actor = nullptr;
+	switch (at)
+	{
+		case ACTOR_HERO: actor = new (slot) Hero; break;
+		case ACTOR_MONSTER: actor = new (slot) Monster; break;
+		case ACTOR_MOUNT: actor = new (slot) Mount; break;
+		case ACTOR_PROP: actor = new (slot) Prop; break;
+		default: return nullptr;
+	}
+	std::pop_heap(free_slots.begin(), free_slots.end(), std::greater<uint32_t>());
+	free_slots.pop_back();
+	actor->set_handle(((ActorHandle)generations[index] << 32) | index);
+
+	slots[index] = actor;
+	live_count += 1;
+	return actor;
+}
+void ActorPool::destroy(Actor *actor)
+{
+	if (actor == nullptr)
+		return;
+
+	const uint32_t index = get_handle_slot(actor->get_handle());
+	if (index >= slots.size() || slots[index] != actor)
+		return;
+
+	actor->~Actor();
+	slots[index] = nullptr;
+	live_count -= 1;
+
+	// Generation 0 is never handed out, so ACTOR_HANDLE_NONE can't resolve to anything
+	generations[index] += 1;
+	if (generations[index] == 0)
+		generations[index] = 1;
+	free_slots.push_back(index);
+	std::push_heap(free_slots.begin(), free_slots.end(), std::greater<uint32_t>());
+}
+Actor* ActorPool::get(ActorHandle handle) const
+{
+	const uint32_t index = get_handle_slot(handle);
+	if (index >= slots.size() || generations[index] != get_handle_generation(handle))
+		return nullptr;
+	return slots[index];
+}
+void ActorPool::add_slab()
+{
+	const uint32_t first = slots.size();
+	slabs.push_back(static_cast<uint8_t*>(::operator new(ACTOR_SLAB_SLOTS * ACTOR_SLOT_SIZE)));
+	slots.resize(first + ACTOR_SLAB_SLOTS, nullptr);
+	generations.resize(first + ACTOR_SLAB_SLOTS, 1);
+
+	// Every new slot is above the existing ones, so they can go straight to the back of the heap
+	for (uint32_t i = first; i < first + ACTOR_SLAB_SLOTS; i++)
+		free_slots.push_back(i);
+}
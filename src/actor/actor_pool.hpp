@@ -0,0 +1,58 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ACTOR_POOL_HPP
+#define ACTOR_POOL_HPP
+
+#include "actor.hpp"
+
+#include <vector>
+
+const uint16_t ACTOR_SLAB_SLOTS = 256;
+// Handles have room for 2^32 slots, this only stops a runaway spawner from eating all memory.
+// A million actors is twenty times the largest level we plan for.
+const uint32_t ACTOR_POOL_SLOTS = 1048576;
+
+// Every actor class lives in the same fixed size slots, carved out of slabs that are
+// never moved or released until the pool is freed. Deleted actors only return their
+// slot to the free list, so spawning a wave doesn't go through the allocator at all.
+class ActorPool
+{
+public:
+	ActorPool();
+	~ActorPool();
+
+	void free();
+
+	Actor* create(ActorType at);
+	void destroy(Actor *actor);
+
+	Actor* get(ActorHandle handle) const;
+	uint32_t get_live_count() const { return live_count; }
+
+private:
+	void add_slab();
+
+	uint32_t live_count;
+
+	std::vector<uint8_t*> slabs;
+	std::vector<Actor*> slots;
+	std::vector<uint32_t> generations;
+	std::vector<uint32_t> free_slots; // Min-heap, the lowest free slot is always reused first
+};
+
+#endif // ACTOR_POOL_HPP
@@ -0,0 +1,199 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+#include "engine.hpp"
+#include "actor_world.hpp"
+#include "actor_pool.hpp"
+
+#include "camera.hpp"
+#include "texture.hpp"
+
+ActorWorld::ActorWorld() : slot_count(0)
+{
+
+}
+ActorWorld::~ActorWorld()
+{
+	free();
+}
+void ActorWorld::free()
+{
+	for (PositionComponent *slab : positions)
+		delete[] slab;
+	for (AnimationComponent *slab : animations)
+		delete[] slab;
+	for (VitalsComponent *slab : vitals)
+		delete[] slab;
+	for (ProjectileComponent *slab : projectiles)
+		delete[] slab;
+	for (AIComponent *slab : ais)
+		delete[] slab;
+
+	positions.clear();
+	animations.clear();
+	vitals.clear();
+	projectiles.clear();
+	ais.clear();
+	owners.clear();
+	slot_count = 0;
+}
+void ActorWorld::attach(Actor *actor)
+{
+	if (actor == nullptr || actor->get_handle() == ACTOR_HANDLE_NONE)
+		return;
+
+	const uint32_t index = get_handle_slot(actor->get_handle());
+	while (index >= slot_count)
+		add_slab();
+
+	PositionComponent &position = positions[index / ACTOR_SLAB_SLOTS][index % ACTOR_SLAB_SLOTS];
+	AnimationComponent &animation = animations[index / ACTOR_SLAB_SLOTS][index % ACTOR_SLAB_SLOTS];
+	VitalsComponent &vital = vitals[index / ACTOR_SLAB_SLOTS][index % ACTOR_SLAB_SLOTS];
+	ProjectileComponent &projectile = projectiles[index / ACTOR_SLAB_SLOTS][index % ACTOR_SLAB_SLOTS];
+	AIComponent &brain = ais[index / ACTOR_SLAB_SLOTS][index % ACTOR_SLAB_SLOTS];
+
+	position = { 0, 0, 0, 0, 0, 0, false };
+	animation = { { 0, 0, 16, 16 }, { 0, 0, 16, 16 }, IDLE_BOB, false, false };
+	vital = { std::make_pair(1, 1), std::make_pair(0, 0), STATUS_NONE };
+	projectile = { nullptr, 0, 0, 0.0, { 0, 0, 16, 16 }, SDL_FLIP_NONE };
+	brain = { AI_NONE, false, 0, ACTOR_HANDLE_NONE };
+	owners[index] = actor->get_handle();
+
+	actor->attach(&position, &animation, &vital, &projectile, &brain);
+}
+void ActorWorld::detach(Actor *actor)
+{
+	if (actor != nullptr && get_live(actor->get_handle()))
+		owners[get_handle_slot(actor->get_handle())] = ACTOR_HANDLE_NONE;
+}
+PositionComponent* ActorWorld::get_position(ActorHandle handle)
+{
+	if (!get_live(handle))
+		return nullptr;
+	return &positions[get_handle_slot(handle) / ACTOR_SLAB_SLOTS][get_handle_slot(handle) % ACTOR_SLAB_SLOTS];
+}
+AnimationComponent* ActorWorld::get_animation(ActorHandle handle)
+{
+	if (!get_live(handle))
+		return nullptr;
+	return &animations[get_handle_slot(handle) / ACTOR_SLAB_SLOTS][get_handle_slot(handle) % ACTOR_SLAB_SLOTS];
+}
+VitalsComponent* ActorWorld::get_vitals(ActorHandle handle)
+{
+	if (!get_live(handle))
+		return nullptr;
+	return &vitals[get_handle_slot(handle) / ACTOR_SLAB_SLOTS][get_handle_slot(handle) % ACTOR_SLAB_SLOTS];
+}
+AIComponent* ActorWorld::get_ai(ActorHandle handle)
+{
+	if (!get_live(handle))
+		return nullptr;
+	return &ais[get_handle_slot(handle) / ACTOR_SLAB_SLOTS][get_handle_slot(handle) % ACTOR_SLAB_SLOTS];
+}
+void ActorWorld::update_culling()
+{
+	for (uint32_t slab = 0; slab < positions.size(); slab++)
+	{
+		PositionComponent *position = positions[slab];
+		const ActorHandle *owner = &owners[slab * ACTOR_SLAB_SLOTS];
+
+		for (uint16_t i = 0; i < ACTOR_SLAB_SLOTS; i++) if (owner[i] != ACTOR_HANDLE_NONE)
+			position[i].in_camera = camera.get_in_camera_grid(position[i].grid_x, position[i].grid_y);
+	}
+}
+void ActorWorld::animate()
+{
+	for (uint32_t slab = 0; slab < animations.size(); slab++)
+	{
+		AnimationComponent *animation = animations[slab];
+		const ActorHandle *owner = &owners[slab * ACTOR_SLAB_SLOTS];
+
+		for (uint16_t i = 0; i < ACTOR_SLAB_SLOTS; i++) if (owner[i] != ACTOR_HANDLE_NONE)
+		{
+			AnimationComponent &anim = animation[i];
+			anim.bubble_rect.y = (anim.bubble_rect.y == 0) ? 16 : 0;
+
+			// Tired heroes lie down and props never move, everyone else bobs up and down while idle
+			if (anim.idle_mode == IDLE_RESTING)
+				anim.frame_rect.y = 16;
+			else if (anim.idle_mode == IDLE_STILL)
+				anim.frame_rect.y = 0;
+			else if (!anim.acting)
+			{
+				anim.frame_rect.y = (anim.frame_rect.y == 0) ? 16 : 0;
+				anim.bubble_rect = anim.frame_rect;
+			}
+		}
+	}
+}
+void ActorWorld::follow_riders()
+{
+	for (uint32_t slab = 0; slab < ais.size(); slab++)
+	{
+		const AIComponent *brain = ais[slab];
+		const ActorHandle *owner = &owners[slab * ACTOR_SLAB_SLOTS];
+
+		for (uint16_t i = 0; i < ACTOR_SLAB_SLOTS; i++) if (owner[i] != ACTOR_HANDLE_NONE && get_live(brain[i].rider))
+		{
+			// Mounts are drawn under their rider, so they take its position and bob along with it
+			const uint32_t rider = get_handle_slot(brain[i].rider);
+			const PositionComponent &rider_pos = positions[rider / ACTOR_SLAB_SLOTS][rider % ACTOR_SLAB_SLOTS];
+			const AnimationComponent &rider_anim = animations[rider / ACTOR_SLAB_SLOTS][rider % ACTOR_SLAB_SLOTS];
+			PositionComponent &position = positions[slab][i];
+			AnimationComponent &animation = animations[slab][i];
+
+			if (position.x != rider_pos.x || position.y != rider_pos.y)
+			{
+				animation.facing_right = rider_anim.facing_right;
+				position.x = rider_pos.x; position.y = rider_pos.y;
+			}
+			animation.frame_rect.y = rider_anim.frame_rect.y;
+			position.in_camera = rider_pos.in_camera;
+		}
+	}
+}
+void ActorWorld::render_projectiles() const
+{
+	for (uint32_t slab = 0; slab < projectiles.size(); slab++)
+	{
+		const ProjectileComponent *projectile = projectiles[slab];
+		const ActorHandle *owner = &owners[slab * ACTOR_SLAB_SLOTS];
+
+		for (uint16_t i = 0; i < ACTOR_SLAB_SLOTS; i++) if (owner[i] != ACTOR_HANDLE_NONE && projectile[i].texture != nullptr)
+		{
+			projectile[i].texture->render(
+				projectile[i].x - camera.get_cam_x(), projectile[i].y - camera.get_cam_y(), &projectile[i].rect,
+				2, projectile[i].flip, projectile[i].angle
+			);
+		}
+	}
+}
+void ActorWorld::add_slab()
+{
+	positions.push_back(new PositionComponent[ACTOR_SLAB_SLOTS]);
+	animations.push_back(new AnimationComponent[ACTOR_SLAB_SLOTS]);
+	vitals.push_back(new VitalsComponent[ACTOR_SLAB_SLOTS]);
+	projectiles.push_back(new ProjectileComponent[ACTOR_SLAB_SLOTS]);
+	ais.push_back(new AIComponent[ACTOR_SLAB_SLOTS]);
+	owners.resize(owners.size() + ACTOR_SLAB_SLOTS, ACTOR_HANDLE_NONE);
+	slot_count += ACTOR_SLAB_SLOTS;
+}
+bool ActorWorld::get_live(ActorHandle handle) const
+{
+	const uint32_t index = get_handle_slot(handle);
+	return handle != ACTOR_HANDLE_NONE && index < slot_count && owners[index] == handle;
+}
@@ -0,0 +1,64 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef ACTOR_WORLD_HPP
+#define ACTOR_WORLD_HPP
+
+#include "actor.hpp"
+#include "actor_components.hpp"
+
+#include <vector>
+
+// Component arrays indexed by the actor's pool slot, allocated a slab at a time so an
+// actor can keep pointers into them. The pool hands out the lowest free slots first,
+// which keeps the live entries packed at the front for the systems to walk through.
+class ActorWorld
+{
+public:
+	ActorWorld();
+	~ActorWorld();
+
+	void free();
+
+	void attach(Actor *actor);
+	void detach(Actor *actor);
+
+	PositionComponent* get_position(ActorHandle handle);
+	AnimationComponent* get_animation(ActorHandle handle);
+	VitalsComponent* get_vitals(ActorHandle handle);
+	AIComponent* get_ai(ActorHandle handle);
+
+	void update_culling();
+	void animate();
+	void follow_riders();
+	void render_projectiles() const;
+
+private:
+	void add_slab();
+	bool get_live(ActorHandle handle) const;
+
+	uint32_t slot_count;
+
+	std::vector<ActorHandle> owners;
+	std::vector<PositionComponent*> positions;
+	std::vector<AnimationComponent*> animations;
+	std::vector<VitalsComponent*> vitals;
+	std::vector<ProjectileComponent*> projectiles;
+	std::vector<AIComponent*> ais;
+};
+
+#endif // ACTOR_WORLD_HPP
@@ -34,8 +34,7 @@ Hero::Hero() :
 	hp_shake(0), hb_timer(100), pathfinder(nullptr), ui_texture(nullptr), health_texture(nullptr),
 	sleep_timer(0), ability_activated(false)
 {
-	health = std::make_pair(3, 3);
-	prev_health = health.first;
+	prev_health = 3;
 	max_moves = 2;
 	name = "Peon";
 }
@@ -60,31 +59,34 @@ void Hero::free()
 		engine.get_texture_manager()->free_texture(health_texture->get_name());
 		health_texture = nullptr;
 	}
-	abilities.clear();
+	abilities.reset();
 }
-bool Hero::init(ActorType at, uint8_t xpos, uint8_t ypos, const std::string &texture_name)
+bool Hero::init(ActorType at, coord_t xpos, coord_t ypos, const std::string &texture_name)
 {
 	if (!Actor::init(at, xpos, ypos, texture_name))
 		return false;
 
+	vitals->health = std::make_pair(3, 3);
+
 	return (init_ui_texture() && init_pathfinder());
 }
 void Hero::update(Level *level)
 {
 	Actor::update(level);
+	animation->idle_mode = (vitals->moves.first <= 0) ? IDLE_RESTING : IDLE_BOB;
 
 	if (hp_shake > 0)
 		hp_shake -= 1;
 
-	if (prev_health != health.first)
+	if (prev_health != vitals->health.first)
 	{
-		prev_health = health.first;
+		prev_health = vitals->health.first;
 		hp_shake = 10;
 	}
-	if (health.first < health.second)
+	if (vitals->health.first < vitals->health.second)
 	{
 		hb_timer += engine.get_dt();
-		if (hb_timer > health.first * 250)
+		if (hb_timer > vitals->health.first * 250)
 			hb_timer = 0;
 	}
 	else hb_timer = 100;
@@ -94,7 +96,7 @@ void Hero::render_ui(uint16_t xpos, uint16_t ypos) const
 	Actor::render_ui(xpos, ypos);
 
 	if (pathfinder != nullptr && (hovered != HOVER_NONE))
-		pathfinder->render(moves.first);
+		pathfinder->render(vitals->moves.first);
 
 	if (ui_texture != nullptr)
 	{
@@ -103,18 +105,18 @@ void Hero::render_ui(uint16_t xpos, uint16_t ypos) const
 
 		SDL_RenderCopyEx(engine.get_renderer(), ui_texture, &rect, &quad, 0.0, nullptr, SDL_FLIP_NONE);
 	}
-	if (health_texture != nullptr && health.second > 0)
+	if (health_texture != nullptr && vitals->health.second > 0)
 	{
 		SDL_Rect rect = { (hb_timer < 100) ? 64 : 0, 0, 16, 16 };
 
-		int8_t hearts = health.second / 3;
-		int8_t hp_left = health.first;
+		int8_t hearts = vitals->health.second / 3;
+		int8_t hp_left = vitals->health.first;
 		uint16_t render_x = xpos + 50;
 		uint16_t render_y = ypos + 8;
 
-		if (status == STATUS_POISON)
+		if (vitals->status == STATUS_POISON)
 			rect.y = 16;
-		else if (status == STATUS_WITHER)
+		else if (vitals->status == STATUS_WITHER)
 			rect.y = 48;
 
 		while (hearts > 0)
@@ -124,7 +126,7 @@ void Hero::render_ui(uint16_t xpos, uint16_t ypos) const
 			else if (hp_left < 1) rect.x = 48;
 
 			if (hp_shake > 0)
-				health_texture->render(render_x, render_y + (engine.get_rng() % hp_shake), &rect);
+				health_texture->render(render_x, render_y + (engine.get_rng(RNG_COSMETIC) % hp_shake), &rect);
 			else health_texture->render(render_x, render_y, &rect);
 
 			hearts -= 1;
@@ -132,14 +134,14 @@ void Hero::render_ui(uint16_t xpos, uint16_t ypos) const
 			render_x += 32;
 		}
 	}
-	if (moves.first > 0)
+	if (vitals->moves.first > 0)
 	{
-		if (moves.second < 3)
+		if (vitals->moves.second < 3)
 			ui.get_bitmap_font()->render_text(camera.get_cam_w() - 96, 16,
-				"Moves: " + std::to_string(moves.first) + "/" + std::to_string(moves.second)
+				"Moves: " + std::to_string(vitals->moves.first) + "/" + std::to_string(vitals->moves.second)
 			);
 		else ui.get_bitmap_font()->render_text(camera.get_cam_w() - 96, 16,
-				"Moves: " + std::to_string(moves.first) + "/%D" + std::to_string(moves.second)
+				"Moves: " + std::to_string(vitals->moves.first) + "/%D" + std::to_string(vitals->moves.second)
 			);
 		const std::string xp = "%FXP: " + std::to_string(experience) + "/" + std::to_string(combat_level * 10);
 		ui.get_bitmap_font()->render_text(camera.get_cam_w() - (xp.length() * 8), 27, xp);
@@ -149,16 +151,16 @@ void Hero::start_turn()
 {
 	if (sleep_timer == 0)
 	{
-		turn_done = false;
+		ai->turn_done = false;
 		reset_moves();
 
 		if (!get_auto_move())
-			camera.update_position(grid_x * 32, grid_y * 32);
+			camera.update_position(position->grid_x * 32, position->grid_y * 32);
 
-		if (mount != nullptr && engine.get_rng() % 25 == 0)
+		if (mount != nullptr && engine.get_rng(RNG_AI) % 25 == 0)
 			random_move = true;
 	}
-	if (grid_x > 20 && ui.get_message_log() != nullptr)
+	if (position->grid_x > 20 && ui.get_message_log() != nullptr)
 	{
 		load_bubble("exclamation", 1);
 		ui.get_message_log()->add_message("The " + name + " is too close to the mountains!", DAWN_BERRY);
@@ -173,42 +175,47 @@ bool Hero::take_turn(Level *level)
 		return true;
 	}
 	hovered = HOVER_MAP;
-	if (turn_done)
+
+	// Clicked paths are searched off the main thread, pick the result up once it's in
+	if (pathfinder != nullptr)
+		pathfinder->poll_path(level);
+
+	if (ai->turn_done)
 	{
 		if (pathfinder != nullptr && pathfinder->get_path_found())
 		{
-			if (grid_x == pathfinder->get_goto_x() && grid_y == pathfinder->get_goto_y())
+			if (position->grid_x == pathfinder->get_goto_x() && position->grid_y == pathfinder->get_goto_y())
 				pathfinder->step();
 			else pathfinder->clear_path();
 		}
 		command_this_turn = false;
-		if (moves.first > 0)
+		if (vitals->moves.first > 0)
 		{
-			if (grid_x > 20 && ui.get_message_log() != nullptr)
+			if (position->grid_x > 20 && ui.get_message_log() != nullptr)
 			{
 				load_bubble("exclamation", 1);
 				ui.get_message_log()->add_message("The " + name + " is too close to the mountains!", DAWN_BERRY);
 				ui.get_message_log()->add_message("Move left or you will take damage at the end of turn!", DAWN_BERRY);
 			}
-			turn_done = false;
+			ai->turn_done = false;
 		}
 	}
-	if (actions_empty() && moves.first > 0)
+	if (actions_empty() && vitals->moves.first > 0)
 	{
 		if (random_move)
 		{
 			const int8_t offset_x[8] = { 0, 0, -1, 1, -1, 1, -1, 1 };
 			const int8_t offset_y[8] = { -1, 1, 0, 0, -1, -1, 1, 1 };
-			const uint8_t i = engine.get_rng() % 8;
+			const uint8_t i = engine.get_rng(RNG_AI) % 8;
 
-			if (!level->get_wall(grid_x + offset_x[i], grid_y + offset_y[i], true))
-				add_action(ACTION_MOVE, grid_x + offset_x[i], grid_y + offset_y[i]);
-			else turn_done = true;
+			if (!level->get_wall(position->grid_x + offset_x[i], position->grid_y + offset_y[i], true))
+				add_action(ACTION_MOVE, position->grid_x + offset_x[i], position->grid_y + offset_y[i]);
+			else ai->turn_done = true;
 
 			if (ui.get_message_log() != nullptr)
 				ui.get_message_log()->add_message("The " + name + "'s mount moves wildly!");
 
-			moves.first = 0;
+			vitals->moves.first = 0;
 			random_move = false;
 			pathfinder->clear_path();
 		}
@@ -226,13 +233,13 @@ void Hero::end_turn()
 	Actor::end_turn();
 	hovered = HOVER_NONE;
 
-	if (grid_x > 20 && ui.get_message_log() != nullptr && health.first > 0)
+	if (position->grid_x > 20 && ui.get_message_log() != nullptr && vitals->health.first > 0)
 	{
 		ui.get_message_log()->add_message("The cool mountain air is too pure for " + name + "! (%61%F damage)");
-		health.first -= 1;
+		vitals->health.first -= 1;
 
-		if (health.first == 0)
-			delete_me = true;
+		if (vitals->health.first == 0)
+			set_delete(true);
 	}
 }
 void Hero::interact(Level *level, Point pos)
@@ -249,9 +256,9 @@ uint8_t Hero::get_damage() const
 	if (hero_class == HC_JUGGERNAUT)
 		dmg += current_action.action_value / 2;
 	else if (hero_class == HC_BARBARIAN)
-		dmg += (health.second - health.first) / 2;
+		dmg += (vitals->health.second - vitals->health.first) / 2;
 
-	if (status == STATUS_WEAK)
+	if (vitals->status == STATUS_WEAK)
 		dmg -= 1;
 
 	if (dmg < 0)
@@ -261,10 +268,10 @@ uint8_t Hero::get_damage() const
 }
 void Hero::clear_status()
 {
-	health.first = health.second;
-	if (status != STATUS_NONE)
+	vitals->health.first = vitals->health.second;
+	if (vitals->status != STATUS_NONE)
 		set_status(STATUS_NONE);
-	moves = std::make_pair(0, 0);
+	vitals->moves = std::make_pair(0, 0);
 }
 bool Hero::init_ui_texture()
 {
@@ -309,9 +316,9 @@ bool Hero::init_ui_texture()
 			ui.get_background()->render(i * 48, 16, &corners[2]);
 			ui.get_background()->render(i * 48 + 16, 32, &corners[3]);
 
-			frame_rect = { 0, 0, 16, 16 };
+			animation->frame_rect = { 0, 0, 16, 16 };
 			if (texture != nullptr)
-				texture->render(i * 48 + 8, 8, &frame_rect, 2, SDL_FLIP_HORIZONTAL);
+				texture->render(i * 48 + 8, 8, &animation->frame_rect, 2, SDL_FLIP_HORIZONTAL);
 		}
 		SDL_SetRenderTarget(engine.get_renderer(), NULL);
 		return true;
@@ -338,14 +345,14 @@ bool Hero::init_class(HeroClass hc)
 			name = "Ninja";
 			class_texture = "actor/orc_ninja.png";
 			proj_type = PROJECTILE_SHURIKEN;
-			add_ability("shoot");
+			add_ability(ABILITY_SHOOT);
 			break;
 		case HC_MAGE:
 			name = "Mage";
 			class_texture = "actor/orc_mage.png";
-			add_ability("dispel");
-			add_ability("sprout");
-			add_ability("poison");
+			add_ability(ABILITY_DISPEL);
+			add_ability(ABILITY_SPROUT);
+			add_ability(ABILITY_POISON);
 			break;
 		case HC_JUGGERNAUT:
 			name = "Juggernaut";
@@ -367,7 +374,7 @@ bool Hero::init_class(HeroClass hc)
 void Hero::reset_moves()
 {
 	const uint8_t temp_moves = (mount != nullptr) ? max_moves + 1 : max_moves;
-	moves = std::make_pair(temp_moves, temp_moves);
+	vitals->moves = std::make_pair(temp_moves, temp_moves);
 }
 void Hero::step_pathfinder(Level *level)
 {
@@ -376,8 +383,8 @@ void Hero::step_pathfinder(Level *level)
 	{
 		if (temp_actor->get_actor_type() == ACTOR_MONSTER || temp_actor->get_actor_type() == ACTOR_PROP)
 		{
-			add_action(ACTION_ATTACK, pathfinder->get_goto_x(), pathfinder->get_goto_y(), moves.first);
-			moves.first = 0;
+			add_action(ACTION_ATTACK, pathfinder->get_goto_x(), pathfinder->get_goto_y(), vitals->moves.first);
+			vitals->moves.first = 0;
 		}
 		else if (temp_actor->get_actor_type() == ACTOR_MOUNT)
 		{
@@ -385,8 +392,8 @@ void Hero::step_pathfinder(Level *level)
 			{
 				add_action(ACTION_MOVE, pathfinder->get_goto_x(), pathfinder->get_goto_y());
 				set_mount(dynamic_cast<Mount*>(temp_actor));
-				add_ability("dismount");
-				moves.first = 0;
+				add_ability(ABILITY_DISMOUNT);
+				vitals->moves.first = 0;
 			}
 			else if (ui.get_message_log() != nullptr)
 				ui.get_message_log()->add_message(name + ": \"I already have a mount!\"", DAWN_LEAF);
@@ -399,13 +406,13 @@ void Hero::step_pathfinder(Level *level)
 				if (ui.get_message_log() != nullptr)
 					ui.get_message_log()->add_message(name + ": \"My path is blocked!\"", DAWN_LEAF);
 			}
-			camera.update_position(grid_x * 32, grid_y * 32);
+			camera.update_position(position->grid_x * 32, position->grid_y * 32);
 		}
 		pathfinder->clear_path();
 	}
 	else
 	{
-		moves.first -= 1;
+		vitals->moves.first -= 1;
 		add_action(ACTION_MOVE, pathfinder->get_goto_x(), pathfinder->get_goto_y());
 
 		if (command_this_turn && !get_auto_move())
@@ -414,7 +421,7 @@ void Hero::step_pathfinder(Level *level)
 }
 void Hero::clear_pathfinder()
 {
-	if (pathfinder->get_path_found())
+	if (pathfinder->get_path_found() || pathfinder->get_path_pending())
 		pathfinder->clear_path();
 }
 void Hero::clear_ui_texture()
@@ -432,7 +439,7 @@ void Hero::clear_ui_texture()
 }
 bool Hero::input_keyboard_down(SDL_Keycode key, Level *level)
 {
-	if (!action_queue.empty() || moves.first <= 0 || ability_activated)
+	if (!action_queue.empty() || vitals->moves.first <= 0 || ability_activated)
 		return false;
 
 	int8_t offset_x = 0, offset_y = 0;
@@ -447,10 +454,10 @@ bool Hero::input_keyboard_down(SDL_Keycode key, Level *level)
 		case SDLK_KP_1: case SDLK_b: offset_x = -1; offset_y = 1; break;
 		case SDLK_KP_3: case SDLK_n: offset_x = 1; offset_y = 1; break;
 		case SDLK_KP_5: case SDLK_SPACE:
-			if (level->get_wall_type(grid_x, grid_y) == NT_BASE)
-				add_action(ACTION_INTERACT, grid_x, grid_y);
-			else turn_done = true;
-			moves.first = 0;
+			if (level->get_wall_type(position->grid_x, position->grid_y) == NT_BASE)
+				add_action(ACTION_INTERACT, position->grid_x, position->grid_y);
+			else ai->turn_done = true;
+			vitals->moves.first = 0;
 			return true;
 		default: break;
 	}
@@ -460,23 +467,23 @@ bool Hero::input_keyboard_down(SDL_Keycode key, Level *level)
 }
 bool Hero::input_mouse_button_down(uint16_t mouse_x, uint16_t mouse_y, Level *level)
 {
-	if (pathfinder != nullptr && (actions_empty() || moves.first > 0))
+	if (pathfinder != nullptr && (actions_empty() || vitals->moves.first > 0))
 	{
-		const int16_t map_x = (mouse_x + camera.get_cam_x()) / 32;
-		const int16_t map_y = (mouse_y + camera.get_cam_y()) / 32;
+		const int32_t map_x = (mouse_x + camera.get_cam_x()) / 32;
+		const int32_t map_y = (mouse_y + camera.get_cam_y()) / 32;
 
-		if (map_x == grid_x && map_y == grid_y)
+		if (map_x == position->grid_x && map_y == position->grid_y)
 		{
 			if (bubble_timer > 0)
 			{
 				clear_bubble();
 				return true;
 			}
-			if (level->get_wall_type(grid_x, grid_y) == NT_BASE)
-				add_action(ACTION_INTERACT, grid_x, grid_y);
-			else turn_done = true;
+			if (level->get_wall_type(position->grid_x, position->grid_y) == NT_BASE)
+				add_action(ACTION_INTERACT, position->grid_x, position->grid_y);
+			else ai->turn_done = true;
 
-			moves.first = 0;
+			vitals->moves.first = 0;
 			return true;
 		}
 		if (pathfinder->get_path_found())
@@ -486,7 +493,7 @@ bool Hero::input_mouse_button_down(uint16_t mouse_x, uint16_t mouse_y, Level *le
 			{
 				pathfinder->clear_path();
 				if (!auto_move_path)
-					pathfinder->find_path(level, Point(grid_x, grid_y), Point(map_x, map_y), ACTOR_HERO);
+					pathfinder->request_path(level, Point(position->grid_x, position->grid_y), Point(map_x, map_y), ACTOR_HERO, PATH_JUMP);
 				auto_move_path = false;
 			}
 			else // If we click the end of a path, start moving there automatically
@@ -496,24 +503,24 @@ bool Hero::input_mouse_button_down(uint16_t mouse_x, uint16_t mouse_y, Level *le
 			}
 		}
 		// Otherwise just calculate the new path
-		else pathfinder->find_path(level, Point(grid_x, grid_y), Point(map_x, map_y), ACTOR_HERO);
+		else pathfinder->request_path(level, Point(position->grid_x, position->grid_y), Point(map_x, map_y), ACTOR_HERO, PATH_JUMP);
 		return true;
 	}
 	return false;
 }
 bool Hero::input_joy_button_down(uint8_t index, uint8_t value, Level *level)
 {
-	if (!action_queue.empty() || moves.first <= 0 || ability_activated)
+	if (!action_queue.empty() || vitals->moves.first <= 0 || ability_activated)
 		return false;
 
 	int8_t offset_x = 0, offset_y = 0;
 	if (value == 1) switch (index)
 	{
 		case 3:
-			if (level->get_wall_type(grid_x, grid_y) == NT_BASE)
-				add_action(ACTION_INTERACT, grid_x, grid_y);
-			else turn_done = true;
-			moves.first = 0;
+			if (level->get_wall_type(position->grid_x, position->grid_y) == NT_BASE)
+				add_action(ACTION_INTERACT, position->grid_x, position->grid_y);
+			else ai->turn_done = true;
+			vitals->moves.first = 0;
 			return true;
 		default: break;
 	}
@@ -523,7 +530,7 @@ bool Hero::input_joy_button_down(uint8_t index, uint8_t value, Level *level)
 }
 bool Hero::input_joy_hat_motion(uint8_t index, uint8_t value, Level *level)
 {
-	if (!action_queue.empty() || moves.first <= 0 || ability_activated)
+	if (!action_queue.empty() || vitals->moves.first <= 0 || ability_activated)
 		return false;
 
 	int8_t offset_x = 0, offset_y = 0;
@@ -541,34 +548,34 @@ bool Hero::input_joy_hat_motion(uint8_t index, uint8_t value, Level *level)
 }
 bool Hero::move_with_offset(Level *level, int8_t offset_x, int8_t offset_y)
 {
-	Actor *temp_actor = level->get_actor(grid_x + offset_x, grid_y + offset_y);
+	Actor *temp_actor = level->get_actor(position->grid_x + offset_x, position->grid_y + offset_y);
 	if (temp_actor != nullptr)
 	{
 		if (temp_actor->get_actor_type() == ACTOR_MONSTER || temp_actor->get_actor_type() == ACTOR_PROP)
 		{
-			add_action(ACTION_ATTACK, grid_x + offset_x, grid_y + offset_y, moves.first);
-			moves.first = 0;
+			add_action(ACTION_ATTACK, position->grid_x + offset_x, position->grid_y + offset_y, vitals->moves.first);
+			vitals->moves.first = 0;
 			return true;
 		}
 		else if (temp_actor->get_actor_type() == ACTOR_MOUNT)
 		{
 			if (mount == nullptr)
 			{
-				add_action(ACTION_MOVE, grid_x + offset_x, grid_y + offset_y);
+				add_action(ACTION_MOVE, position->grid_x + offset_x, position->grid_y + offset_y);
 				set_mount(dynamic_cast<Mount*>(temp_actor));
-				add_ability("dismount");
-				moves.first = 0;
+				add_ability(ABILITY_DISMOUNT);
+				vitals->moves.first = 0;
 				return true;
 			}
 			else if (ui.get_message_log() != nullptr)
 				ui.get_message_log()->add_message(name + ": \"I already have a mount!\"", DAWN_LEAF);
 		}
 	}
-	else if (!level->get_wall(grid_x + offset_x, grid_y + offset_y, true))
+	else if (!level->get_wall(position->grid_x + offset_x, position->grid_y + offset_y, true))
 	{
-		moves.first -= 1;
-		add_action(ACTION_MOVE, grid_x + offset_x, grid_y + offset_y);
-		camera.update_position((grid_x + offset_x) * 32, (grid_y + offset_y) * 32);
+		vitals->moves.first -= 1;
+		add_action(ACTION_MOVE, position->grid_x + offset_x, position->grid_y + offset_y);
+		camera.update_position((position->grid_x + offset_x) * 32, (position->grid_y + offset_y) * 32);
 		return true;
 	}
 	return false;
@@ -590,7 +597,7 @@ void Hero::set_sleep_timer(uint8_t timer)
 	else if (timer > 0)
 	{
 		load_bubble("sleep", 5);
-		moves = std::make_pair(0, 0);
+		vitals->moves = std::make_pair(0, 0);
 	}
 	else clear_bubble();
 	sleep_timer = timer;
@@ -38,7 +38,7 @@ public:
 
 	void free();
 
-	virtual bool init(ActorType at, uint8_t xpos, uint8_t ypos, const std::string &texture_name);
+	virtual bool init(ActorType at, coord_t xpos, coord_t ypos, const std::string &texture_name);
 	virtual void update(Level *level);
 	virtual void render_ui(uint16_t xpos, uint16_t ypos) const;
 
@@ -20,8 +20,6 @@
 #include "level.hpp"
 
 #include "actor_manager.hpp"
-#include "mount.hpp"
-#include "dijkstra.hpp"
 #include "camera.hpp"
 #include "sound_manager.hpp"
 #include "texture.hpp"
@@ -29,9 +27,8 @@
 #include "message_log.hpp"
 #include "ui.hpp"
 
-Monster::Monster() : /*pathfinder(nullptr),*/ healthbar(nullptr), monster_class(MONSTER_NONE), spell_timer(0)
+Monster::Monster() : /*pathfinder(nullptr),*/ healthbar(nullptr), monster_class(MONSTER_NONE)
 {
-	health = std::make_pair(3, 3);
 	name = "???";
 }
 Monster::~Monster()
@@ -51,26 +48,27 @@ void Monster::free()
 		healthbar = nullptr;
 	}
 }
-bool Monster::init(ActorType at, uint8_t xpos, uint8_t ypos, const std::string &texture_name)
+bool Monster::init(ActorType at, coord_t xpos, coord_t ypos, const std::string &texture_name)
 {
 	if (!Actor::init(at, xpos, ypos, texture_name))
 		return false;
 
+	vitals->health = std::make_pair(3, 3);
 	return init_healthbar();// (init_pathfinder() && init_healthbar());
 }
 void Monster::render() const
 {
 	Actor::render();
 
-	if (healthbar != nullptr && in_camera && health.first > 0 &&
-		((hovered != HOVER_NONE) || health.first < health.second))
+	if (healthbar != nullptr && position->in_camera && vitals->health.first > 0 &&
+		((hovered != HOVER_NONE) || vitals->health.first < vitals->health.second))
 	{
-		const uint8_t hp_percent = (float)health.first / (float)health.second * 14;
+		const uint8_t hp_percent = (float)vitals->health.first / (float)vitals->health.second * 14;
 		const SDL_Rect temp_rect = { 28 - (hp_percent * 2), 0, 3, 16 };
 
 		healthbar->render(
-			x - camera.get_cam_x() + (facing_right ? 0 : 26),
-			y - camera.get_cam_y(),
+			position->x - camera.get_cam_x() + (animation->facing_right ? 0 : 26),
+			position->y - camera.get_cam_y(),
 			&temp_rect, 2, SDL_FLIP_NONE, 0.0
 		);
 	}
@@ -79,7 +77,7 @@ void Monster::death(Level *level)
 {
 	if (monster_class == MONSTER_KOBOLD_DEMONIAC)
 	{
-		Actor *temp = engine.get_actor_manager()->spawn_actor(level, ACTOR_MONSTER, grid_x, grid_y);
+		Actor *temp = engine.get_actor_manager()->spawn_actor(level, ACTOR_MONSTER, position->grid_x, position->grid_y);
 		dynamic_cast<Monster*>(temp)->init_class(MONSTER_KOBOLD_TRUEFORM);
 		level->set_turn(0);
 
@@ -89,147 +87,6 @@ void Monster::death(Level *level)
 		engine.get_sound_manager()->set_playlist(PT_BOSS);
 	}
 }
-void Monster::start_turn()
-{
-	turn_done = true;
-
-	const uint8_t temp_moves = (mount != nullptr) ? max_moves + 1 : max_moves;
-	moves = std::make_pair(temp_moves, temp_moves);
-
-	//if (pathfinder != nullptr)
-		//pathfinder->clear_path();
-
-	if (spell_timer > 0)
-		spell_timer -= 1;
-}
-bool Monster::take_turn(Level *level)
-{
-	if (turn_done)
-	{
-		if (moves.first > 0)
-			turn_done = false;
-	}
-	else return false;
-
-	if (!turn_done && action_queue.empty())
-	{
-		if (moves.first > 0 && has_ability("shoot"))
-		{
-			const int8_t offset_x[12] = { -1, 0, 1, -2, -2, -2, 2, 2, 2, -1, 0, 1 };
-			const int8_t offset_y[12] = { -2, -2, -2, -1, 0, 1, -1, 0, 1, 2, 2, 2 };
-
-			for (uint8_t i = 0; i < 12; i++)
-			{
-				uint8_t block_x = grid_x + offset_x[i];
-				if (offset_x[i] == -2) block_x += 1;
-				else if (offset_x[i] == 2) block_x -= 1;
-
-				uint8_t block_y = grid_y + offset_y[i];
-				if (offset_y[i] == -2) block_y += 1;
-				else if (offset_y[i] == 2) block_y -= 1;
-
-				if (!level->get_wall(block_x, block_y))
-				{
-					Actor *temp_actor = level->get_actor(grid_x + offset_x[i], grid_y + offset_y[i]);
-					if (temp_actor != nullptr && temp_actor->get_actor_type() == ACTOR_HERO)
-					{
-						add_action(ACTION_SHOOT, grid_x + offset_x[i], grid_y + offset_y[i]);
-						moves.first = 0;
-						break;
-					}
-				}
-			}
-		}
-		if (moves.first > 0 && has_ability("weakness") && spell_timer == 0)
-		{
-			std::vector<Actor*> targets;
-			for (int8_t ypos = -2; ypos < 3; ypos++)
-			{
-				for (int8_t xpos = -2; xpos < 3; xpos++)
-				{
-					Actor *temp_actor = level->get_actor(grid_x + xpos, grid_y + ypos);
-					if (temp_actor != nullptr && temp_actor->get_actor_type() == ACTOR_HERO)
-					{
-						if (temp_actor->get_status() != STATUS_WEAK)
-							targets.push_back(temp_actor);
-					}
-				}
-			}
-			if (targets.size() > 0)
-			{
-				Actor *temp_actor = targets[targets.size() - 1];
-				temp_actor->set_status(STATUS_WEAK);
-
-				add_action(ACTION_INTERACT, grid_x, grid_y);
-				spell_timer = 5;
-				moves.first = 0;
-
-				if (ui.get_message_log() != nullptr)
-					ui.get_message_log()->add_message("The " + name + " casts %6Weakness%9!", DAWN_OCHER);
-			}
-		}
-		if (moves.first > 0 && has_ability("necromancy") && spell_timer == 0)
-		{
-			Actor *spawn = engine.get_actor_manager()->spawn_actor(level, ACTOR_MONSTER, grid_x, grid_y);
-			if (spawn != nullptr)
-			{
-				if (engine.get_rng() % 10 != 0)
-					dynamic_cast<Monster*>(spawn)->init_class(MONSTER_SKELETON);
-				else dynamic_cast<Monster*>(spawn)->init_class(MONSTER_SKELETON_DISEASED);
-
-				add_action(ACTION_INTERACT, grid_x, grid_y);
-				spell_timer = 4;
-				moves.first = 0;
-
-				if (ui.get_message_log() != nullptr)
-					ui.get_message_log()->add_message("The " + name + " summons a minion!", DAWN_OCHER);
-			}
-		}
-		if (moves.first > 0 && level->get_dijkstra() != nullptr)//pathfinder != nullptr)
-		{
-			Point step_pos = level->get_dijkstra()->get_node_downhill(level, Point(grid_x, grid_y));
-			if (step_pos.x == grid_x && step_pos.y == grid_y)
-			{
-				if (level->get_wall_type(grid_x, grid_y) == NT_BASE)
-					add_action(ACTION_INTERACT, step_pos.x, step_pos.y);
-				else add_action(ACTION_MOVE, step_pos.x, step_pos.y);
-
-				moves.first = 0;
-				return false;
-			}
-			Actor *temp_actor = level->get_actor(step_pos.x, step_pos.y);
-			if (temp_actor == nullptr)
-			{
-				add_action(ACTION_MOVE, step_pos.x, step_pos.y);
-				moves.first -= 1;
-			}
-			else
-			{
-				if (temp_actor->get_actor_type() == ACTOR_HERO || temp_actor->get_actor_type() == ACTOR_PROP)
-					add_action(ACTION_ATTACK, step_pos.x, step_pos.y);
-
-				else if (temp_actor->get_actor_type() == ACTOR_MOUNT)
-				{
-					if (mount == nullptr)
-					{
-						set_mount(dynamic_cast<Mount*>(temp_actor));
-						add_action(ACTION_MOVE, step_pos.x, step_pos.y);
-					}
-					else turn_done = true;
-				}
-				else turn_done = true;
-				moves.first = 0;
-			}
-			/*if (!pathfinder->get_path_found())
-			{
-				auto base_pos = level->get_base_pos();
-				pathfinder->find_path(level, Point(grid_x, grid_y), Point(base_pos.first, base_pos.second), ACTOR_MONSTER);
-			}
-			step_pathfinder(level);*/
-		}
-	}
-	return Actor::take_turn(level);
-}
 void Monster::end_turn()
 {
 	Actor::end_turn();
@@ -243,7 +100,7 @@ void Monster::interact(Level *level, Point pos)
 			level->set_damage_base(20);
 		else level->set_damage_base(1);
 
-		delete_me = true;
+		set_delete(true);
 	}
 }
 bool Monster::init_class(MonsterClass mc)
@@ -260,7 +117,7 @@ bool Monster::init_class(MonsterClass mc)
 		case MONSTER_PLATINO:
 			name = "Platino";
 			class_texture = "actor/dragon_de_platino.png";
-			health = std::make_pair(20, 20);
+			vitals->health = std::make_pair(20, 20);
 			proj_type = PROJECTILE_WITHER;
 			max_damage = 3;
 			break;
@@ -282,7 +139,7 @@ bool Monster::init_class(MonsterClass mc)
 			name = "Humongous Scorpion";
 			class_texture = "actor/pest_scorpion.png";
 			proj_type = PROJECTILE_DART;
-			health = std::make_pair(8, 8);
+			vitals->health = std::make_pair(8, 8);
 			break;
 		case MONSTER_KOBOLD_WARRIOR:
 			name = "Kobold Warrior";
@@ -292,13 +149,13 @@ bool Monster::init_class(MonsterClass mc)
 			name = "Kobold Archer";
 			class_texture = "actor/kobold_archer.png";
 			proj_type = PROJECTILE_ARROW;
-			add_ability("shoot");
+			add_ability(ABILITY_SHOOT);
 			break;
 		case MONSTER_KOBOLD_MAGE:
 			name = "Kobold Mage";
 			class_texture = "actor/kobold_mage.png";
-			add_ability("weakness");
-			spell_timer = 2;
+			add_ability(ABILITY_WEAKNESS);
+			ai->spell_timer = 2;
 			break;
 		case MONSTER_KOBOLD_DEMONIAC:
 			name = "Kobold Demoniac";
@@ -309,8 +166,8 @@ bool Monster::init_class(MonsterClass mc)
 			name = "Kobold Trueform";
 			class_texture = "actor/kobold_trueform.png";
 			proj_type = PROJECTILE_FIREBALL;
-			health = std::make_pair(8, 8);
-			add_ability("shoot");
+			vitals->health = std::make_pair(8, 8);
+			add_ability(ABILITY_SHOOT);
 			max_moves = 2;
 			break;
 		case MONSTER_DWARF_WARRIOR:
@@ -321,54 +178,54 @@ bool Monster::init_class(MonsterClass mc)
 		case MONSTER_DWARF_NECROMANCER:
 			name = "Dwarven Necromancer";
 			class_texture = "actor/dwarf_necromancer.png";
-			add_ability("necromancy");
-			spell_timer = 2;
+			add_ability(ABILITY_NECROMANCY);
+			ai->spell_timer = 2;
 			break;
 		case MONSTER_DWARF_BEASTMASTER:
 			name = "Dwarven Beastmaster";
 			class_texture = "actor/dwarf_beastmaster.png";
 			proj_type = PROJECTILE_DART;
-			add_ability("shoot");
+			add_ability(ABILITY_SHOOT);
 			break;
 		case MONSTER_DWARF_KING:
 			name = "Dwarven King";
 			class_texture = "actor/dwarf_king.png";
-			health = std::make_pair(12, 12);
+			vitals->health = std::make_pair(12, 12);
 			max_damage = 2;
 			break;
 		case MONSTER_DEMON_RED:
 			name = "Demon";
 			class_texture = "actor/demon_red.png";
-			health = std::make_pair(4, 4);
+			vitals->health = std::make_pair(4, 4);
 			set_status(STATUS_REGEN);
 			max_damage = 2;
 			break;
 		case MONSTER_DEMON_HORNED:
 			name = "Horned Demon";
 			class_texture = "actor/demon_horned.png";
-			health = std::make_pair(4, 4);
+			vitals->health = std::make_pair(4, 4);
 			max_damage = 2;
 			break;
 		case MONSTER_DEMON_PLATINUM:
 			name = "Platinum Demon";
 			class_texture = "actor/demon_platinum.png";
-			health = std::make_pair(5, 5);
+			vitals->health = std::make_pair(5, 5);
 			proj_type = PROJECTILE_WITHER;
 			max_damage = 2;
 			break;
 		case MONSTER_DEMON_FLYING:
 			name = "Flying Demon";
 			class_texture = "actor/demon_flying.png";
-			health = std::make_pair(4, 4);
+			vitals->health = std::make_pair(4, 4);
 			max_damage = 2;
 			max_moves = 2;
 			break;
 		case MONSTER_DEMON_FIRE:
 			name = "Fire Demon";
 			class_texture = "actor/demon_fire.png";
-			health = std::make_pair(4, 4);
+			vitals->health = std::make_pair(4, 4);
 			proj_type = PROJECTILE_FIREBALL;
-			add_ability("shoot");
+			add_ability(ABILITY_SHOOT);
 			max_damage = 2;
 			break;
 		case MONSTER_SKELETON:
@@ -55,12 +55,10 @@ public:
 
 	void free();
 
-	virtual bool init(ActorType at, uint8_t xpos, uint8_t ypos, const std::string &texture_name);
+	virtual bool init(ActorType at, coord_t xpos, coord_t ypos, const std::string &texture_name);
 	virtual void render() const;
 	virtual void death(Level *level);
 
-	virtual void start_turn();
-	virtual bool take_turn(Level *level);
 	virtual void end_turn();
 
 	virtual void interact(Level *level, Point pos);
@@ -77,7 +75,6 @@ private:
 	Texture *healthbar;
 
 	MonsterClass monster_class;
-	uint8_t spell_timer;
 };
 
 #endif // MONSTER_HPP
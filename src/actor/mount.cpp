@@ -17,9 +17,10 @@
 
 #include "engine.hpp"
 #include "mount.hpp"
-#include "level.hpp"
 
-Mount::Mount() : rider(nullptr)
+#include "actor_manager.hpp"
+
+Mount::Mount()
 {
 
 }
@@ -29,66 +30,23 @@ Mount::~Mount()
 }
 void Mount::free()
 {
-	if (rider != nullptr)
-	{
-		rider->set_mount(nullptr);
-		rider = nullptr;
-	}
-}
-void Mount::update(Level *level)
-{
-	Actor::update(level);
+	if (ai == nullptr || ai->rider == ACTOR_HANDLE_NONE)
+		return;
 
+	Actor *rider = (engine.get_actor_manager() != nullptr) ? engine.get_actor_manager()->get_actor(ai->rider) : nullptr;
 	if (rider != nullptr)
-	{
-		if (x != rider->get_x() || y != rider->get_y())
-		{
-			facing_right = rider->get_facing_right();
-			x = rider->get_x(); y = rider->get_y();
-		}
-		frame_rect.y = rider->get_frame_rect().y;
-		in_camera = rider->get_in_camera();
-	}
-}
-void Mount::start_turn()
-{
-	if (rider == nullptr)
-	{
-		turn_done = false;
-		moves = std::make_pair(1, 1);
-	}
-	else turn_done = true;
-}
-bool Mount::take_turn(Level *level)
-{
-	if (turn_done)
-		return true;
-
-	if (actions_empty() && moves.first > 0)
-	{
-		if (engine.get_rng() % 10 == 0)
-		{
-			const int8_t offset_x[4] = { 0, 0, -1, 1 };
-			const int8_t offset_y[4] = { -1, 1, 0, 0 };
-			const uint8_t i = engine.get_rng() % 4;
-
-			if (!level->get_wall(grid_x + offset_x[i], grid_y + offset_y[i], true))
-				add_action(ACTION_MOVE, grid_x + offset_x[i], grid_y + offset_y[i]);
-			else turn_done = true;
-			moves.first = 0;
-		}
-		else turn_done = true;
-	}
-	return turn_done;
+		rider->set_mount(nullptr);
+	ai->rider = ACTOR_HANDLE_NONE;
 }
 void Mount::set_rider(Actor *new_rider)
 {
-	rider = new_rider;
-	if (rider != nullptr)
+	// ActorWorld::follow_riders() keeps us under the rider from here on
+	ai->rider = (new_rider != nullptr) ? new_rider->get_handle() : ACTOR_HANDLE_NONE;
+	if (new_rider != nullptr)
 	{
-		x = rider->get_x(); y = rider->get_y();
-		facing_right = rider->get_facing_right();
-		frame_rect.y = rider->get_frame_rect().y;
-		in_camera = rider->get_in_camera();
+		position->x = new_rider->get_x(); position->y = new_rider->get_y();
+		animation->facing_right = new_rider->get_facing_right();
+		animation->frame_rect.y = new_rider->get_frame_rect().y;
+		position->in_camera = new_rider->get_in_camera();
 	}
 }
@@ -34,14 +34,7 @@ public:
 
 	void free();
 
-	virtual void update(Level *level);
-	virtual void start_turn();
-	virtual bool take_turn(Level *level);
-
 	void set_rider(Actor *new_rider);
-
-private:
-	Actor *rider;
 };
 
 #endif // MOUNT_HPP
@@ -26,7 +26,3 @@ Prop::~Prop()
 {
 
 }
-bool Prop::take_turn(Level *level)
-{
-	return true;
-}
@@ -25,8 +25,6 @@ class Prop : public Actor
 public:
 	Prop();
 	~Prop();
-
-	virtual bool take_turn(Level *level);
 };
 
 #endif // PROP_HPP
@@ -0,0 +1,89 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+#include "engine.hpp"
+#include "turn_scheduler.hpp"
+#include "actor.hpp"
+
+TurnScheduler::TurnScheduler() : current_valid(false), current_removed(false), current_ID(0)
+{
+	current = queue.end();
+}
+TurnScheduler::~TurnScheduler()
+{
+	free();
+}
+void TurnScheduler::free()
+{
+	queue.clear();
+	current = queue.end();
+	current_valid = false;
+	current_removed = false;
+	current_ID = 0;
+}
+void TurnScheduler::insert(Actor *actor)
+{
+	if (actor != nullptr)
+		queue.emplace(actor->get_ID(), actor);
+}
+void TurnScheduler::remove(Actor *actor)
+{
+	if (actor == nullptr)
+		return;
+
+	auto it = queue.find(actor->get_ID());
+	if (it == queue.end())
+		return;
+
+	// The next actor is whoever comes after the removed one's ID, even if it was spawned afterwards
+	if (current_valid && it == current)
+	{
+		current_valid = false;
+		current_removed = true;
+	}
+	queue.erase(it);
+}
+void TurnScheduler::set_current(Actor *actor)
+{
+	current = (actor != nullptr) ? queue.find(actor->get_ID()) : queue.end();
+	current_valid = current != queue.end();
+	current_removed = false;
+	current_ID = current_valid ? current->first : 0;
+}
+Actor* TurnScheduler::advance(bool &round_over)
+{
+	round_over = false;
+	if (current_valid)
+		++current;
+	else if (current_removed)
+		current = queue.upper_bound(current_ID);
+	else current = queue.begin();
+
+	if (current == queue.end())
+	{
+		current = queue.begin();
+		round_over = true;
+	}
+	current_valid = current != queue.end();
+	current_removed = false;
+
+	if (!current_valid)
+		return nullptr;
+
+	current_ID = current->first;
+	return current->second;
+}
@@ -0,0 +1,51 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef TURN_SCHEDULER_HPP
+#define TURN_SCHEDULER_HPP
+
+#include <map>
+
+class Actor;
+
+// Actors take their turns in ID order, which is also the order they were spawned in.
+// Keyed by ID, spawning and deleting are O(log n) and moving on to the next actor is O(1)
+class TurnScheduler
+{
+public:
+	TurnScheduler();
+	~TurnScheduler();
+
+	void free();
+
+	void insert(Actor *actor);
+	void remove(Actor *actor);
+	void set_current(Actor *actor);
+	Actor* advance(bool &round_over);
+
+	std::size_t get_size() const { return queue.size(); }
+
+private:
+	bool current_valid;
+	bool current_removed;
+	uint32_t current_ID;
+
+	std::map<uint32_t, Actor*> queue;
+	std::map<uint32_t, Actor*>::iterator current;
+};
+
+#endif // TURN_SCHEDULER_HPP
@@ -18,20 +18,21 @@
 #include "engine.hpp"
 #include "astar.hpp"
 #include "level.hpp"
+#include "path_cache.hpp"
+#include "path_engine.hpp"
+#include "path_hierarchy.hpp"
+#include "path_jobs.hpp"
 #include "texture.hpp"
 
 #include "actor.hpp"
 #include "camera.hpp"
 #include "texture_manager.hpp"
 
-#include <cfloat> // for FLT_MAX
-#include <algorithm> // for std::find
-
 /*uint16_t distance(int16_t x1, int16_t y1, int16_t x2, int16_t y2)
 {
 	return (uint16_t)SDL_sqrt((x2-x1)*(x2-x1) + (y2-y1)*(y2-y1));
 }*/
-AStar::AStar() : path_found(false), path_marker(nullptr)
+AStar::AStar() : path_found(false), path_marker(nullptr), pending_key({ Point(0, 0), Point(0, 0), 0, PATH_GRID, true })
 {
 
 }
@@ -51,6 +52,7 @@ void AStar::free()
 {
 	path.clear();
 	path_found = false;
+	pending_path = std::future<PathJobResult>();
 
 	if (path_marker != nullptr)
 	{
@@ -58,143 +60,101 @@ void AStar::free()
 		path_marker = nullptr;
 	}
 }
-bool AStar::find_path(Level *level, Point start, Point end, uint8_t finder)
+bool AStar::find_path(Level *level, Point start, Point end, uint8_t finder, PathMode mode)
 {
-	// Make sure we're not trying to path into a wall
-	if (level == nullptr || level->get_wall(end.x, end.y) || (end.x == start.x && end.y == start.y))
+	if (level == nullptr || level->get_path_engine() == nullptr)
 		return false;
 
-	std::vector<std::shared_ptr<ASNode> > open_list, closed_list, final_path;
-	std::shared_ptr<ASNode> c = std::make_shared<ASNode>();
-
-	c->f = 0; c->g = 0; c->h = 0;
-	c->x = start.x; c->y = start.y;
-	open_list.push_back(c);
-
-	c.reset();
-
-	// Used for looping all neighbouring nodes
-	const int8_t offset_x[8] = { 0, 0, -1, 1, -1, 1, -1, 1 };
-	const int8_t offset_y[8] = { -1, 1, 0, 0, -1, -1, 1, 1 };
+	// Same query on an unchanged map, reuse whatever we (or another hero) found last time.
+	// Cluster graph paths are kept apart from exact ones, so a query always gets the same kind of answer.
+	PathHierarchy *hierarchy = (mode == PATH_CLUSTER) ? level->get_path_hierarchy() : nullptr;
+	PathCache *cache = level->get_path_cache();
+	const PathCacheKey key = { start, end, finder, mode, hierarchy == nullptr };
+	const PathCacheEntry *entry = (cache != nullptr) ? cache->get_entry(key, level->get_map_revision()) : nullptr;
 
-	bool stop_search = false;
-	while (!stop_search && !open_list.empty())
+	if (entry != nullptr)
 	{
-		// Get the node with the lowest f score
-		std::shared_ptr<ASNode> q;
-		float f = FLT_MAX;
-		for (std::shared_ptr<ASNode> n : open_list)
-		{
-			if (n->f < f)
-			{
-				f = n->f;
-				q = n;
-			}
-		}
-		// Move it to the closed list
-		closed_list.push_back(q);
-		open_list.erase(std::find(open_list.begin(), open_list.end(), q));
-
-		// Loop through the neighbouring nodes
-		const uint8_t max = (finder != 0) ? 8 : 4;
-		for (uint8_t i = 0; i < max; i++)
-		{
-			const int8_t new_x = q->x + offset_x[i];
-			const int8_t new_y = q->y + offset_y[i];
+		if (!entry->found)
+			return false;
+		path = entry->path;
+	}
+	else
+	{
+		// The search itself runs on the level's shared node array,
+		// we only keep the resulting path (goal first, next step last).
+		// Callers that asked for it get long trips over the cluster graph, jump point
+		// queries go next, and anything still unresolved falls back to a full grid search.
+		PathEngine *path_engine = level->get_path_engine();
+
+		const bool found =
+			(hierarchy != nullptr && hierarchy->find_path(level, start, end, finder, path)) ||
+			(mode == PATH_JUMP && path_engine->find_path_jump(level, start, end, finder, path)) ||
+			path_engine->find_path(level, start, end, finder, path);
+
+		if (cache != nullptr)
+			cache->add_entry(key, level->get_map_revision(), found, path);
+		if (!found)
+			return false;
+	}
 
-			if (level->get_wall(new_x, new_y))
-				continue;
+	goto_x = path.back().x;
+	goto_y = path.back().y;
+	path_found = true;
 
-			if (finder != 0)
-			{
-				// Path around anyone with the same ActorType
-				const Actor *temp_actor = level->get_actor(new_x, new_y);
-				if (temp_actor != nullptr && temp_actor->get_actor_type() == finder)
-					continue;
-			}
-			// Ignore nodes on the closed list
-			bool ignore = false;
-			for (std::shared_ptr<ASNode> n : closed_list)
-			{
-				if (n->x == new_x && n->y == new_y)
-				{
-					ignore = true;
-					break;
-				}
-			}
-			if (ignore) continue;
+	return true;
+}
+bool AStar::request_path(Level *level, Point start, Point end, uint8_t finder, PathMode mode)
+{
+	if (level == nullptr || level->get_path_engine() == nullptr)
+		return false;
 
-			// If it's already on the open list, check if this path is better
-			for (std::shared_ptr<ASNode> n : open_list)
-			{
-				if (n->x == new_x && n->y == new_y)
-				{
-					ignore = true;
-					if (n->g > q->g + (i > 3 ? 1.4f : 1.0f))
-					{
-						n->parent = q;
-						n->g = q->g + (i > 3 ? 1.4f : 1.0f);
-						n->f = n->g + n->h;
-					}
-					break;
-				}
-			}
-			// If not, add it there and calculate the A* magic numbers
-			if (!ignore)
-			{
-				std::shared_ptr<ASNode> n = std::make_shared<ASNode>();
-				n->parent = q;
-				n->x = new_x; n->y = new_y;
+	PathJobs *jobs = level->get_path_jobs();
+	if (jobs == nullptr)
+		return find_path(level, start, end, finder, mode);
 
-				// If we've found the end, stop the search
-				if (new_x == end.x && new_y == end.y)
-				{
-					c = n;
-					closed_list.push_back(n);
-					stop_search = true;
-					break;
-				}
-				// Heurestics, magic numbers
-				n->g = q->g + (i > 3 ? 1.4f : 1.0f);
-				n->h = (float)SDL_sqrt((end.x - new_x)*(end.x - new_x) + (end.y - new_y)*(end.y - new_y));
-				n->f = n->g + n->h;
-				open_list.push_back(n);
+	// A cached answer doesn't need the worker at all, the worker only ever does exact searches
+	PathCache *cache = level->get_path_cache();
+	const PathCacheKey key = { start, end, finder, mode, true };
+	const PathCacheEntry *entry = (cache != nullptr) ? cache->get_entry(key, level->get_map_revision()) : nullptr;
 
-				if (c == nullptr || n->h < c->h)
-					c = n;
-				n.reset();
-			}
-		}
-		q.reset();
-	}
-	if (c == nullptr)
-	{
-		open_list.clear();
-		closed_list.clear();
-		final_path.clear();
-		return false;
-	}
-	// Trace the path back from the last node
-	uint8_t xpos = c->x, ypos = c->y;
-	while (xpos != start.x || ypos != start.y)
+	if (entry != nullptr)
 	{
-		if (c == nullptr)
-			break;
-		xpos = c->x; ypos = c->y;
-		final_path.push_back(c);
-		c = c->parent;
+		clear_path();
+		if (!entry->found)
+			return false;
+
+		path = entry->path;
+		goto_x = path.back().x;
+		goto_y = path.back().y;
+		path_found = true;
+		return true;
 	}
-	// Remove the starting node from the path
-	final_path.erase(final_path.end() - 1);
+	// Replaces any request still in flight, a queued one is dropped without being searched
+	clear_path();
+	pending_key = key;
+	pending_path = jobs->request_path(level->get_path_grid(), start, end, finder, mode, this);
+	return true;
+}
+bool AStar::poll_path(Level *level)
+{
+	if (!pending_path.valid() || pending_path.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+		return false;
 
-	path = final_path;
-	goto_x = path.back()->x;
-	goto_y = path.back()->y;
-	path_found = true;
+	PathJobResult result = pending_path.get();
+	if (result.skipped)
+		return false;
 
-	open_list.clear();
-	closed_list.clear();
-	final_path.clear();
+	// Cached under the revision the search saw, a newer map won't mistake it for current
+	PathCache *cache = (level != nullptr) ? level->get_path_cache() : nullptr;
+	if (cache != nullptr)
+		cache->add_entry(pending_key, result.revision, result.found, result.path);
+	if (!result.found)
+		return false;
+
+	path.swap(result.path);
+	goto_x = path.back().x;
+	goto_y = path.back().y;
+	path_found = true;
 
 	return true;
 }
@@ -202,6 +162,7 @@ void AStar::clear_path()
 {
 	path.clear();
 	path_found = false;
+	pending_path = std::future<PathJobResult>();
 }
 void AStar::step()
 {
@@ -215,13 +176,13 @@ void AStar::step()
 
 	else if (path.size() == 1)
 	{
-		goto_x = path[0]->x;
-		goto_y = path[0]->y;
+		goto_x = path[0].x;
+		goto_y = path[0].y;
 	}
 	else
 	{
-		std::shared_ptr<ASNode> n = path.back();
-		goto_x = n->x; goto_y = n->y;
+		goto_x = path.back().x;
+		goto_y = path.back().y;
 	}
 }
 void AStar::render(uint8_t good_length) const
@@ -230,30 +191,30 @@ void AStar::render(uint8_t good_length) const
 		return;
 
 	path_marker->set_color(DAWN_BERRY);
-	uint8_t length = path.size();
+	uint32_t length = path.size();
 
-	for (std::shared_ptr<ASNode> n : path)
+	for (const Point &n : path)
 	{
 		length -= 1;
 		if (length < good_length)
 			path_marker->set_color(DAWN_LEAF);
 
-		if (camera.get_in_camera_grid(n->x, n->y))
+		if (camera.get_in_camera_grid(n.x, n.y))
 			path_marker->render(
-				n->x * 32 - camera.get_cam_x(),
-				n->y * 32 - camera.get_cam_y()
+				n.x * 32 - camera.get_cam_x(),
+				n.y * 32 - camera.get_cam_y()
 			);
 	}
 }
-uint8_t AStar::get_last_x() const
+coord_t AStar::get_last_x() const
 {
 	if (path.size() > 0)
-		return path[0]->x;
+		return path[0].x;
 	else return 0;
 }
-uint8_t AStar::get_last_y() const
+coord_t AStar::get_last_y() const
 {
 	if (path.size() > 0)
-		return path[0]->y;
+		return path[0].y;
 	else return 0;
 }
@@ -18,18 +18,16 @@
 #ifndef ASTAR_HPP
 #define ASTAR_HPP
 
+#include "path_cache.hpp"
+#include "path_engine.hpp"
+#include "path_jobs.hpp"
+
+#include <future>
 #include <vector>
-#include <memory> // for std::shared_ptr
 
 class Level;
 class Texture;
 
-struct ASNode
-{
-	std::shared_ptr<ASNode> parent;
-	uint8_t x, y;
-	float f, g, h;
-};
 class AStar
 {
 public:
@@ -39,26 +37,32 @@ public:
 	bool init();
 	void free();
 
-	bool find_path(Level *level, Point start, Point end, uint8_t finder);
+	bool find_path(Level *level, Point start, Point end, uint8_t finder, PathMode mode = PATH_GRID);
+	bool request_path(Level *level, Point start, Point end, uint8_t finder, PathMode mode = PATH_GRID);
+	bool poll_path(Level *level);
 	void clear_path();
 
 	void step();
 	void render(uint8_t good_length = 0) const;
 
 	bool get_path_found() const { return path_found; }
-	uint8_t get_length() const { return path.size(); }
-	uint8_t get_goto_x() const { return goto_x; }
-	uint8_t get_goto_y() const { return goto_y; }
-	uint8_t get_last_x() const;
-	uint8_t get_last_y() const;
+	bool get_path_pending() const { return pending_path.valid(); }
+	uint32_t get_length() const { return path.size(); }
+	coord_t get_goto_x() const { return goto_x; }
+	coord_t get_goto_y() const { return goto_y; }
+	coord_t get_last_x() const;
+	coord_t get_last_y() const;
 
 private:
 	bool path_found;
-	uint8_t goto_x;
-	uint8_t goto_y;
+	coord_t goto_x;
+	coord_t goto_y;
 
-	std::vector<std::shared_ptr<ASNode> > path;
+	std::vector<Point> path;
 	Texture *path_marker;
+
+	PathCacheKey pending_key;
+	std::future<PathJobResult> pending_path;
 };
 
 #endif // ASTAR_HPP
@@ -0,0 +1,174 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+#include "engine.hpp"
+#include "bit_grid.hpp"
+
+#include <algorithm>
+#include <array>
+
+// The 64 bits from shift onwards, the spare word at the end of each row keeps row[1] in bounds
+uint64_t get_funnel(const uint64_t *row, uint32_t shift)
+{
+	return (row[0] >> shift) | (row[1] << (63 - shift) << 1);
+}
+// Nine bits of a 3x3 block, top row first, to the neighbour mask of its middle tile
+const std::array<uint8_t, 512> NEIGHBOR_ORDER = []()
+{
+	std::array<uint8_t, 512> order = {};
+	for (uint16_t block = 0; block < 512; block++)
+	{
+		for (int8_t y = -1; y < 2; y++)
+		{
+			for (int8_t x = -1; x < 2; x++)
+			{
+				if ((x != 0 || y != 0) && ((block >> ((y + 1) * 3 + x + 1)) & 1))
+					order[block] |= 1 << NEIGHBOR_BIT[y + 1][x + 1];
+			}
+		}
+	}
+	return order;
+}();
+BitGrid::BitGrid() : border(false), width(0), height(0), stride(0)
+{
+
+}
+BitGrid::~BitGrid()
+{
+	free();
+}
+void BitGrid::init(coord_t grid_width, coord_t grid_height, bool border_value)
+{
+	width = grid_width;
+	height = grid_height;
+	border = border_value;
+
+	// A one tile border around the map answers edge lookups without bounds checks,
+	// the spare word at the end of each row lets any read straddle two words
+	stride = (width + 2) / 64 + 2;
+	words.assign(stride * (height + 2), border ? ~(uint64_t)0 : 0);
+
+	for (coord_t y = 0; y < height; y++)
+	{
+		for (coord_t x = 0; x < width; x++)
+			set(x, y, false);
+	}
+}
+void BitGrid::free()
+{
+	words.clear();
+	width = 0;
+	height = 0;
+	stride = 0;
+}
+bool BitGrid::get(int32_t xpos, int32_t ypos) const
+{
+	if (xpos < 0 || ypos < 0 || xpos >= width || ypos >= height)
+		return border;
+
+	const uint32_t column = xpos + 1;
+	return (words[(ypos + 1) * stride + column / 64] >> (column % 64)) & 1;
+}
+void BitGrid::set(coord_t xpos, coord_t ypos, bool value)
+{
+	if (xpos >= width || ypos >= height)
+		return;
+
+	const uint32_t column = xpos + 1;
+	uint64_t &word = words[(ypos + 1) * stride + column / 64];
+
+	if (value)
+		word |= (uint64_t)1 << (column % 64);
+	else word &= ~((uint64_t)1 << (column % 64));
+}
+uint8_t BitGrid::get_neighbors(int32_t xpos, int32_t ypos) const
+{
+	// Off the map (the border itself included) everything counts as the border value
+	if (xpos < 0 || ypos < 0 || xpos >= width || ypos >= height)
+		return border ? UINT8_MAX : 0;
+
+	// The 3x3 block around us as nine bits, row by row, looked up in neighbour order
+	const uint64_t *row = &words[ypos * stride + xpos / 64];
+	const uint32_t shift = xpos % 64;
+	const uint32_t block = get_funnel(row, shift) & 7;
+
+	return NEIGHBOR_ORDER[block | (get_funnel(row + stride, shift) & 7) << 3 | (get_funnel(row + stride * 2, shift) & 7) << 6];
+}
+uint32_t BitGrid::get_window(int32_t xpos, int32_t ypos) const
+{
+	// Bit (y + 2) * 5 + (x + 2) is the tile at offset (x, y), see stencil.hpp
+	uint32_t window = 0;
+	if (xpos < 1 || ypos < 1 || xpos + 2 > width || ypos + 2 > height)
+	{
+		// Near the edges the window reaches past the one tile border, go tile by tile
+		for (int8_t y = 0; y < 5; y++)
+		{
+			for (int8_t x = 0; x < 5; x++)
+			{
+				if (get(xpos + x - 2, ypos + y - 2))
+					window |= 1 << (y * 5 + x);
+			}
+		}
+		return window;
+	}
+	// All five rows start at the same column, so they share one word offset and shift
+	const uint64_t *row = &words[(ypos - 1) * stride + (xpos - 1) / 64];
+	const uint32_t shift = (xpos - 1) % 64;
+	for (uint8_t y = 0; y < 5; y++, row += stride)
+		window |= (get_funnel(row, shift) & 31) << (y * 5);
+	return window;
+}
+void BitGrid::get_row_neighbors(coord_t xpos, coord_t ypos, coord_t count, uint8_t *masks) const
+{
+	if (ypos >= height || xpos >= width)
+		return;
+	count = std::min<int32_t>(count, width - xpos);
+
+	for (int32_t first = 0; first < count; first += 64)
+	{
+		// One word per neighbour direction, bit i of each is the neighbour of tile xpos + first + i
+		const uint32_t column = xpos + first;
+		const uint64_t directions[8] = {
+			get_row_word(ypos, column + 1), get_row_word(ypos + 2, column + 1),
+			get_row_word(ypos + 1, column), get_row_word(ypos + 1, column + 2),
+			get_row_word(ypos, column), get_row_word(ypos, column + 2),
+			get_row_word(ypos + 2, column), get_row_word(ypos + 2, column + 2)
+		};
+		const int32_t tiles = std::min<int32_t>(64, count - first);
+		for (int32_t group = 0; group < tiles; group += 8)
+		{
+			// Byte d is direction d for eight tiles, transposed it is eight tiles of one mask each
+			uint64_t block = 0;
+			for (uint8_t d = 0; d < 8; d++)
+				block |= ((directions[d] >> group) & 0xFF) << (d * 8);
+
+			uint64_t t = (block ^ (block >> 7)) & 0x00AA00AA00AA00AAULL;
+			block ^= t ^ (t << 7);
+			t = (block ^ (block >> 14)) & 0x0000CCCC0000CCCCULL;
+			block ^= t ^ (t << 14);
+			t = (block ^ (block >> 28)) & 0x00000000F0F0F0F0ULL;
+			block ^= t ^ (t << 28);
+
+			for (int32_t i = 0; i < 8 && group + i < tiles; i++)
+				masks[first + group + i] = block >> (i * 8);
+		}
+	}
+}
+uint64_t BitGrid::get_row_word(uint32_t row, uint32_t column) const
+{
+	return get_funnel(&words[row * stride + column / 64], column % 64);
+}
@@ -0,0 +1,60 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef BIT_GRID_HPP
+#define BIT_GRID_HPP
+
+#include <vector>
+
+// Offset (x, y) to its bit in a neighbour mask, the middle maps past the end
+const uint8_t NEIGHBOR_BIT[3][3] = { { 4, 0, 5 }, { 2, 8, 3 }, { 6, 1, 7 } };
+
+inline bool get_neighbor_bit(uint8_t mask, int8_t offset_x, int8_t offset_y)
+{
+	return (mask >> NEIGHBOR_BIT[offset_y + 1][offset_x + 1]) & 1;
+}
+// Bit i of a neighbour mask is the tile at offset i of the usual
+// { N, S, W, E, NW, NE, SW, SE } tables used by the pathfinders
+class BitGrid
+{
+public:
+	BitGrid();
+	~BitGrid();
+
+	void init(coord_t grid_width, coord_t grid_height, bool border_value);
+	void free();
+
+	bool get(int32_t xpos, int32_t ypos) const;
+	void set(coord_t xpos, coord_t ypos, bool value);
+	uint8_t get_neighbors(int32_t xpos, int32_t ypos) const;
+	uint32_t get_window(int32_t xpos, int32_t ypos) const;
+
+	// Neighbour masks of count tiles from (xpos, ypos) along the row, 64 at a time
+	void get_row_neighbors(coord_t xpos, coord_t ypos, coord_t count, uint8_t *masks) const;
+
+private:
+	uint64_t get_row_word(uint32_t row, uint32_t column) const;
+
+	bool border;
+	coord_t width;
+	coord_t height;
+	uint32_t stride;
+
+	std::vector<uint64_t> words;
+};
+
+#endif // BIT_GRID_HPP
@@ -18,13 +18,20 @@
 #include "engine.hpp"
 #include "dijkstra.hpp"
 #include "level.hpp"
+#include "path_grid.hpp"
 
 #include "actor.hpp"
 #include "camera.hpp"
 #include "bitmap_font.hpp"
 #include "ui.hpp"
 
-Dijkstra::Dijkstra()
+#include <algorithm>
+
+// Used for looping all neighbouring nodes
+const int8_t offset_x[8] = { 0, 0, -1, 1, -1, 1, -1, 1 };
+const int8_t offset_y[8] = { -1, 1, 0, 0, -1, -1, 1, 1 };
+
+Dijkstra::Dijkstra() : width(0), height(0), next_order(0)
 {
 
 }
@@ -37,128 +44,355 @@ void Dijkstra::build_map(Level *level)
 	if (level == nullptr)
 		return;
 
-	dijkstra_map.clear();
 	auto base_pos = level->get_base_pos();
-	DNode current_node = { base_pos.first, base_pos.second, 0 };
-	std::vector<DNode> unvisited_nodes;
+	std::vector<int32_t> goals;
 
-	// Used for looping all neighbouring nodes
-	const int8_t offset_x[8] = { 0, 0, -1, 1, -1, 1, -1, 1 };
-	const int8_t offset_y[8] = { -1, 1, 0, 0, -1, -1, 1, 1 };
+	if (base_pos.first < level->get_map_width() && base_pos.second < level->get_map_height())
+		goals.push_back(base_pos.second * level->get_map_width() + base_pos.first);
+	build_map(level, goals);
+}
+void Dijkstra::build_map(Level *level, const std::vector<int32_t> &goals)
+{
+	if (level != nullptr)
+		build_from(level, goals);
+}
+void Dijkstra::build_map(const PathGrid *grid, const std::vector<int32_t> &goals)
+{
+	if (grid != nullptr)
+		build_from(grid, goals);
+}
+template <class Map>
+void Dijkstra::build_from(const Map *level, const std::vector<int32_t> &goals)
+{
+	width = level->get_map_width();
+	height = level->get_map_height();
+	distance_map.assign(width * height, DIJKSTRA_UNREACHED);
+	order_map.assign(width * height, 0);
+	direction_map.assign(width * height, DIJKSTRA_STALE);
+	next_order = 0;
+
+	// Every goal starts at zero, the flood then measures the distance to the nearest one.
+	// Goals on walls stay in the list, they only get seeded once the wall is gone.
+	sources = goals;
+	for (int32_t index : sources)
+	{
+		if (index < 0 || index >= width * height || distance_map[index] == 0 || level->get_wall(index % width, index / width))
+			continue;
+		distance_map[index] = 0;
+		push_node(index, 0);
+	}
+	flood(level);
+}
+void Dijkstra::render_map() const
+{
+	for (coord_t y = 0; y < height; y++)
+	{
+		for (coord_t x = 0; x < width; x++)
+		{
+			const dist_t distance = distance_map[y * width + x];
+			if (distance != DIJKSTRA_UNREACHED && camera.get_in_camera_grid(x, y))
+				ui.get_bitmap_font()->render_text(
+					(x * 32) - camera.get_cam_x(),
+					(y * 32) - camera.get_cam_y(), std::to_string(distance)
+				);
+		}
+	}
+}
+void Dijkstra::on_tile_changed(Level *level, coord_t xpos, coord_t ypos)
+{
+	if (level == nullptr || sources.empty() || xpos >= width || ypos >= height)
+		return;
 
-	bool stop_search = false;
-	while (!stop_search)
+	const int32_t index = ypos * width + xpos;
+	if (!level->get_wall(xpos, ypos))
 	{
-		const uint8_t new_distance = current_node.distance + 1;
-		for (uint8_t i = 0; i < 8; i++)
+		// The tile opened up, anything that can now reach a goal through it gets shorter
+		const bool source = std::find(sources.begin(), sources.end(), index) != sources.end();
+		const dist_t best = source ? 0 : get_best_neighbor(level, index);
+		if (best < distance_map[index])
 		{
-			const int8_t new_x = current_node.x + offset_x[i];
-			const int8_t new_y = current_node.y + offset_y[i];
+			distance_map[index] = best;
+			push_node(index, best);
+			flood(level);
+		}
+		return;
+	}
+	if (distance_map[index] == 0)
+	{
+		build_map(level, std::vector<int32_t>(sources));
+		return;
+	}
+	if (distance_map[index] == DIJKSTRA_UNREACHED)
+		return;
 
-			if (level->get_wall(new_x, new_y) ||
-				new_x < 0 || new_x >= level->get_map_width() ||
-				new_y < 0 || new_y >= level->get_map_height())
+	// The tile got blocked, the nodes that led through it have to find another way
+	reflood(level, index);
+}
+void Dijkstra::on_actor_changed(coord_t xpos, coord_t ypos)
+{
+	// Monsters path around each other, so an actor moving in or out of a tile
+	// can change the step of every node next to it
+	if (xpos < width && ypos < height)
+		invalidate_around(xpos, ypos);
+}
+void Dijkstra::add_source(Level *level, coord_t xpos, coord_t ypos)
+{
+	if (level == nullptr || xpos >= width || ypos >= height)
+		return;
+
+	// Only the nodes that end up closer to the new goal get touched
+	const int32_t index = ypos * width + xpos;
+	sources.push_back(index);
+	if (distance_map[index] != 0 && !level->get_wall(xpos, ypos))
+	{
+		distance_map[index] = 0;
+		push_node(index, 0);
+		flood(level);
+	}
+}
+void Dijkstra::remove_source(Level *level, coord_t xpos, coord_t ypos)
+{
+	if (level == nullptr || xpos >= width || ypos >= height)
+		return;
+
+	const int32_t index = ypos * width + xpos;
+	auto it = std::find(sources.begin(), sources.end(), index);
+	if (it == sources.end())
+		return;
+	sources.erase(it);
+
+	// Another goal may still be seeded on the same tile, and one on a wall never was
+	if (distance_map[index] != 0 || std::find(sources.begin(), sources.end(), index) != sources.end())
+		return;
+	reflood(level, index);
+}
+Point Dijkstra::get_node_downhill(Level *level, Point pos)
+{
+	if (level == nullptr || pos.x >= width || pos.y >= height)
+		return Point(pos.x, pos.y);
+
+	uint8_t &direction = direction_map[pos.y * width + pos.x];
+	if (direction == DIJKSTRA_STALE)
+		direction = find_downhill(level, pos);
+
+	if (direction == DIJKSTRA_STAY)
+		return pos;
+	return Point(pos.x + offset_x[direction], pos.y + offset_y[direction]);
+}
+dist_t Dijkstra::get_distance(coord_t xpos, coord_t ypos) const
+{
+	if (xpos >= width || ypos >= height)
+		return DIJKSTRA_UNREACHED;
+	return distance_map[ypos * width + xpos];
+}
+void Dijkstra::push_node(int32_t index, dist_t distance)
+{
+	if (buckets.size() <= distance)
+		buckets.resize(distance + 1);
+	buckets[distance].push_back(index);
+}
+template <class Map>
+void Dijkstra::flood(const Map *level)
+{
+	// Bucket queue, every edge costs one step so each bucket only ever feeds the next one.
+	// Stale entries (the node got a better distance after being queued) are skipped.
+	for (uint32_t d = 0; d < buckets.size(); d++)
+	{
+		for (uint32_t i = 0; i < buckets[d].size(); i++)
+		{
+			const int32_t index = buckets[d][i];
+			if (distance_map[index] != d)
 				continue;
 
-			bool node_exists = false;
-			for (DNode n : unvisited_nodes)
-			{
-				if (n.x == new_x && n.y == new_y)
-				{
-					if (n.distance > new_distance)
-						n.distance = new_distance;
-					node_exists = true;
-					break;
-				}
-			}
-			for (DNode n : dijkstra_map)
+			order_map[index] = next_order++;
+			invalidate_around(index % width, index / width);
+
+			if (d + 1 >= DIJKSTRA_UNREACHED)
+				continue;
+
+			const coord_t x = index % width;
+			const coord_t y = index / width;
+
+			// The map edge counts as wall in the mask, so no bounds checks needed
+			const uint8_t blocked = level->get_wall_mask(x, y);
+			for (uint8_t j = 0; j < 8; j++)
 			{
-				if (n.x == new_x && n.y == new_y)
+				if ((blocked >> j) & 1)
+					continue;
+
+				const int32_t n = (y + offset_y[j]) * width + x + offset_x[j];
+				if (distance_map[n] > d + 1)
 				{
-					node_exists = true;
-					break;
+					distance_map[n] = d + 1;
+					push_node(n, d + 1);
 				}
 			}
-			if (!node_exists)
-			{
-				DNode new_node = { (uint8_t)new_x, (uint8_t)new_y, new_distance };
-				unvisited_nodes.push_back(new_node);
-			}
 		}
-		dijkstra_map.push_back(current_node);
+		buckets[d].clear();
+	}
+}
+template <class Map>
+dist_t Dijkstra::get_best_neighbor(const Map *level, int32_t index) const
+{
+	const coord_t x = index % width;
+	const coord_t y = index / width;
+	dist_t best = DIJKSTRA_UNREACHED;
+
+	const uint8_t blocked = level->get_wall_mask(x, y);
+	for (uint8_t i = 0; i < 8; i++)
+	{
+		if ((blocked >> i) & 1)
+			continue;
 
-		int16_t current_pos = -1;
-		bool found_current_node = false;
+		const dist_t distance = distance_map[(y + offset_y[i]) * width + x + offset_x[i]];
+		if (distance != DIJKSTRA_UNREACHED && distance + 1 < best)
+			best = distance + 1;
+	}
+	return best;
+}
+uint8_t Dijkstra::find_downhill(Level *level, Point pos) const
+{
+	// Gather the reached nodes around us in the order they were settled
+	uint8_t count = 0;
+	int32_t neighbors[9];
 
-		for (DNode n : unvisited_nodes)
+	for (int8_t y = -1; y < 2; y++)
+	{
+		for (int8_t x = -1; x < 2; x++)
 		{
-			current_pos += 1;
-			if (n.x == current_node.x && n.y == current_node.y)
+			const int32_t nx = pos.x + x;
+			const int32_t ny = pos.y + y;
+
+			if (nx < 0 || ny < 0 || nx >= width || ny >= height)
+				continue;
+
+			const int32_t n = ny * width + nx;
+			if (distance_map[n] == DIJKSTRA_UNREACHED)
+				continue;
+
+			uint8_t i = count++;
+			while (i > 0 && order_map[neighbors[i - 1]] > order_map[n])
 			{
-				found_current_node = true;
-				break;
+				neighbors[i] = neighbors[i - 1];
+				i -= 1;
 			}
+			neighbors[i] = n;
 		}
-		if (found_current_node)
-			unvisited_nodes.erase(unvisited_nodes.begin() + current_pos);
+	}
+	int32_t next = -1;
+	dist_t next_dist = DIJKSTRA_UNREACHED;
+	dist_t prev_dist = DIJKSTRA_UNREACHED;
+
+	for (uint8_t i = 0; i < count; i++)
+	{
+		const coord_t nx = neighbors[i] % width;
+		const coord_t ny = neighbors[i] / width;
+		const dist_t distance = distance_map[neighbors[i]];
 
-		uint8_t temp_distance = UINT8_MAX;
-		for (DNode n : unvisited_nodes)
+		if (nx == pos.x && ny == pos.y)
 		{
-			if (n.distance < temp_distance)
+			if (distance > 0)
 			{
-				current_node = n;
-				temp_distance = n.distance;
+				prev_dist = distance;
+				continue;
 			}
+			else return DIJKSTRA_STAY;
 		}
-		if (temp_distance == UINT8_MAX)
-			stop_search = true;
+		Actor *temp_actor = level->get_actor(nx, ny);
+		if (temp_actor != nullptr && temp_actor->get_actor_type() == ACTOR_MONSTER)
+			continue;
+
+		if (distance < next_dist || (distance == next_dist && ny == pos.y))
+		{
+			next = neighbors[i];
+			next_dist = distance;
+		}
+	}
+	if (next == -1 || prev_dist < next_dist)
+		return DIJKSTRA_STAY;
+
+	// Store the step as an index into the offset tables
+	const int32_t dx = (next % width) - pos.x;
+	const int32_t dy = (next / width) - pos.y;
+	for (uint8_t i = 0; i < 8; i++)
+	{
+		if (offset_x[i] == dx && offset_y[i] == dy)
+			return i;
 	}
+	return DIJKSTRA_STAY;
 }
-void Dijkstra::render_map() const
+void Dijkstra::invalidate_around(coord_t xpos, coord_t ypos)
 {
-	for (DNode n : dijkstra_map)
+	for (int8_t y = -1; y < 2; y++)
 	{
-		if (camera.get_in_camera_grid(n.x, n.y))
-			ui.get_bitmap_font()->render_text(
-				(n.x * 32) - camera.get_cam_x(),
-				(n.y * 32) - camera.get_cam_y(), std::to_string(n.distance)
-			);
+		for (int8_t x = -1; x < 2; x++)
+		{
+			const int32_t nx = xpos + x;
+			const int32_t ny = ypos + y;
+
+			if (nx >= 0 && ny >= 0 && nx < width && ny < height)
+				direction_map[ny * width + nx] = DIJKSTRA_STALE;
+		}
 	}
 }
-Point Dijkstra::get_node_downhill(Level *level, Point pos) const
+void Dijkstra::reflood(Level *level, int32_t index)
 {
-	if (level == nullptr)
-		return Point(pos.x, pos.y);
+	// Walk outwards from the node and invalidate every node that no
+	// longer has a neighbour exactly one step closer to a goal
+	affected.clear();
+	affected.push_back(std::make_pair(index, distance_map[index]));
+	distance_map[index] = DIJKSTRA_UNREACHED;
+	invalidate_around(index % width, index / width);
 
-	std::vector<DNode> neighbors;
-	for (DNode n : dijkstra_map)
+	for (uint32_t i = 0; i < affected.size(); i++)
 	{
-		if (std::abs(n.x - pos.x) < 2 && std::abs(n.y - pos.y) < 2)
-			neighbors.push_back(n);
-	}
-	DNode next = { pos.x, pos.y, UINT8_MAX };
-	uint8_t prev_dist = UINT8_MAX;
+		const coord_t ax = affected[i].first % width;
+		const coord_t ay = affected[i].first / width;
+		const dist_t dependent = affected[i].second + 1;
 
-	for (DNode n : neighbors)
-	{
-		if (n.x == pos.x && n.y == pos.y)
+		for (uint8_t j = 0; j < 8; j++)
 		{
-			if (n.distance > 0)
-			{
-				prev_dist = n.distance;
+			const int32_t nx = ax + offset_x[j];
+			const int32_t ny = ay + offset_y[j];
+
+			if (nx < 0 || ny < 0 || nx >= width || ny >= height)
+				continue;
+
+			const int32_t n = ny * width + nx;
+			if (distance_map[n] != dependent)
 				continue;
+
+			bool supported = false;
+			for (uint8_t k = 0; k < 8 && !supported; k++)
+			{
+				const int32_t sx = nx + offset_x[k];
+				const int32_t sy = ny + offset_y[k];
+
+				if (sx >= 0 && sy >= 0 && sx < width && sy < height &&
+					distance_map[sy * width + sx] == dependent - 1 && !level->get_wall(sx, sy))
+					supported = true;
+			}
+			if (!supported)
+			{
+				affected.push_back(std::make_pair(n, dependent));
+				distance_map[n] = DIJKSTRA_UNREACHED;
+				invalidate_around(nx, ny);
 			}
-			else return pos;
 		}
-		Actor *temp_actor = level->get_actor(n.x, n.y);
-		if (temp_actor != nullptr && temp_actor->get_actor_type() == ACTOR_MONSTER)
-			continue;
+	}
+	// Re-seed the invalidated region from its still valid border and let it flood back in,
+	// the starting node too unless it's the wall that caused all this
+	const bool blocked = level->get_wall(index % width, index / width);
+	for (uint32_t i = blocked ? 1 : 0; i < affected.size(); i++)
+	{
+		const int32_t n = affected[i].first;
+		const dist_t best = get_best_neighbor(level, n);
 
-		if (n.distance < next.distance)
-			next = n;
-		else if (n.distance == next.distance && n.y == pos.y)
-			next = n;
+		if (best < distance_map[n])
+		{
+			distance_map[n] = best;
+			push_node(n, best);
+		}
 	}
-	return (prev_dist < next.distance) ? pos : Point(next.x, next.y);
+	flood(level);
 }
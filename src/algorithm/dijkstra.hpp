@@ -18,15 +18,16 @@
 #ifndef DIJKSTRA_HPP
 #define DIJKSTRA_HPP
 
+#include <limits>
 #include <vector>
 
 class Level;
+class PathGrid;
+
+const dist_t DIJKSTRA_UNREACHED = std::numeric_limits<dist_t>::max();
+const uint8_t DIJKSTRA_STAY = 8;
+const uint8_t DIJKSTRA_STALE = UINT8_MAX;
 
-struct DNode
-{
-	uint8_t x, y;
-	uint8_t distance;
-};
 class Dijkstra
 {
 public:
@@ -34,12 +35,41 @@ public:
 	~Dijkstra();
 
 	void build_map(Level *level);
+	void build_map(Level *level, const std::vector<int32_t> &goals);
+	void build_map(const PathGrid *grid, const std::vector<int32_t> &goals);
 	void render_map() const;
 
-	Point get_node_downhill(Level *level, Point pos) const;
+	void on_tile_changed(Level *level, coord_t xpos, coord_t ypos);
+	void on_actor_changed(coord_t xpos, coord_t ypos);
+	void add_source(Level *level, coord_t xpos, coord_t ypos);
+	void remove_source(Level *level, coord_t xpos, coord_t ypos);
+
+	Point get_node_downhill(Level *level, Point pos);
+	dist_t get_distance(coord_t xpos, coord_t ypos) const;
 
 private:
-	std::vector<DNode> dijkstra_map;
+	void push_node(int32_t index, dist_t distance);
+	// Building and flooding only read walls, so maps can be built off a level snapshot
+	template <class Map>
+	void build_from(const Map *level, const std::vector<int32_t> &goals);
+	template <class Map>
+	void flood(const Map *level);
+	template <class Map>
+	dist_t get_best_neighbor(const Map *level, int32_t index) const;
+	uint8_t find_downhill(Level *level, Point pos) const;
+	void invalidate_around(coord_t xpos, coord_t ypos);
+	void reflood(Level *level, int32_t index);
+
+	coord_t width;
+	coord_t height;
+	uint32_t next_order;
+
+	std::vector<dist_t> distance_map;
+	std::vector<int32_t> sources;
+	std::vector<uint32_t> order_map;
+	std::vector<uint8_t> direction_map;
+	std::vector< std::vector<int32_t> > buckets;
+	std::vector< std::pair<int32_t, dist_t> > affected;
 };
 
 #endif // DIJKSTRA_HPP
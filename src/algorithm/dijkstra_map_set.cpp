@@ -0,0 +1,203 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+#include "engine.hpp"
+#include "dijkstra_map_set.hpp"
+#include "dijkstra.hpp"
+#include "level.hpp"
+#include "path_jobs.hpp"
+
+#include "actor.hpp"
+
+DijkstraMapSet::DijkstraMapSet()
+{
+	for (uint8_t i = 0; i < GOAL_COUNT; i++)
+	{
+		maps[i] = nullptr;
+		dirty[i] = true;
+		generation[i] = 0;
+		pending_generation[i] = 0;
+	}
+}
+DijkstraMapSet::~DijkstraMapSet()
+{
+	free();
+}
+void DijkstraMapSet::free()
+{
+	for (uint8_t i = 0; i < GOAL_COUNT; i++)
+	{
+		if (maps[i] != nullptr)
+		{
+			delete maps[i];
+			maps[i] = nullptr;
+		}
+		dirty[i] = true;
+		goals[i].clear();
+		pending[i] = std::future< std::unique_ptr<Dijkstra> >();
+	}
+}
+void DijkstraMapSet::build_maps(Level *level)
+{
+	if (level == nullptr)
+		return;
+
+	for (uint8_t i = 0; i < GOAL_COUNT; i++)
+	{
+		if (maps[i] == nullptr)
+			maps[i] = new Dijkstra;
+		dirty[i] = true;
+	}
+	// The base never moves, so its map is built right away. The actor maps
+	// are only built once somebody asks for them.
+	maps[GOAL_BASE]->build_map(level);
+	dirty[GOAL_BASE] = false;
+}
+void DijkstraMapSet::render_map(DijkstraGoal goal) const
+{
+	if (goal < GOAL_COUNT && maps[goal] != nullptr && !dirty[goal])
+		maps[goal]->render_map();
+}
+void DijkstraMapSet::on_tile_changed(Level *level, coord_t xpos, coord_t ypos)
+{
+	// Dirty maps get rebuilt from scratch anyway, only repair the current ones
+	for (uint8_t i = 0; i < GOAL_COUNT; i++)
+	{
+		generation[i] += 1;
+		if (maps[i] != nullptr && !dirty[i])
+			maps[i]->on_tile_changed(level, xpos, ypos);
+	}
+}
+void DijkstraMapSet::on_actor_changed(Level *level, coord_t xpos, coord_t ypos, const Actor *old_actor, const Actor *new_actor)
+{
+	const DijkstraGoal old_goal = get_actor_goal(old_actor);
+	const DijkstraGoal new_goal = get_actor_goal(new_actor);
+
+	// Built maps only reflood the nodes around the goal that left or arrived,
+	// anything still in flight on the worker was built without it
+	for (uint8_t i = 0; i < GOAL_COUNT; i++)
+	{
+		if (old_goal != new_goal && (i == old_goal || i == new_goal))
+		{
+			generation[i] += 1;
+			if (maps[i] != nullptr && !dirty[i])
+			{
+				if (i == old_goal)
+					maps[i]->remove_source(level, xpos, ypos);
+				else maps[i]->add_source(level, xpos, ypos);
+			}
+		}
+		if (maps[i] != nullptr && !dirty[i])
+			maps[i]->on_actor_changed(xpos, ypos);
+	}
+}
+Dijkstra* DijkstraMapSet::get_map(Level *level, DijkstraGoal goal)
+{
+	if (goal >= GOAL_COUNT || maps[goal] == nullptr)
+		return nullptr;
+
+	if (dirty[goal])
+		refresh_maps(level);
+	return maps[goal];
+}
+Dijkstra* DijkstraMapSet::request_map(Level *level, DijkstraGoal goal)
+{
+	if (level == nullptr || goal >= GOAL_COUNT || maps[goal] == nullptr)
+		return nullptr;
+	if (!dirty[goal])
+		return maps[goal];
+
+	PathJobs *jobs = level->get_path_jobs();
+	if (goal == GOAL_BASE || jobs == nullptr)
+		return get_map(level, goal);
+
+	// Never wait on the worker, callers get nothing until a current map is ready
+	if (pending[goal].valid() && pending[goal].wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+	{
+		std::unique_ptr<Dijkstra> result = pending[goal].get();
+		if (result != nullptr && pending_generation[goal] == generation[goal])
+		{
+			delete maps[goal];
+			maps[goal] = result.release();
+			dirty[goal] = false;
+			return maps[goal];
+		}
+	}
+	// A request for an older generation is replaced, if it's still queued it never gets built
+	if (!pending[goal].valid() || pending_generation[goal] != generation[goal])
+	{
+		pending_generation[goal] = generation[goal];
+		pending[goal] = jobs->request_map(level->get_path_grid(), get_goal_actor(goal), &pending[goal]);
+	}
+	return nullptr;
+}
+void DijkstraMapSet::refresh_maps(Level *level)
+{
+	if (level == nullptr)
+		return;
+
+	// Collect the goals of every outdated map in a single pass over the level
+	for (uint8_t i = GOAL_HERO; i < GOAL_COUNT; i++)
+	{
+		if (dirty[i])
+			goals[i].clear();
+	}
+	const coord_t width = level->get_map_width();
+	const coord_t height = level->get_map_height();
+
+	for (coord_t y = 0; y < height; y++)
+	{
+		for (coord_t x = 0; x < width; x++)
+		{
+			const DijkstraGoal goal = get_actor_goal(level->get_actor(x, y));
+			if (goal != GOAL_COUNT && dirty[goal])
+				goals[goal].push_back(y * width + x);
+		}
+	}
+	for (uint8_t i = 0; i < GOAL_COUNT; i++)
+	{
+		if (!dirty[i] || maps[i] == nullptr)
+			continue;
+
+		if (i == GOAL_BASE)
+			maps[i]->build_map(level);
+		else maps[i]->build_map(level, goals[i]);
+		dirty[i] = false;
+	}
+}
+DijkstraGoal DijkstraMapSet::get_actor_goal(const Actor *actor) const
+{
+	if (actor != nullptr) switch (actor->get_actor_type())
+	{
+		case ACTOR_HERO: return GOAL_HERO;
+		case ACTOR_MOUNT: return GOAL_MOUNT;
+		case ACTOR_PROP: return GOAL_PROP;
+		default: break;
+	}
+	return GOAL_COUNT;
+}
+uint8_t DijkstraMapSet::get_goal_actor(DijkstraGoal goal) const
+{
+	switch (goal)
+	{
+		case GOAL_HERO: return ACTOR_HERO;
+		case GOAL_MOUNT: return ACTOR_MOUNT;
+		case GOAL_PROP: return ACTOR_PROP;
+		default: break;
+	}
+	return ACTOR_NULL;
+}
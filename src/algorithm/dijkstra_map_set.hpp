@@ -0,0 +1,68 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef DIJKSTRA_MAP_SET_HPP
+#define DIJKSTRA_MAP_SET_HPP
+
+#include <future>
+#include <memory>
+#include <vector>
+
+class Actor;
+class Dijkstra;
+class Level;
+
+enum DijkstraGoal
+{
+	GOAL_BASE,
+	GOAL_HERO,
+	GOAL_MOUNT,
+	GOAL_PROP,
+	GOAL_COUNT
+};
+class DijkstraMapSet
+{
+public:
+	DijkstraMapSet();
+	~DijkstraMapSet();
+
+	void free();
+	void build_maps(Level *level);
+	void render_map(DijkstraGoal goal) const;
+
+	void on_tile_changed(Level *level, coord_t xpos, coord_t ypos);
+	void on_actor_changed(Level *level, coord_t xpos, coord_t ypos, const Actor *old_actor, const Actor *new_actor);
+
+	Dijkstra* get_map(Level *level, DijkstraGoal goal);
+	Dijkstra* request_map(Level *level, DijkstraGoal goal);
+
+private:
+	void refresh_maps(Level *level);
+	DijkstraGoal get_actor_goal(const Actor *actor) const;
+	uint8_t get_goal_actor(DijkstraGoal goal) const;
+
+	Dijkstra *maps[GOAL_COUNT];
+	bool dirty[GOAL_COUNT];
+	std::vector<int32_t> goals[GOAL_COUNT];
+
+	// Bumped whenever a map goes out of date, results built from an older snapshot are dropped
+	uint32_t generation[GOAL_COUNT];
+	uint32_t pending_generation[GOAL_COUNT];
+	std::future< std::unique_ptr<Dijkstra> > pending[GOAL_COUNT];
+};
+
+#endif // DIJKSTRA_MAP_SET_HPP
@@ -0,0 +1,82 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+#include "engine.hpp"
+#include "path_cache.hpp"
+
+std::size_t PathCacheHash::operator()(const PathCacheKey &key) const
+{
+	uint64_t hash = ((uint64_t)key.start.x << 48) | ((uint64_t)key.start.y << 32) |
+		((uint64_t)key.end.x << 16) | key.end.y;
+	hash ^= ((uint64_t)key.finder << 9 | (uint64_t)key.mode << 1 | key.exact) * 0x9E3779B97F4A7C15ull;
+	return std::hash<uint64_t>()(hash);
+}
+PathCache::PathCache() : capacity(0), hits(0), misses(0)
+{
+
+}
+PathCache::~PathCache()
+{
+	free();
+}
+void PathCache::init(uint16_t max_entries)
+{
+	free();
+	capacity = max_entries;
+	entries.reserve(capacity);
+}
+void PathCache::free()
+{
+	entries.clear();
+	capacity = 0;
+}
+const PathCacheEntry* PathCache::get_entry(const PathCacheKey &key, uint32_t revision)
+{
+	auto it = entries.find(key);
+	if (it == entries.end() || it->second.revision != revision)
+	{
+		misses += 1;
+		return nullptr;
+	}
+	hits += 1;
+	return &it->second;
+}
+void PathCache::add_entry(const PathCacheKey &key, uint32_t revision, bool found, const std::vector<Point> &path)
+{
+	if (capacity == 0)
+		return;
+
+	if (entries.size() >= capacity && entries.find(key) == entries.end())
+	{
+		// Entries from older revisions can never hit again, drop those first
+		for (auto it = entries.begin(); it != entries.end();)
+		{
+			if (it->second.revision != revision)
+				it = entries.erase(it);
+			else ++it;
+		}
+		if (entries.size() >= capacity)
+			entries.clear();
+	}
+	PathCacheEntry &entry = entries[key];
+	entry.revision = revision;
+	entry.found = found;
+
+	if (found)
+		entry.path = path;
+	else entry.path.clear();
+}
@@ -0,0 +1,75 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef PATH_CACHE_HPP
+#define PATH_CACHE_HPP
+
+#include "path_engine.hpp"
+
+#include <vector>
+#include <unordered_map>
+
+struct PathCacheKey
+{
+	Point start;
+	Point end;
+	uint8_t finder;
+	PathMode mode;
+	bool exact; // False when the cluster graph may have been used, those paths can be a bit longer
+
+	bool operator==(const PathCacheKey &other) const
+	{
+		return start.x == other.start.x && start.y == other.start.y &&
+			end.x == other.end.x && end.y == other.end.y &&
+			finder == other.finder && mode == other.mode && exact == other.exact;
+	}
+};
+struct PathCacheHash
+{
+	std::size_t operator()(const PathCacheKey &key) const;
+};
+struct PathCacheEntry
+{
+	uint32_t revision;
+	bool found;
+	std::vector<Point> path;
+};
+class PathCache
+{
+public:
+	PathCache();
+	~PathCache();
+
+	void init(uint16_t max_entries);
+	void free();
+
+	const PathCacheEntry* get_entry(const PathCacheKey &key, uint32_t revision);
+	void add_entry(const PathCacheKey &key, uint32_t revision, bool found, const std::vector<Point> &path);
+
+	uint32_t get_hits() const { return hits; }
+	uint32_t get_misses() const { return misses; }
+	void reset_counters() { hits = 0; misses = 0; }
+
+private:
+	uint16_t capacity;
+	uint32_t hits;
+	uint32_t misses;
+
+	std::unordered_map<PathCacheKey, PathCacheEntry, PathCacheHash> entries;
+};
+
+#endif // PATH_CACHE_HPP
@@ -0,0 +1,452 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+#include "engine.hpp"
+#include "path_engine.hpp"
+#include "bit_grid.hpp"
+#include "path_grid.hpp"
+#include "level.hpp"
+
+#include <algorithm> // for std::max & std::min
+#include <cstdlib> // for std::abs
+
+PathEngine::PathEngine() : width(0), height(0), generation(0), insert_order(0)
+{
+
+}
+PathEngine::~PathEngine()
+{
+	free();
+}
+void PathEngine::init(coord_t map_width, coord_t map_height)
+{
+	width = map_width;
+	height = map_height;
+
+	// Every node of the map gets a slot up front, so searches never allocate
+	nodes.assign(width * height, { -1, -1, 0, 0, false, 0.0f, 0.0f, 0.0f });
+	open_heap.clear();
+	open_heap.reserve(nodes.size());
+	generation = 0;
+}
+void PathEngine::free()
+{
+	nodes.clear();
+	open_heap.clear();
+	width = 0;
+	height = 0;
+}
+bool PathEngine::find_path(Level *level, Point start, Point end, uint8_t finder, std::vector<Point> &path)
+{
+	return search_grid(level, start, end, finder, path);
+}
+bool PathEngine::find_path(const PathGrid *grid, Point start, Point end, uint8_t finder, std::vector<Point> &path)
+{
+	return search_grid(grid, start, end, finder, path);
+}
+bool PathEngine::find_path_jump(Level *level, Point start, Point end, uint8_t finder, std::vector<Point> &path)
+{
+	return search_jump(level, start, end, finder, path);
+}
+bool PathEngine::find_path_jump(const PathGrid *grid, Point start, Point end, uint8_t finder, std::vector<Point> &path)
+{
+	return search_jump(grid, start, end, finder, path);
+}
+template <class Map>
+bool PathEngine::search_grid(const Map *level, Point start, Point end, uint8_t finder, std::vector<Point> &path)
+{
+	// Make sure we're not trying to path into a wall
+	if (level == nullptr || level->get_wall(end.x, end.y) || (end.x == start.x && end.y == start.y))
+		return false;
+
+	if (width != level->get_map_width() || height != level->get_map_height())
+		init(level->get_map_width(), level->get_map_height());
+	if (start.x >= width || start.y >= height)
+		return false;
+
+	next_generation();
+
+	const int32_t start_index = start.y * width + start.x;
+	PathNode &s = nodes[start_index];
+	s.parent = -1;
+	s.f = 0; s.g = 0; s.h = 0;
+	heap_push(start_index);
+
+	// Best node so far; the goal if we reach it, otherwise whichever node got closest
+	int32_t c = -1;
+
+	// Used for looping all neighbouring nodes
+	const int8_t offset_x[8] = { 0, 0, -1, 1, -1, 1, -1, 1 };
+	const int8_t offset_y[8] = { -1, 1, 0, 0, -1, -1, 1, 1 };
+	const uint8_t max = (finder != 0) ? 8 : 4;
+
+	bool stop_search = false;
+	while (!stop_search && !open_heap.empty())
+	{
+		// Pop the node with the lowest f score (ties go to the oldest node) and close it
+		const int32_t q = heap_pop();
+		nodes[q].closed = true;
+
+		const coord_t q_x = q % width;
+		const coord_t q_y = q / width;
+
+		// One read each for the walls and actors around us instead of a lookup per neighbour
+		const uint8_t blocked = level->get_wall_mask(q_x, q_y);
+		const uint8_t occupied = (finder != 0) ? level->get_actor_mask(q_x, q_y) : 0;
+
+		for (uint8_t i = 0; i < max; i++)
+		{
+			if ((blocked >> i) & 1)
+				continue;
+
+			const int32_t new_x = q_x + offset_x[i];
+			const int32_t new_y = q_y + offset_y[i];
+
+			// Path around anyone with the same ActorType
+			if (((occupied >> i) & 1) && level->get_actor_type(new_x, new_y) == finder)
+				continue;
+			const int32_t index = new_y * width + new_x;
+			PathNode &n = nodes[index];
+			const float new_g = nodes[q].g + (i > 3 ? 1.4f : 1.0f);
+
+			if (n.generation == generation)
+			{
+				// Ignore nodes on the closed list, decrease the key of better open ones
+				if (!n.closed && n.g > new_g)
+				{
+					n.parent = q;
+					n.g = new_g;
+					n.f = n.g + n.h;
+					sift_up(n.heap_index);
+				}
+				continue;
+			}
+			n.generation = generation;
+			n.closed = false;
+			n.parent = q;
+
+			// If we've found the end, stop the search
+			if (new_x == end.x && new_y == end.y)
+			{
+				c = index;
+				stop_search = true;
+				break;
+			}
+			// Heurestics, magic numbers
+			n.g = new_g;
+			n.h = (float)SDL_sqrt((end.x - new_x)*(end.x - new_x) + (end.y - new_y)*(end.y - new_y));
+			n.f = n.g + n.h;
+			heap_push(index);
+
+			if (c == -1 || n.h < nodes[c].h)
+				c = index;
+		}
+	}
+	open_heap.clear();
+
+	if (c == -1)
+		return false;
+
+	// Trace the path back from the last node, leaving out the starting node
+	path.clear();
+	while (c != start_index && c != -1)
+	{
+		path.push_back(Point(c % width, c / width));
+		c = nodes[c].parent;
+	}
+	return true;
+}
+template <class Map>
+bool PathEngine::search_jump(const Map *level, Point start, Point end, uint8_t finder, std::vector<Point> &path)
+{
+	// Jump point search only works with 8-way moves and only ever returns complete paths,
+	// callers fall back to find_path for 4-way searches and the closest node behaviour
+	if (level == nullptr || finder == 0 || level->get_wall(end.x, end.y) || (end.x == start.x && end.y == start.y))
+		return false;
+
+	if (width != level->get_map_width() || height != level->get_map_height())
+		init(level->get_map_width(), level->get_map_height());
+	if (start.x >= width || start.y >= height)
+		return false;
+
+	next_generation();
+
+	const int32_t start_index = start.y * width + start.x;
+	const int32_t end_index = end.y * width + end.x;
+	PathNode &s = nodes[start_index];
+	s.parent = -1;
+	s.f = 0; s.g = 0; s.h = 0;
+	heap_push(start_index);
+
+	bool found = false;
+	while (!open_heap.empty())
+	{
+		const int32_t q = heap_pop();
+		nodes[q].closed = true;
+
+		if (q == end_index)
+		{
+			found = true;
+			break;
+		}
+		const int32_t q_x = q % width;
+		const int32_t q_y = q / width;
+
+		// The start looks everywhere, other jump points only keep going the way they came
+		// plus any neighbour an obstacle next to them forces open
+		int8_t dir_x[8];
+		int8_t dir_y[8];
+		uint8_t count = 0;
+
+		if (nodes[q].parent == -1)
+		{
+			const int8_t offset_x[8] = { 0, 0, -1, 1, -1, 1, -1, 1 };
+			const int8_t offset_y[8] = { -1, 1, 0, 0, -1, -1, 1, 1 };
+			for (count = 0; count < 8; count++)
+			{
+				dir_x[count] = offset_x[count];
+				dir_y[count] = offset_y[count];
+			}
+		}
+		else
+		{
+			const int32_t p_x = nodes[q].parent % width;
+			const int32_t p_y = nodes[q].parent / width;
+			const int8_t dx = (q_x > p_x) ? 1 : ((q_x < p_x) ? -1 : 0);
+			const int8_t dy = (q_y > p_y) ? 1 : ((q_y < p_y) ? -1 : 0);
+
+			if (dx != 0 && dy != 0)
+			{
+				dir_x[count] = 0; dir_y[count++] = dy;
+				dir_x[count] = dx; dir_y[count++] = 0;
+				dir_x[count] = dx; dir_y[count++] = dy;
+				if (get_blocked(level, q_x - dx, q_y, finder)) { dir_x[count] = -dx; dir_y[count++] = dy; }
+				if (get_blocked(level, q_x, q_y - dy, finder)) { dir_x[count] = dx; dir_y[count++] = -dy; }
+			}
+			else if (dx != 0)
+			{
+				dir_x[count] = dx; dir_y[count++] = 0;
+				if (get_blocked(level, q_x, q_y + 1, finder)) { dir_x[count] = dx; dir_y[count++] = 1; }
+				if (get_blocked(level, q_x, q_y - 1, finder)) { dir_x[count] = dx; dir_y[count++] = -1; }
+			}
+			else
+			{
+				dir_x[count] = 0; dir_y[count++] = dy;
+				if (get_blocked(level, q_x + 1, q_y, finder)) { dir_x[count] = 1; dir_y[count++] = dy; }
+				if (get_blocked(level, q_x - 1, q_y, finder)) { dir_x[count] = -1; dir_y[count++] = dy; }
+			}
+		}
+		for (uint8_t i = 0; i < count; i++)
+		{
+			const int32_t index = jump(level, q_x + dir_x[i], q_y + dir_y[i], dir_x[i], dir_y[i], end, finder);
+			if (index != -1)
+				open_jump_point(index, q, end);
+		}
+	}
+	open_heap.clear();
+
+	if (!found)
+		return false;
+
+	// Jump points are joined by straight or diagonal lines, walk them back one tile at a time
+	path.clear();
+	int32_t c = end_index;
+	while (c != start_index)
+	{
+		const int32_t p = nodes[c].parent;
+		int32_t x = c % width;
+		int32_t y = c / width;
+
+		while (x != p % width || y != p / width)
+		{
+			path.push_back(Point(x, y));
+			x += (p % width > x) ? 1 : ((p % width < x) ? -1 : 0);
+			y += (p / width > y) ? 1 : ((p / width < y) ? -1 : 0);
+		}
+		c = p;
+	}
+	return true;
+}
+void PathEngine::next_generation()
+{
+	// Stamps make last search's nodes stale without touching the array,
+	// it only needs wiping when the counter wraps around
+	generation += 1;
+	if (generation == 0)
+	{
+		for (PathNode &n : nodes)
+			n.generation = 0;
+		generation = 1;
+	}
+	insert_order = 0;
+}
+template <class Map>
+bool PathEngine::get_blocked(const Map *level, int32_t xpos, int32_t ypos, uint8_t finder) const
+{
+	// Same rule as find_path, path around anyone with the same ActorType
+	return level->get_wall(xpos, ypos) || level->get_actor_type(xpos, ypos) == finder;
+}
+template <class Map>
+uint8_t PathEngine::get_blocked_mask(const Map *level, int32_t xpos, int32_t ypos, uint8_t finder) const
+{
+	const int8_t offset_x[8] = { 0, 0, -1, 1, -1, 1, -1, 1 };
+	const int8_t offset_y[8] = { -1, 1, 0, 0, -1, -1, 1, 1 };
+
+	// Walls come straight from the mask, only occupied neighbours need their ActorType checked
+	uint8_t blocked = level->get_wall_mask(xpos, ypos);
+	const uint8_t occupied = level->get_actor_mask(xpos, ypos) & ~blocked;
+
+	for (uint8_t i = 0; i < 8; i++)
+	{
+		if (((occupied >> i) & 1) && level->get_actor_type(xpos + offset_x[i], ypos + offset_y[i]) == finder)
+			blocked |= 1 << i;
+	}
+	return blocked;
+}
+template <class Map>
+int32_t PathEngine::jump(const Map *level, int32_t xpos, int32_t ypos, int8_t dx, int8_t dy, Point end, uint8_t finder) const
+{
+	if (get_blocked(level, xpos, ypos, finder))
+		return -1;
+
+	// Keep stepping the same way until we hit the goal, a forced neighbour (an obstacle
+	// beside us that just opened up) or, when moving diagonally, a straight jump that finds one
+	while (true)
+	{
+		const int32_t index = ypos * width + xpos;
+		if (xpos == end.x && ypos == end.y)
+			return index;
+
+		const uint8_t blocked = get_blocked_mask(level, xpos, ypos, finder);
+		if (dx != 0 && dy != 0)
+		{
+			if ((get_neighbor_bit(blocked, -dx, 0) && !get_neighbor_bit(blocked, -dx, dy)) ||
+				(get_neighbor_bit(blocked, 0, -dy) && !get_neighbor_bit(blocked, dx, -dy)))
+				return index;
+			if (jump(level, xpos + dx, ypos, dx, 0, end, finder) != -1 ||
+				jump(level, xpos, ypos + dy, 0, dy, end, finder) != -1)
+				return index;
+		}
+		else if (dx != 0)
+		{
+			if ((get_neighbor_bit(blocked, 0, 1) && !get_neighbor_bit(blocked, dx, 1)) ||
+				(get_neighbor_bit(blocked, 0, -1) && !get_neighbor_bit(blocked, dx, -1)))
+				return index;
+		}
+		else
+		{
+			if ((get_neighbor_bit(blocked, 1, 0) && !get_neighbor_bit(blocked, 1, dy)) ||
+				(get_neighbor_bit(blocked, -1, 0) && !get_neighbor_bit(blocked, -1, dy)))
+				return index;
+		}
+		if (get_neighbor_bit(blocked, dx, dy))
+			return -1;
+
+		xpos += dx;
+		ypos += dy;
+	}
+}
+void PathEngine::open_jump_point(int32_t index, int32_t parent, Point end)
+{
+	// Octile distances, the same 1.0 / 1.4 step costs find_path uses
+	const int32_t jump_x = std::abs(index % width - parent % width);
+	const int32_t jump_y = std::abs(index / width - parent / width);
+	const float new_g = nodes[parent].g + std::max(jump_x, jump_y) + 0.4f * std::min(jump_x, jump_y);
+
+	PathNode &n = nodes[index];
+	if (n.generation == generation)
+	{
+		if (!n.closed && n.g > new_g)
+		{
+			n.parent = parent;
+			n.g = new_g;
+			n.f = n.g + n.h;
+			sift_up(n.heap_index);
+		}
+		return;
+	}
+	const int32_t goal_x = std::abs(index % width - end.x);
+	const int32_t goal_y = std::abs(index / width - end.y);
+
+	n.parent = parent;
+	n.g = new_g;
+	n.h = std::max(goal_x, goal_y) + 0.4f * std::min(goal_x, goal_y);
+	n.f = n.g + n.h;
+	heap_push(index);
+}
+bool PathEngine::heap_less(int32_t a, int32_t b) const
+{
+	if (nodes[a].f != nodes[b].f)
+		return nodes[a].f < nodes[b].f;
+	return nodes[a].order < nodes[b].order;
+}
+void PathEngine::heap_push(int32_t node)
+{
+	nodes[node].generation = generation;
+	nodes[node].closed = false;
+	nodes[node].order = insert_order++;
+	nodes[node].heap_index = open_heap.size();
+	open_heap.push_back(node);
+	sift_up(open_heap.size() - 1);
+}
+int32_t PathEngine::heap_pop()
+{
+	const int32_t top = open_heap[0];
+	open_heap[0] = open_heap.back();
+	nodes[open_heap[0]].heap_index = 0;
+	open_heap.pop_back();
+
+	if (!open_heap.empty())
+		sift_down(0);
+	nodes[top].heap_index = -1;
+	return top;
+}
+void PathEngine::sift_up(uint32_t pos)
+{
+	const int32_t node = open_heap[pos];
+	while (pos > 0)
+	{
+		const uint32_t up = (pos - 1) / 2;
+		if (!heap_less(node, open_heap[up]))
+			break;
+		open_heap[pos] = open_heap[up];
+		nodes[open_heap[pos]].heap_index = pos;
+		pos = up;
+	}
+	open_heap[pos] = node;
+	nodes[node].heap_index = pos;
+}
+void PathEngine::sift_down(uint32_t pos)
+{
+	const int32_t node = open_heap[pos];
+	const uint32_t size = open_heap.size();
+	while (true)
+	{
+		uint32_t down = pos * 2 + 1;
+		if (down >= size)
+			break;
+		if (down + 1 < size && heap_less(open_heap[down + 1], open_heap[down]))
+			down += 1;
+		if (!heap_less(open_heap[down], node))
+			break;
+		open_heap[pos] = open_heap[down];
+		nodes[open_heap[pos]].heap_index = pos;
+		pos = down;
+	}
+	open_heap[pos] = node;
+	nodes[node].heap_index = pos;
+}
@@ -0,0 +1,86 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef PATH_ENGINE_HPP
+#define PATH_ENGINE_HPP
+
+#include <vector>
+
+class Level;
+class PathGrid;
+
+// Only PATH_CLUSTER lets long trips go over the cluster graph, its paths can come out a bit longer
+enum PathMode
+{
+	PATH_GRID,
+	PATH_JUMP,
+	PATH_CLUSTER
+};
+struct PathNode
+{
+	int32_t parent;
+	int32_t heap_index;
+	uint32_t order;
+	uint16_t generation;
+	bool closed;
+	float f, g, h;
+};
+class PathEngine
+{
+public:
+	PathEngine();
+	~PathEngine();
+
+	void init(coord_t width, coord_t height);
+	void free();
+
+	bool find_path(Level *level, Point start, Point end, uint8_t finder, std::vector<Point> &path);
+	bool find_path(const PathGrid *grid, Point start, Point end, uint8_t finder, std::vector<Point> &path);
+	bool find_path_jump(Level *level, Point start, Point end, uint8_t finder, std::vector<Point> &path);
+	bool find_path_jump(const PathGrid *grid, Point start, Point end, uint8_t finder, std::vector<Point> &path);
+
+private:
+	// The searches only read walls and actor types, so they run on the level or on a snapshot of it
+	template <class Map>
+	bool search_grid(const Map *level, Point start, Point end, uint8_t finder, std::vector<Point> &path);
+	template <class Map>
+	bool search_jump(const Map *level, Point start, Point end, uint8_t finder, std::vector<Point> &path);
+	template <class Map>
+	bool get_blocked(const Map *level, int32_t xpos, int32_t ypos, uint8_t finder) const;
+	template <class Map>
+	uint8_t get_blocked_mask(const Map *level, int32_t xpos, int32_t ypos, uint8_t finder) const;
+	template <class Map>
+	int32_t jump(const Map *level, int32_t xpos, int32_t ypos, int8_t dx, int8_t dy, Point end, uint8_t finder) const;
+
+	void next_generation();
+	void open_jump_point(int32_t index, int32_t parent, Point end);
+	bool heap_less(int32_t a, int32_t b) const;
+	void heap_push(int32_t node);
+	int32_t heap_pop();
+	void sift_up(uint32_t pos);
+	void sift_down(uint32_t pos);
+
+	coord_t width;
+	coord_t height;
+	uint16_t generation;
+	uint32_t insert_order;
+
+	std::vector<PathNode> nodes;
+	std::vector<int32_t> open_heap;
+};
+
+#endif // PATH_ENGINE_HPP
@@ -0,0 +1,103 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+#include "engine.hpp"
+#include "path_grid.hpp"
+#include "level.hpp"
+#include "level_file.hpp"
+
+#include "actor.hpp"
+
+PathGrid::PathGrid() : width(0), height(0), revision(0)
+{
+
+}
+PathGrid::~PathGrid()
+{
+	free();
+}
+void PathGrid::init(const Level *level)
+{
+	free();
+	if (level == nullptr)
+		return;
+
+	width = level->get_map_width();
+	height = level->get_map_height();
+	revision = level->get_map_revision();
+
+	// Copy out everything a search reads, the worker thread never touches the level itself
+	walls = level->get_wall_grid();
+	actors = level->get_actor_grid();
+	actor_types.assign(width * height, ACTOR_NULL);
+
+	for (coord_t y = 0; y < height; y++)
+	{
+		for (coord_t x = 0; x < width; x++)
+		{
+			if (actors.get(x, y))
+				actor_types[y * width + x] = level->get_actor_type(x, y);
+		}
+	}
+}
+void PathGrid::init(const LevelWriter &writer)
+{
+	free();
+	width = writer.get_width();
+	height = writer.get_height();
+
+	// A level that was only generated has walls and nothing else, nobody is standing in the way yet
+	walls.init(width, height, true);
+	actors.init(width, height, false);
+	actor_types.assign(width * height, ACTOR_NULL);
+
+	for (coord_t y = 0; y < height; y++)
+	{
+		for (coord_t x = 0; x < width; x++)
+			walls.set(x, y, writer.get_wall_key(x, y) != '_');
+	}
+}
+void PathGrid::free()
+{
+	walls.free();
+	actors.free();
+	actor_types.clear();
+	width = 0;
+	height = 0;
+}
+uint8_t PathGrid::get_actor_type(coord_t xpos, coord_t ypos) const
+{
+	if (xpos >= width || ypos >= height)
+		return ACTOR_NULL;
+	return actor_types[ypos * width + xpos];
+}
+void PathGrid::set_actor_type(coord_t xpos, coord_t ypos, uint8_t actor_type)
+{
+	if (xpos >= width || ypos >= height)
+		return;
+	actor_types[ypos * width + xpos] = actor_type;
+	actors.set(xpos, ypos, actor_type != ACTOR_NULL);
+}
+void PathGrid::get_actor_indices(uint8_t actor_type, std::vector<int32_t> &indices) const
+{
+	indices.clear();
+	for (uint32_t i = 0; i < actor_types.size(); i++)
+	{
+		if (actor_types[i] == actor_type)
+			indices.push_back(i);
+	}
+}
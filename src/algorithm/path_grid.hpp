@@ -0,0 +1,61 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef PATH_GRID_HPP
+#define PATH_GRID_HPP
+
+#include "bit_grid.hpp"
+
+#include <vector>
+
+class Level;
+class LevelWriter;
+
+class PathGrid
+{
+public:
+	PathGrid();
+	~PathGrid();
+
+	void init(const Level *level);
+	void init(const LevelWriter &writer);
+	void free();
+
+	bool get_wall(int32_t xpos, int32_t ypos) const { return walls.get(xpos, ypos); }
+	uint8_t get_wall_mask(int32_t xpos, int32_t ypos) const { return walls.get_neighbors(xpos, ypos); }
+	uint8_t get_actor_mask(int32_t xpos, int32_t ypos) const { return actors.get_neighbors(xpos, ypos); }
+	uint8_t get_actor_type(coord_t xpos, coord_t ypos) const;
+	void get_actor_indices(uint8_t actor_type, std::vector<int32_t> &indices) const;
+
+	// Stands an actor of the given type (ACTOR_NULL to clear) on a grid that has none of its own yet
+	void set_actor_type(coord_t xpos, coord_t ypos, uint8_t actor_type);
+
+	coord_t get_map_width() const { return width; }
+	coord_t get_map_height() const { return height; }
+	uint32_t get_revision() const { return revision; }
+
+private:
+	coord_t width;
+	coord_t height;
+	uint32_t revision;
+
+	BitGrid walls;
+	BitGrid actors;
+	std::vector<uint8_t> actor_types;
+};
+
+#endif // PATH_GRID_HPP
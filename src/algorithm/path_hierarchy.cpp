@@ -0,0 +1,368 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+#include "engine.hpp"
+#include "path_hierarchy.hpp"
+#include "path_engine.hpp"
+#include "level.hpp"
+
+#include <algorithm> // for std::push_heap & std::pop_heap
+#include <functional> // for std::greater
+
+// Used for looping all neighbouring nodes
+const int8_t offset_x[8] = { 0, 0, -1, 1, -1, 1, -1, 1 };
+const int8_t offset_y[8] = { -1, 1, 0, 0, -1, -1, 1, 1 };
+
+PathHierarchy::PathHierarchy() : width(0), height(0), clusters_x(0), clusters_y(0), generation(0)
+{
+
+}
+PathHierarchy::~PathHierarchy()
+{
+	free();
+}
+void PathHierarchy::build(Level *level)
+{
+	free();
+	if (level == nullptr)
+		return;
+
+	width = level->get_map_width();
+	height = level->get_map_height();
+	clusters_x = (width + PATH_CLUSTER_SIZE - 1) / PATH_CLUSTER_SIZE;
+	clusters_y = (height + PATH_CLUSTER_SIZE - 1) / PATH_CLUSTER_SIZE;
+	clusters.resize(clusters_x * clusters_y);
+
+	for (uint32_t i = 0; i < clusters.size(); i++)
+	{
+		PathCluster &c = clusters[i];
+		c.x = (i % clusters_x) * PATH_CLUSTER_SIZE;
+		c.y = (i / clusters_x) * PATH_CLUSTER_SIZE;
+		c.w = std::min<coord_t>(PATH_CLUSTER_SIZE, width - c.x);
+		c.h = std::min<coord_t>(PATH_CLUSTER_SIZE, height - c.y);
+	}
+	for (uint32_t i = 0; i < clusters.size(); i++)
+		rebuild_cluster(level, i);
+
+	nodes.assign(clusters.size() * PATH_CLUSTER_NODES, { -1, 0, false, 0.0f, 0.0f });
+	generation = 0;
+}
+void PathHierarchy::free()
+{
+	clusters.clear();
+	nodes.clear();
+	open_heap.clear();
+	width = 0; height = 0;
+	clusters_x = 0; clusters_y = 0;
+}
+void PathHierarchy::on_tile_changed(Level *level, coord_t xpos, coord_t ypos)
+{
+	if (level == nullptr || clusters.empty() || xpos >= width || ypos >= height)
+		return;
+
+	const uint32_t cluster = get_cluster(xpos, ypos);
+	const PathCluster &c = clusters[cluster];
+	rebuild_cluster(level, cluster);
+
+	// Entrances are shared with the cluster across the border, refresh that side too
+	if (xpos == c.x && c.x > 0)
+		rebuild_cluster(level, cluster - 1);
+	if (xpos == c.x + c.w - 1 && c.x + c.w < width)
+		rebuild_cluster(level, cluster + 1);
+	if (ypos == c.y && c.y > 0)
+		rebuild_cluster(level, cluster - clusters_x);
+	if (ypos == c.y + c.h - 1 && c.y + c.h < height)
+		rebuild_cluster(level, cluster + clusters_x);
+}
+bool PathHierarchy::find_path(Level *level, Point start, Point end, uint8_t finder, std::vector<Point> &path)
+{
+	// The abstract graph assumes diagonal moves, 4-way searches stay on the plain grid
+	if (level == nullptr || level->get_path_engine() == nullptr || finder == 0 || clusters.empty())
+		return false;
+	if (start.x >= width || start.y >= height || end.x >= width || end.y >= height || level->get_wall(end.x, end.y))
+		return false;
+
+	const coord_t dx = (start.x > end.x) ? start.x - end.x : end.x - start.x;
+	const coord_t dy = (start.y > end.y) ? start.y - end.y : end.y - start.y;
+	if (dx < PATH_HIERARCHY_MIN_DISTANCE && dy < PATH_HIERARCHY_MIN_DISTANCE)
+		return false;
+
+	const uint32_t start_cluster = get_cluster(start.x, start.y);
+	const uint32_t end_cluster = get_cluster(end.x, end.y);
+
+	// Cost from each entrance of the goal's cluster to the goal itself
+	const PathCluster &goal_c = clusters[end_cluster];
+	flood_cluster(level, goal_c, end, flood_costs);
+	goal_costs.resize(goal_c.entrances.size());
+	for (uint16_t i = 0; i < goal_c.entrances.size(); i++)
+	{
+		const Point &e = goal_c.entrances[i];
+		goal_costs[i] = flood_costs[(e.y - goal_c.y) * goal_c.w + (e.x - goal_c.x)];
+	}
+	next_generation();
+	open_heap.clear();
+
+	// Seed the search with every entrance the start can reach inside its own cluster
+	const PathCluster &start_c = clusters[start_cluster];
+	flood_cluster(level, start_c, start, flood_costs);
+	for (uint16_t i = 0; i < start_c.entrances.size(); i++)
+	{
+		const Point &e = start_c.entrances[i];
+		const float cost = flood_costs[(e.y - start_c.y) * start_c.w + (e.x - start_c.x)];
+		if (cost >= 0.0f)
+			open_node(start_cluster * PATH_CLUSTER_NODES + i, cost, -1, end);
+	}
+	int32_t best = -1;
+	float best_cost = 0.0f;
+
+	while (!open_heap.empty())
+	{
+		std::pop_heap(open_heap.begin(), open_heap.end(), std::greater< std::pair<float, int32_t> >());
+		const std::pair<float, int32_t> top = open_heap.back();
+		open_heap.pop_back();
+
+		PathAbstractNode &q = nodes[top.second];
+		if (q.closed || top.first != q.f)
+			continue;
+		if (best != -1 && q.f >= best_cost)
+			break;
+		q.closed = true;
+
+		const uint32_t cluster = top.second / PATH_CLUSTER_NODES;
+		const uint16_t index = top.second % PATH_CLUSTER_NODES;
+		const PathCluster &c = clusters[cluster];
+		const Point pos = c.entrances[index];
+
+		if (cluster == end_cluster && goal_costs[index] >= 0.0f &&
+			(best == -1 || q.g + goal_costs[index] < best_cost))
+		{
+			best = top.second;
+			best_cost = q.g + goal_costs[index];
+		}
+		// Edges to the other entrances of this cluster
+		const uint16_t count = c.entrances.size();
+		for (uint16_t i = 0; i < count; i++)
+		{
+			const float cost = c.costs[index * count + i];
+			if (i != index && cost >= 0.0f)
+				open_node(cluster * PATH_CLUSTER_NODES + i, q.g + cost, top.second, end);
+		}
+		// And a single step across any cluster border we're standing on
+		for (uint8_t i = 0; i < 4; i++)
+		{
+			const int32_t new_x = pos.x + offset_x[i];
+			const int32_t new_y = pos.y + offset_y[i];
+
+			if (new_x < 0 || new_y < 0 || new_x >= width || new_y >= height)
+				continue;
+
+			const uint32_t other = get_cluster(new_x, new_y);
+			if (other == cluster)
+				continue;
+
+			const int32_t entrance = find_entrance(other, Point(new_x, new_y));
+			if (entrance != -1)
+				open_node(other * PATH_CLUSTER_NODES + entrance, q.g + 1.0f, top.second, end);
+		}
+	}
+	open_heap.clear();
+	if (best == -1)
+		return false;
+
+	// Waypoints go goal first, like the paths themselves
+	waypoints.clear();
+	waypoints.push_back(end);
+	for (int32_t n = best; n != -1; n = nodes[n].parent)
+		waypoints.push_back(clusters[n / PATH_CLUSTER_NODES].entrances[n % PATH_CLUSTER_NODES]);
+	waypoints.push_back(start);
+
+	// Refine each leg with the regular search, none of them leave a cluster or two
+	PathEngine *path_engine = level->get_path_engine();
+	refined.clear();
+
+	for (uint32_t i = 1; i < waypoints.size(); i++)
+	{
+		const Point &from = waypoints[i];
+		const Point &to = waypoints[i - 1];
+
+		if (from.x == to.x && from.y == to.y)
+			continue;
+		if (!path_engine->find_path(level, from, to, finder, segment) ||
+			segment.front().x != to.x || segment.front().y != to.y)
+			return false;
+		refined.insert(refined.end(), segment.begin(), segment.end());
+	}
+	if (refined.empty())
+		return false;
+
+	path.swap(refined);
+	return true;
+}
+void PathHierarchy::rebuild_cluster(Level *level, uint32_t cluster)
+{
+	PathCluster &c = clusters[cluster];
+	c.entrances.clear();
+
+	if (c.y > 0)
+		add_entrances(level, c, Point(c.x, c.y), 1, 0, 0, -1, c.w);
+	if (c.y + c.h < height)
+		add_entrances(level, c, Point(c.x, c.y + c.h - 1), 1, 0, 0, 1, c.w);
+	if (c.x > 0)
+		add_entrances(level, c, Point(c.x, c.y), 0, 1, -1, 0, c.h);
+	if (c.x + c.w < width)
+		add_entrances(level, c, Point(c.x + c.w - 1, c.y), 0, 1, 1, 0, c.h);
+
+	// Walking costs between every pair of entrances, without leaving the cluster
+	const uint16_t count = c.entrances.size();
+	c.costs.assign(count * count, -1.0f);
+
+	for (uint16_t i = 0; i < count; i++)
+	{
+		flood_cluster(level, c, c.entrances[i], flood_costs);
+		for (uint16_t j = 0; j < count; j++)
+			c.costs[i * count + j] = flood_costs[(c.entrances[j].y - c.y) * c.w + (c.entrances[j].x - c.x)];
+	}
+}
+void PathHierarchy::add_entrances(Level *level, PathCluster &c, Point first, int8_t step_x, int8_t step_y, int8_t out_x, int8_t out_y, coord_t length)
+{
+	// Walk along one border, every run of tiles open on both sides becomes a transition.
+	// Short runs get a single entrance in the middle, longer ones one at each end.
+	// The cluster on the other side walks the same tiles, so both pick identical spots.
+	coord_t run_start = 0;
+	bool in_run = false;
+
+	for (coord_t i = 0; i <= length; i++)
+	{
+		const int32_t x = first.x + step_x * i;
+		const int32_t y = first.y + step_y * i;
+		const bool open = (i < length && !level->get_wall(x, y) && !level->get_wall(x + out_x, y + out_y));
+
+		if (open && !in_run)
+		{
+			run_start = i;
+			in_run = true;
+		}
+		else if (!open && in_run)
+		{
+			const coord_t run_length = i - run_start;
+			const coord_t picks[2] = { run_start, (coord_t)(i - 1) };
+			const uint8_t pick_count = (run_length < 6) ? 1 : 2;
+
+			for (uint8_t j = 0; j < pick_count; j++)
+			{
+				const coord_t p = (pick_count == 1) ? run_start + (run_length - 1) / 2 : picks[j];
+				const Point pos(first.x + step_x * p, first.y + step_y * p);
+				bool exists = false;
+				for (const Point &e : c.entrances)
+				{
+					if (e.x == pos.x && e.y == pos.y)
+						exists = true;
+				}
+				if (!exists && c.entrances.size() < PATH_CLUSTER_NODES)
+					c.entrances.push_back(pos);
+			}
+			in_run = false;
+		}
+	}
+}
+void PathHierarchy::flood_cluster(Level *level, const PathCluster &c, Point from, std::vector<float> &costs)
+{
+	costs.assign(c.w * c.h, -1.0f);
+	flood_heap.clear();
+
+	const int32_t first = (from.y - c.y) * c.w + (from.x - c.x);
+	costs[first] = 0.0f;
+	flood_heap.push_back(std::make_pair(0.0f, first));
+
+	while (!flood_heap.empty())
+	{
+		std::pop_heap(flood_heap.begin(), flood_heap.end(), std::greater< std::pair<float, int32_t> >());
+		const std::pair<float, int32_t> top = flood_heap.back();
+		flood_heap.pop_back();
+
+		if (top.first > costs[top.second])
+			continue;
+
+		const coord_t x = c.x + top.second % c.w;
+		const coord_t y = c.y + top.second / c.w;
+
+		for (uint8_t i = 0; i < 8; i++)
+		{
+			const int32_t new_x = x + offset_x[i];
+			const int32_t new_y = y + offset_y[i];
+
+			if (new_x < c.x || new_y < c.y || new_x >= c.x + c.w || new_y >= c.y + c.h ||
+				level->get_wall(new_x, new_y))
+				continue;
+
+			const int32_t n = (new_y - c.y) * c.w + (new_x - c.x);
+			const float cost = top.first + (i > 3 ? 1.4f : 1.0f);
+			if (costs[n] < 0.0f || cost < costs[n])
+			{
+				costs[n] = cost;
+				flood_heap.push_back(std::make_pair(cost, n));
+				std::push_heap(flood_heap.begin(), flood_heap.end(), std::greater< std::pair<float, int32_t> >());
+			}
+		}
+	}
+}
+void PathHierarchy::open_node(int32_t node, float g, int32_t parent, Point goal)
+{
+	PathAbstractNode &n = nodes[node];
+	if (n.generation == generation && (n.closed || n.g <= g))
+		return;
+
+	n.generation = generation;
+	n.closed = false;
+	n.parent = parent;
+	n.g = g;
+	n.f = g + get_estimate(clusters[node / PATH_CLUSTER_NODES].entrances[node % PATH_CLUSTER_NODES], goal);
+
+	open_heap.push_back(std::make_pair(n.f, node));
+	std::push_heap(open_heap.begin(), open_heap.end(), std::greater< std::pair<float, int32_t> >());
+}
+void PathHierarchy::next_generation()
+{
+	generation += 1;
+	if (generation == 0)
+	{
+		for (PathAbstractNode &n : nodes)
+			n.generation = 0;
+		generation = 1;
+	}
+}
+int32_t PathHierarchy::find_entrance(uint32_t cluster, Point pos) const
+{
+	const PathCluster &c = clusters[cluster];
+	for (uint16_t i = 0; i < c.entrances.size(); i++)
+	{
+		if (c.entrances[i].x == pos.x && c.entrances[i].y == pos.y)
+			return i;
+	}
+	return -1;
+}
+uint32_t PathHierarchy::get_cluster(coord_t xpos, coord_t ypos) const
+{
+	return (ypos / PATH_CLUSTER_SIZE) * clusters_x + (xpos / PATH_CLUSTER_SIZE);
+}
+float PathHierarchy::get_estimate(Point a, Point b) const
+{
+	// Octile distance, matches the 1.0 / 1.4 step costs of the grid search
+	const float dx = (a.x > b.x) ? a.x - b.x : b.x - a.x;
+	const float dy = (a.y > b.y) ? a.y - b.y : b.y - a.y;
+	return (dx > dy) ? dx + 0.4f * dy : dy + 0.4f * dx;
+}
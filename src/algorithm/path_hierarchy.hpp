@@ -0,0 +1,84 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef PATH_HIERARCHY_HPP
+#define PATH_HIERARCHY_HPP
+
+#include <vector>
+
+class Level;
+
+const coord_t PATH_CLUSTER_SIZE = 16;
+const uint16_t PATH_CLUSTER_NODES = PATH_CLUSTER_SIZE * 4;
+
+// Trips shorter than this (on either axis) are cheaper to search on the plain grid
+const coord_t PATH_HIERARCHY_MIN_DISTANCE = PATH_CLUSTER_SIZE * 2;
+
+struct PathCluster
+{
+	coord_t x, y, w, h;
+	std::vector<Point> entrances;
+	std::vector<float> costs; // Entrance to entrance, negative when unreachable
+};
+struct PathAbstractNode
+{
+	int32_t parent;
+	uint16_t generation;
+	bool closed;
+	float g, f;
+};
+class PathHierarchy
+{
+public:
+	PathHierarchy();
+	~PathHierarchy();
+
+	void build(Level *level);
+	void free();
+
+	void on_tile_changed(Level *level, coord_t xpos, coord_t ypos);
+	bool find_path(Level *level, Point start, Point end, uint8_t finder, std::vector<Point> &path);
+
+private:
+	void rebuild_cluster(Level *level, uint32_t cluster);
+	void add_entrances(Level *level, PathCluster &c, Point first, int8_t step_x, int8_t step_y, int8_t out_x, int8_t out_y, coord_t length);
+	void flood_cluster(Level *level, const PathCluster &c, Point from, std::vector<float> &costs);
+	void open_node(int32_t node, float g, int32_t parent, Point goal);
+	void next_generation();
+
+	int32_t find_entrance(uint32_t cluster, Point pos) const;
+	uint32_t get_cluster(coord_t xpos, coord_t ypos) const;
+	float get_estimate(Point a, Point b) const;
+
+	coord_t width;
+	coord_t height;
+	coord_t clusters_x;
+	coord_t clusters_y;
+	uint16_t generation;
+
+	std::vector<PathCluster> clusters;
+	std::vector<PathAbstractNode> nodes;
+	std::vector< std::pair<float, int32_t> > open_heap;
+	std::vector< std::pair<float, int32_t> > flood_heap;
+	std::vector<float> flood_costs;
+	std::vector<float> goal_costs;
+	std::vector<Point> waypoints;
+	std::vector<Point> segment;
+	std::vector<Point> refined;
+};
+
+#endif // PATH_HIERARCHY_HPP
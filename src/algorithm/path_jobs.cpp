@@ -0,0 +1,141 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+#include "engine.hpp"
+#include "path_jobs.hpp"
+#include "path_grid.hpp"
+
+PathJobs::PathJobs() : running(false), stopping(false)
+{
+
+}
+PathJobs::~PathJobs()
+{
+	free();
+}
+void PathJobs::init()
+{
+	if (running)
+		return;
+
+	stopping = false;
+	running = true;
+	worker = std::thread(&PathJobs::run, this);
+}
+void PathJobs::free()
+{
+	if (!running)
+		return;
+
+	std::deque<PathJob> dropped;
+	{
+		std::lock_guard<std::mutex> lock(job_mutex);
+		stopping = true;
+		dropped.swap(jobs);
+	}
+	job_ready.notify_one();
+	worker.join();
+	running = false;
+	path_engine.free();
+
+	// Nothing left in the queue is searched, but every future still gets an (empty) answer
+	for (PathJob &job : dropped)
+		job.run(false);
+}
+std::future<PathJobResult> PathJobs::request_path(std::shared_ptr<const PathGrid> grid, Point start, Point end, uint8_t finder, PathMode mode, const void *owner)
+{
+	auto task = std::make_shared< std::packaged_task<PathJobResult(bool)> >([this, grid, start, end, finder, mode](bool search)
+	{
+		PathJobResult result = { false, !search, grid->get_revision() };
+		if (!search)
+			return result;
+
+		// Same order as AStar::find_path, minus the cluster graph which lives on the main thread
+		result.found =
+			(mode == PATH_JUMP && path_engine.find_path_jump(grid.get(), start, end, finder, result.path)) ||
+			path_engine.find_path(grid.get(), start, end, finder, result.path);
+		return result;
+	});
+	std::future<PathJobResult> result = task->get_future();
+	push_job(owner, [task](bool search) { (*task)(search); });
+	return result;
+}
+std::future< std::unique_ptr<Dijkstra> > PathJobs::request_map(std::shared_ptr<const PathGrid> grid, uint8_t goal_type, const void *owner)
+{
+	auto task = std::make_shared< std::packaged_task<std::unique_ptr<Dijkstra>(bool)> >([grid, goal_type](bool search)
+	{
+		if (!search)
+			return std::unique_ptr<Dijkstra>();
+
+		std::vector<int32_t> goals;
+		grid->get_actor_indices(goal_type, goals);
+
+		std::unique_ptr<Dijkstra> map(new Dijkstra);
+		map->build_map(grid.get(), goals);
+		return map;
+	});
+	std::future< std::unique_ptr<Dijkstra> > result = task->get_future();
+	push_job(owner, [task](bool search) { (*task)(search); });
+	return result;
+}
+void PathJobs::push_job(const void *owner, std::function<void(bool)> job)
+{
+	if (!running)
+	{
+		// No worker to hand it to, just run it here
+		job(true);
+		return;
+	}
+	std::function<void(bool)> superseded;
+	{
+		std::lock_guard<std::mutex> lock(job_mutex);
+
+		// There's never more than one queued job per owner, so the first match is the only one
+		if (owner != nullptr) for (auto it = jobs.begin(); it != jobs.end(); ++it)
+		{
+			if (it->owner == owner)
+			{
+				superseded = std::move(it->run);
+				jobs.erase(it);
+				break;
+			}
+		}
+		jobs.push_back({ owner, std::move(job) });
+	}
+	job_ready.notify_one();
+
+	if (superseded)
+		superseded(false);
+}
+void PathJobs::run()
+{
+	while (true)
+	{
+		PathJob job;
+		{
+			std::unique_lock<std::mutex> lock(job_mutex);
+			job_ready.wait(lock, [this]() { return stopping || !jobs.empty(); });
+
+			if (jobs.empty())
+				return;
+
+			job = std::move(jobs.front());
+			jobs.pop_front();
+		}
+		job.run(true);
+	}
+}
@@ -0,0 +1,77 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef PATH_JOBS_HPP
+#define PATH_JOBS_HPP
+
+#include "dijkstra.hpp"
+#include "path_engine.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class PathGrid;
+
+struct PathJobResult
+{
+	bool found;
+	bool skipped; // Superseded or dropped before the worker got to it, nothing was searched
+	uint32_t revision;
+	std::vector<Point> path;
+};
+// Queued jobs from the same owner replace each other, only the newest one is worth running
+struct PathJob
+{
+	const void *owner;
+	std::function<void(bool)> run; // Called with false when the job is skipped
+};
+class PathJobs
+{
+public:
+	PathJobs();
+	~PathJobs();
+
+	void init();
+	void free();
+
+	std::future<PathJobResult> request_path(std::shared_ptr<const PathGrid> grid, Point start, Point end, uint8_t finder, PathMode mode, const void *owner = nullptr);
+	std::future< std::unique_ptr<Dijkstra> > request_map(std::shared_ptr<const PathGrid> grid, uint8_t goal_type, const void *owner = nullptr);
+
+	bool get_running() const { return running; }
+
+private:
+	void push_job(const void *owner, std::function<void(bool)> job);
+	void run();
+
+	bool running;
+	bool stopping;
+	std::thread worker;
+	std::mutex job_mutex;
+	std::condition_variable job_ready;
+	std::deque<PathJob> jobs;
+
+	// Only ever touched by the worker thread
+	PathEngine path_engine;
+};
+
+#endif // PATH_JOBS_HPP
@@ -0,0 +1,90 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+#include "engine.hpp"
+#include "stencil.hpp"
+
+Stencil::Stencil() : cells(0)
+{
+
+}
+Stencil::~Stencil()
+{
+
+}
+void Stencil::add_cell(int8_t offset_x, int8_t offset_y)
+{
+	const uint8_t bit = get_stencil_bit(offset_x, offset_y);
+	if ((cells >> bit) & 1)
+		return;
+
+	cells |= 1 << bit;
+	order.push_back(bit);
+	blockers.push_back(STENCIL_NONE);
+}
+void Stencil::add_cell(int8_t offset_x, int8_t offset_y, int8_t block_x, int8_t block_y)
+{
+	add_cell(offset_x, offset_y);
+	blockers[order.size() - 1] = get_stencil_bit(block_x, block_y);
+}
+uint32_t Stencil::get_open_cells(uint32_t walls) const
+{
+	uint32_t open = cells;
+	for (uint8_t i = 0; i < order.size(); i++)
+	{
+		if (blockers[i] != STENCIL_NONE && ((walls >> blockers[i]) & 1))
+			open &= ~(1 << order[i]);
+	}
+	return open;
+}
+const Stencil& Stencil::get_square()
+{
+	static const Stencil square = []()
+	{
+		Stencil stencil;
+		for (int8_t y = -2; y < 3; y++)
+		{
+			for (int8_t x = -2; x < 3; x++)
+				stencil.add_cell(x, y);
+		}
+		return stencil;
+	}();
+	return square;
+}
+const Stencil& Stencil::get_ranged()
+{
+	//   xxx
+	//  x...x    x = tiles a ranged attack can reach
+	//  x.@.x    . = the tile blocking each of them, one step closer on the far axis
+	//  x...x
+	//   xxx
+	static const Stencil ranged = []()
+	{
+		const int8_t offset_x[12] = { -1, 0, 1, -2, -2, -2, 2, 2, 2, -1, 0, 1 };
+		const int8_t offset_y[12] = { -2, -2, -2, -1, 0, 1, -1, 0, 1, 2, 2, 2 };
+
+		Stencil stencil;
+		for (uint8_t i = 0; i < 12; i++)
+		{
+			const int8_t block_x = (offset_x[i] == -2) ? -1 : (offset_x[i] == 2) ? 1 : offset_x[i];
+			const int8_t block_y = (offset_y[i] == -2) ? -1 : (offset_y[i] == 2) ? 1 : offset_y[i];
+			stencil.add_cell(offset_x[i], offset_y[i], block_x, block_y);
+		}
+		return stencil;
+	}();
+	return ranged;
+}
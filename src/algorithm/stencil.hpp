@@ -0,0 +1,58 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef STENCIL_HPP
+#define STENCIL_HPP
+
+#include <vector>
+
+// Area queries work on 5x5 windows centered on a tile, bit (y + 2) * 5 + (x + 2) of a window is the tile at offset (x, y)
+const uint8_t STENCIL_SIZE = 5;
+const uint8_t STENCIL_NONE = 0xFF;
+
+inline uint8_t get_stencil_bit(int8_t offset_x, int8_t offset_y)
+{
+	return (offset_y + 2) * STENCIL_SIZE + (offset_x + 2);
+}
+inline int8_t get_stencil_x(uint8_t bit) { return bit % STENCIL_SIZE - 2; }
+inline int8_t get_stencil_y(uint8_t bit) { return bit / STENCIL_SIZE - 2; }
+
+// A shape of tiles inside the window. A tile can name another one between it and the
+// center, which then has to be free of walls for the tile to be in line of fire.
+class Stencil
+{
+public:
+	Stencil();
+	~Stencil();
+
+	void add_cell(int8_t offset_x, int8_t offset_y);
+	void add_cell(int8_t offset_x, int8_t offset_y, int8_t block_x, int8_t block_y);
+
+	uint32_t get_open_cells(uint32_t walls) const;
+	uint32_t get_cells() const { return cells; }
+	const std::vector<uint8_t>& get_order() const { return order; }
+
+	static const Stencil& get_square();
+	static const Stencil& get_ranged();
+
+private:
+	uint32_t cells;
+	std::vector<uint8_t> order;
+	std::vector<uint8_t> blockers;
+};
+
+#endif // STENCIL_HPP
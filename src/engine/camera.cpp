@@ -62,7 +62,7 @@ void Camera::update()
 	if (std::abs(camera_x - desired_x) < 2.0f && std::abs(camera_y - desired_y) < 2.0f)
 		free_move = true; // Once we're close enough, just stop updating
 }
-void Camera::update_position(int16_t desired_x, int16_t desired_y, bool jump)
+void Camera::update_position(int32_t desired_x, int32_t desired_y, bool jump)
 {
 	free_move = false;
 	center_x = desired_x;
@@ -74,7 +74,7 @@ void Camera::update_position(int16_t desired_x, int16_t desired_y, bool jump)
 		camera_y = (float)(center_y - offset_y);
 	}
 }
-void Camera::move_camera(uint8_t direction, uint8_t map_width, uint8_t map_height)
+void Camera::move_camera(uint8_t direction, coord_t map_width, coord_t map_height)
 {
 	const float movement = engine.get_dt() * scroll_speed;
 	switch (direction)
@@ -87,7 +87,7 @@ void Camera::move_camera(uint8_t direction, uint8_t map_width, uint8_t map_heigh
 	}
 	free_move = true;
 }
-bool Camera::get_in_camera_grid(uint8_t xpos, uint8_t ypos) const
+bool Camera::get_in_camera_grid(coord_t xpos, coord_t ypos) const
 {
 	if (xpos >= camera_x / 32 - 1 && xpos < (camera_x + camera_w) / 32 + 1 &&
 		ypos >= camera_y / 32 - 1 && ypos < (camera_y + camera_h) / 32 + 1)
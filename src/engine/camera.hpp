@@ -27,12 +27,12 @@ public:
 	void init();
 	void update();
 
-	void update_position(int16_t desired_x, int16_t desired_y, bool jump = false);
-	void move_camera(uint8_t direction, uint8_t map_width, uint8_t map_height);
+	void update_position(int32_t desired_x, int32_t desired_y, bool jump = false);
+	void move_camera(uint8_t direction, coord_t map_width, coord_t map_height);
 
-	bool get_in_camera_grid(uint8_t xpos, uint8_t ypos) const;
-	int16_t get_cam_x() const { return (int16_t)camera_x; }
-	int16_t get_cam_y() const { return (int16_t)camera_y; }
+	bool get_in_camera_grid(coord_t xpos, coord_t ypos) const;
+	int32_t get_cam_x() const { return (int32_t)camera_x; }
+	int32_t get_cam_y() const { return (int32_t)camera_y; }
 	uint16_t get_cam_w() const { return camera_w; }
 	uint16_t get_cam_h() const { return camera_h; }
 
@@ -52,7 +52,7 @@ private:
 	float camera_x, camera_y;
 
 	uint16_t camera_w, camera_h;
-	int16_t center_x, center_y;
+	int32_t center_x, center_y;
 	int16_t offset_x, offset_y;
 };
 extern Camera camera;
@@ -140,7 +140,9 @@ bool Engine::init()
 
 	// Initialize other custom engine objects
 
-	generator.seed(std::random_device{}());
+	std::random_device seed_device;
+	for (std::mt19937 &generator : generators)
+		generator.seed(seed_device());
 
 	actor_manager = new ActorManager;
 	scene_manager = new SceneManager;
@@ -32,6 +32,7 @@
 #include <string>
 #include <iostream>
 #include <random>
+#include <type_traits>
 
 // DawnBringer palette colors
 const SDL_Color DAWN_BLACK = { 20, 12, 28 };
@@ -56,12 +57,34 @@ class SceneManager;
 class SoundManager;
 class TextureManager;
 
+// Map grid coordinates. Defaults to 16 bits so maps can grow past 255 tiles a side,
+// build with -DEOSOS_COORD_TYPE=uint8_t to go back to the old compact grids.
+// Offsets that may step off the map (or below zero) are done in int32_t.
+#ifndef EOSOS_COORD_TYPE
+	#define EOSOS_COORD_TYPE uint16_t
+#endif
+typedef EOSOS_COORD_TYPE coord_t;
+static_assert(std::is_unsigned<coord_t>::value && sizeof(coord_t) <= 2, "coord_t must be an unsigned 8 or 16 bit type");
+
+// Walking distance in steps, wide enough to cover every tile of the largest map
+typedef std::conditional<sizeof(coord_t) == 1, uint16_t, uint32_t>::type dist_t;
+
+// Independent random streams, so seeding one of them (say, to replay a level)
+// isn't thrown off by how often the others were drawn from
+enum RngStream
+{
+	RNG_WORLDGEN,
+	RNG_COMBAT,
+	RNG_AI,
+	RNG_COSMETIC,
+	RNG_COUNT
+};
 struct Point
 {
-	uint8_t x;
-	uint8_t y;
+	coord_t x;
+	coord_t y;
 
-	Point(uint8_t xpos, uint8_t ypos)
+	Point(coord_t xpos, coord_t ypos)
 	{
 		x = xpos;
 		y = ypos;
@@ -91,7 +114,8 @@ public:
 	TextureManager* get_texture_manager() const { return texture_manager; }
 
 	std::string get_base_path() const { return base_path; }
-	uint64_t get_rng() { return generator(); }
+	uint64_t get_rng(RngStream stream) { return generators[stream](); }
+	void seed_rng(RngStream stream, uint32_t seed) { generators[stream].seed(seed); }
 	uint32_t get_current_time() const { return current_time; }
 	uint8_t get_dt() const { return delta_time; }
 
@@ -106,7 +130,7 @@ private:
 	TextureManager *texture_manager;
 
 	std::string base_path;
-	std::mt19937 generator;
+	std::mt19937 generators[RNG_COUNT];
 
 	uint8_t delta_time;
 	uint32_t current_time;
@@ -53,6 +53,7 @@ void Options::init()
 	options_i["display-height"] = 576;
 	options_i["display-fps_cap"] = 60;
 	options_b["display-vsync"] = true;
+	options_i["display-chunk_budget"] = 32;
 
 	options_b["camera-follow_action"] = true;
 	options_i["camera-scroll_speed"] = 40;
@@ -63,6 +64,11 @@ void Options::init()
 
 	options_b["controller-enabled"] = false;
 
+	options_i["pathing-cache_size"] = 64;
+	options_b["pathing-async"] = true;
+
+	options_i["level-pool_size"] = 2;
+
 	options_s["ui-image"] = "background";
 	options_s["ui-font"] = "font";
 }
@@ -144,6 +150,17 @@ void Options::apply()
 	if (options_i["sound-music_volume"] > 100)
 		options_i["sound-music_volume"] = 100;
 
+	if (options_i["display-chunk_budget"] < 0)
+		options_i["display-chunk_budget"] = 0;
+
+	if (options_i["pathing-cache_size"] < 0)
+		options_i["pathing-cache_size"] = 0;
+
+	if (options_i["level-pool_size"] < 0)
+		options_i["level-pool_size"] = 0;
+	else if (options_i["level-pool_size"] > 255)
+		options_i["level-pool_size"] = 255;
+
 	if (options_b["display-borderless"])
 		SDL_SetWindowBordered(engine.get_window(), SDL_FALSE);
 	else SDL_SetWindowBordered(engine.get_window(), SDL_TRUE);
@@ -0,0 +1,104 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+#include "engine.hpp"
+#include "dirty_region.hpp"
+
+#include <algorithm> // for std::sort, std::unique
+
+DirtyRegion::DirtyRegion() :
+	width(0), height(0)
+{
+
+}
+DirtyRegion::~DirtyRegion()
+{
+	free();
+}
+void DirtyRegion::init(coord_t region_width, coord_t region_height)
+{
+	free();
+	width = region_width;
+	height = region_height;
+}
+void DirtyRegion::free()
+{
+	width = 0;
+	height = 0;
+	clear();
+}
+void DirtyRegion::add_tile(coord_t xpos, coord_t ypos)
+{
+	if (xpos >= width || ypos >= height)
+		return;
+	tiles.push_back(ypos * width + xpos);
+}
+const std::vector<SDL_Rect>& DirtyRegion::coalesce()
+{
+	rects.clear();
+	open_rects.clear();
+	next_open_rects.clear();
+
+	// Row-major order, so every row comes out as sorted runs
+	std::sort(tiles.begin(), tiles.end());
+	tiles.erase(std::unique(tiles.begin(), tiles.end()), tiles.end());
+
+	int32_t row = -1;
+	uint32_t open_index = 0;
+	for (uint32_t i = 0; i < tiles.size();)
+	{
+		const int32_t ypos = tiles[i] / width;
+		const int32_t xpos = tiles[i] % width;
+		int32_t run = 1;
+		while (i + run < tiles.size() && tiles[i + run] == tiles[i] + run && (xpos + run) < width)
+			run++;
+		i += run;
+
+		if (ypos != row)
+		{
+			// Only rectangles that reached the previous row can grow into this one
+			if (ypos != row + 1)
+				next_open_rects.clear();
+			open_rects.swap(next_open_rects);
+			next_open_rects.clear();
+			open_index = 0;
+			row = ypos;
+		}
+		while (open_index < open_rects.size() && rects[open_rects[open_index]].x < xpos)
+			open_index++;
+
+		if (open_index < open_rects.size() &&
+			rects[open_rects[open_index]].x == xpos && rects[open_rects[open_index]].w == run)
+		{
+			rects[open_rects[open_index]].h += 1;
+			next_open_rects.push_back(open_rects[open_index]);
+			open_index++;
+		}
+		else
+		{
+			rects.push_back({ xpos, ypos, run, 1 });
+			next_open_rects.push_back(rects.size() - 1);
+		}
+	}
+	return rects;
+}
+void DirtyRegion::clear()
+{
+	tiles.clear();
+	open_rects.clear();
+	next_open_rects.clear();
+}
@@ -0,0 +1,50 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef DIRTY_REGION_HPP
+#define DIRTY_REGION_HPP
+
+#include <vector>
+
+// Collects changed tiles between redraws and hands them back as as few
+// rectangles as it can, in tile units
+class DirtyRegion
+{
+public:
+	DirtyRegion();
+	~DirtyRegion();
+
+	void init(coord_t region_width, coord_t region_height);
+	void free();
+
+	void add_tile(coord_t xpos, coord_t ypos);
+	const std::vector<SDL_Rect>& coalesce();
+	void clear();
+
+	bool get_empty() const { return tiles.empty(); }
+
+private:
+	coord_t width;
+	coord_t height;
+
+	std::vector<uint32_t> tiles;
+	std::vector<SDL_Rect> rects;
+	std::vector<uint32_t> open_rects;
+	std::vector<uint32_t> next_open_rects;
+};
+
+#endif // DIRTY_REGION_HPP
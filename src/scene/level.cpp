@@ -19,8 +19,17 @@
 #include "level.hpp"
 #include "actor.hpp"
 #include "dijkstra.hpp"
+#include "dijkstra_map_set.hpp"
+#include "path_cache.hpp"
+#include "path_engine.hpp"
+#include "path_grid.hpp"
+#include "path_hierarchy.hpp"
+#include "path_jobs.hpp"
+#include "stencil.hpp"
 #include "texture.hpp"
 #include "generator_forest.hpp"
+#include "level_file.hpp"
+#include "level_pool.hpp"
 
 #include "actor_manager.hpp"
 #include "camera.hpp"
@@ -29,53 +38,88 @@
 #include "texture_manager.hpp"
 #include "ui.hpp"
 
+#include <algorithm> // for std::find_if, std::remove
 #include <fstream> // for std::ifstream
+#include <limits> // for std::numeric_limits
 #include <sstream> // for std::istringstream
 
+bool Level::autotile_loaded = false;
+uint8_t Level::autotile_frames[NT_COUNT][256];
+
 Level::Level() :
-	victory(false), dmg_base(0), map_created(false), map_texture(nullptr),
-	map_generator(nullptr), map_width(0), map_height(0), dijkstra_map(nullptr)
+	victory(false), dmg_base(0), map_created(false),
+	tiles_redrawn(0), target_switches(0), chunk_columns(0), chunk_rows(0), chunks_live(0), chunk_frame(0), anim_frame(0),
+	map_generator(nullptr), map_width(0), map_height(0), map_revision(0),
+	dijkstra_maps(nullptr), path_engine(nullptr), path_hierarchy(nullptr), path_cache(nullptr), path_jobs(nullptr), level_pool(nullptr),
+	world_seed((uint32_t)engine.get_rng(RNG_WORLDGEN))
 {
 
 }
 Level::~Level()
 {
 	free();
+
+	if (level_pool != nullptr)
+	{
+		delete level_pool;
+		level_pool = nullptr;
+	}
 }
 void Level::free()
 {
-	for (uint8_t y = 0; y < map_height; y++)
-	{
-		for (uint8_t x = 0; x < map_width; x++)
-		{
-			map_data[y][x].occupying_actor = nullptr;
-			map_data[y][x].floor_texture = nullptr;
-			map_data[y][x].wall_texture = nullptr;
-		}
-	}
 	map_created = false;
 
-	map_data.clear();
-	neighbor_rules.clear();
+	game_nodes.clear();
+	render_nodes.clear();
+	wall_grid.free();
+	actor_grid.free();
+	actor_type_grids.clear();
+	dirty_region.free();
+	hill_tiles.clear();
+	frame_overrides.clear();
+	anim_frame = 0;
 
-	if (map_texture != nullptr)
+	// Stop the worker before anything its jobs could hand back results to goes away
+	if (path_jobs != nullptr)
 	{
-		SDL_DestroyTexture(map_texture);
-		map_texture = nullptr;
+		delete path_jobs;
+		path_jobs = nullptr;
 	}
+	path_grid.reset();
+
+	free_map_chunks();
 	if (map_generator != nullptr)
 	{
 		delete map_generator;
 		map_generator = nullptr;
 	}
-	if (dijkstra_map != nullptr)
+	if (dijkstra_maps != nullptr)
 	{
-		delete dijkstra_map;
-		dijkstra_map = nullptr;
+		delete dijkstra_maps;
+		dijkstra_maps = nullptr;
+	}
+	if (path_engine != nullptr)
+	{
+		delete path_engine;
+		path_engine = nullptr;
+	}
+	if (path_hierarchy != nullptr)
+	{
+		delete path_hierarchy;
+		path_hierarchy = nullptr;
+	}
+	if (path_cache != nullptr)
+	{
+		logging.cout(std::string("Path cache hits: ") + std::to_string(path_cache->get_hits()) +
+			", misses: " + std::to_string(path_cache->get_misses()), LOG_LEVEL);
+		delete path_cache;
+		path_cache = nullptr;
+	}
+	if (engine.get_texture_manager() != nullptr)
+	{
+		for (Texture *t : textures)
+			engine.get_texture_manager()->free_texture(t->get_name());
 	}
-	for (Texture *t : textures)
-		engine.get_texture_manager()->free_texture(t->get_name());
-
 	textures.clear();
 	sub_nodes.clear();
 }
@@ -86,191 +130,461 @@ void Level::create(uint8_t depth)
 	if (depth > 1)
 		engine.get_actor_manager()->clear_actors(this);
 
+	if (level_pool == nullptr && options.get_i("level-pool_size") > 0)
+	{
+		level_pool = new LevelPool;
+		level_pool->init(options.get_i("level-pool_size"), world_seed);
+	}
+	victory = false;
+	dmg_base = 0;
+
 	map_generator = new GeneratorForest;
 	map_generator->init();
 
-	bool floor_layer = true;
-	uint8_t map_x = 0;
-	uint8_t map_y = 0;
+	// Authored levels go first, generated ones come through the binary format and the text one is the fallback
+	const uint32_t seed = get_depth_seed(world_seed, depth);
+	LevelFile level_file;
+	std::vector<uint8_t> level_data;
+	bool loaded = false;
+	if (!level_file.open(engine.get_base_path() + "level/depth" + std::to_string(depth) + ".lvl"))
+	{
+		// Only generate here if the pool has nothing ready for this depth
+		if (level_pool == nullptr || !level_pool->pop(depth, level_data))
+		{
+			LevelWriter writer;
+			const uint16_t maps_discarded = map_generator->generate(depth, seed, writer);
+			if (maps_discarded > 0)
+				logging.cout(std::to_string(maps_discarded) + " maps discarded, no access to right edge", LOG_LEVEL);
+			level_data = writer.get_binary();
+		}
+		else logging.cout("Level taken from the pool", LOG_LEVEL);
 
-	victory = false;
-	dmg_base = 0;
+		if (!level_file.open(level_data.data(), level_data.size()))
+		{
+			// The same depth and seed always give the same level, so it can be had again as text
+			LevelWriter writer;
+			map_generator->generate(depth, seed, writer);
+			map_generator->load_layout(depth, seed, writer.get_base_pos(), writer.get_spawn_positions());
+			loaded = load_text(writer.get_text());
+		}
+	}
+	if (level_file.get_open())
+	{
+		map_generator->load_layout(depth, seed, level_file.get_base_pos(), level_file.get_spawn_positions());
+		loaded = load_binary(level_file);
+	}
+	// Start on the next depths while this one is being played
+	if (level_pool != nullptr)
+		level_pool->request(depth + 1);
+
+	if (!loaded)
+	{
+		game_nodes.clear();
+		render_nodes.clear();
+		return;
+	}
+	map_created = true;
+	init_bit_grids();
+	dirty_region.init(map_width, map_height);
+
+	path_engine = new PathEngine;
+	path_engine->init(map_width, map_height);
+
+	path_cache = new PathCache;
+	path_cache->init(options.get_i("pathing-cache_size"));
+
+	if (options.get_b("pathing-async"))
+	{
+		path_jobs = new PathJobs;
+		path_jobs->init();
+	}
+
+	map_generator->post_process(this);
+
+	// Built after the generator is done carving, later wall changes repair it per cluster
+	path_hierarchy = new PathHierarchy;
+	path_hierarchy->build(this);
+
+	engine.get_actor_manager()->place_actors(this, get_base_pos());
+
+	dijkstra_maps = new DijkstraMapSet;
+	dijkstra_maps->build_maps(this);
+
+	// Correct the frames for all map nodes (so that tiles connect to eachother nicely)
+	load_autotile_rules();
+	for (coord_t y = 0; y < map_height; y++)
+	{
+		for (coord_t x = 0; x < map_width; x++)
+		{
+			const uint32_t index = get_index(x, y);
+			if (render_nodes[index].floor_texture != nullptr)
+				correct_frame(x, y, NT_FLOOR);
+			if (render_nodes[index].wall_texture != nullptr)
+				correct_frame(x, y, game_nodes[index].wall_type);
+		}
+	}
+	init_map_chunks();
+
+	//camera.update_position(((map_width - 2) * 32) / 2, ((map_height - 1) * 32) / 2);
+	logging.cout(std::string("Map created, size: ") + std::to_string((int)map_width) + ", " + std::to_string((int)map_height), LOG_LEVEL);
+}
+bool Level::load(const LevelFile &level_file, bool build_hierarchy)
+{
+	// Only the tiles and what the pathfinders need, no generator, actors or map chunks.
+	// This is what the headless tools use, the game goes through create().
+	free();
+	return init_loaded(load_binary(level_file), build_hierarchy);
+}
+bool Level::load(const std::string &level_text, bool build_hierarchy)
+{
+	free();
+	return init_loaded(load_text(level_text), build_hierarchy);
+}
+bool Level::init_loaded(bool loaded, bool build_hierarchy)
+{
+	if (!loaded)
+	{
+		game_nodes.clear();
+		render_nodes.clear();
+		return false;
+	}
+	map_created = true;
+	init_bit_grids();
+	dirty_region.init(map_width, map_height);
+
+	path_engine = new PathEngine;
+	path_engine->init(map_width, map_height);
+
+	// Costs more than the rest of the load put together, tools timing the load itself can skip it
+	if (build_hierarchy)
+	{
+		path_hierarchy = new PathHierarchy;
+		path_hierarchy->build(this);
+	}
+	return true;
+}
+bool Level::load_text(const std::string &level_text)
+{
+	bool floor_layer = true;
+	uint32_t map_x = 0;
+	uint32_t map_y = 0;
+	uint32_t row_width = 0;
 
-	std::istringstream level(map_generator->generate(depth));
+	std::istringstream level(level_text);
 	std::string line;
 
 	while (std::getline(level, line))
 	{
 		if (line[0] == 'l') // Lines starting with an 'l' (for "level") declare our nodes
 		{
-			// If a node with the given key (third character of the line) does not exist, we need to create it
-			auto it = sub_nodes.find(line[2]);
-			if (it == sub_nodes.end())
-			{
-				SubNode temp = { engine.get_texture_manager()->load_texture(line.substr(4, line.length() - 4)) };
-				if (temp.sub_texture != nullptr)
-				{
-					textures.push_back(temp.sub_texture);
-					temp.sub_type = get_node_type(temp.sub_texture->get_name());
-					temp.sub_animated = get_node_animated(temp.sub_texture);
-					sub_nodes[line[2]] = temp;
-				}
-			}
+			const std::string path = line.substr(4, line.length() - 4);
+			add_sub_node(line[2], path, get_node_type(path));
 		}
 		else if (line[0] != '\n') // Other lines define the map itself
 		{
-			std::vector<MapNode> map_line;
 			MapNode temp_map_node = { nullptr, nullptr, nullptr, 0, 0, NT_NONE, false, false };
 			for (char c : line)
 			{
-				if (sub_nodes.find(c) != sub_nodes.end()) // If the character is defined as a node, update temp_map_node
+				auto sub_node = sub_nodes.find(c);
+				if (sub_node != sub_nodes.end()) // If the character is defined as a node, update temp_map_node
 				{
 					if (!floor_layer)
 					{
-						temp_map_node.wall_type = sub_nodes[c].sub_type;
-						temp_map_node.wall_texture = sub_nodes[c].sub_texture;
-						temp_map_node.wall_animated = sub_nodes[c].sub_animated;
+						temp_map_node.wall_type = sub_node->second.sub_type;
+						temp_map_node.wall_texture = sub_node->second.sub_texture;
+						temp_map_node.wall_animated = sub_node->second.sub_animated;
 					}
-					else temp_map_node.floor_texture = sub_nodes[c].sub_texture;
+					else temp_map_node.floor_texture = sub_node->second.sub_texture;
 				}
 				if (!floor_layer) // Every other character ends a node definition
 				{
-					map_line.push_back(temp_map_node);
+					push_node(temp_map_node);
 					temp_map_node = { nullptr, nullptr, nullptr, 0, 0, NT_NONE, false, false };
 					map_x += 1;
 				}
 				floor_layer = !floor_layer;
 			}
-			map_data.push_back(map_line);
+			if (map_y == 0)
+				row_width = map_x;
 			map_y += 1; map_x = 0;
 		}
 	}
-	map_width = (uint8_t)map_data[0].size();
-	map_height = (uint8_t)map_data.size();
-	map_created = true;
-
-	map_generator->post_process(this);
-	engine.get_actor_manager()->place_actors(this, get_base_pos());
+	// Both planes are flat row-major arrays, so every row has to be as wide as the first
+	if (game_nodes.empty() || row_width > std::numeric_limits<coord_t>::max() ||
+		map_y > std::numeric_limits<coord_t>::max() ||
+		(uint64_t)row_width * map_y > INT32_MAX || game_nodes.size() != (uint64_t)row_width * map_y)
+	{
+		logging.cerr("Map is empty, uneven or too large for the coordinate type!", LOG_LEVEL);
+		return false;
+	}
+	map_width = (coord_t)row_width;
+	map_height = (coord_t)map_y;
+	return true;
+}
+bool Level::load_binary(const LevelFile &level_file)
+{
+	const LevelFileHeader &header = level_file.get_header();
+	if (header.width > std::numeric_limits<coord_t>::max() || header.height > std::numeric_limits<coord_t>::max() ||
+		(uint64_t)header.width * header.height > INT32_MAX)
+	{
+		logging.cerr("Map is too large for the coordinate type!", LOG_LEVEL);
+		return false;
+	}
+	// The palette is the only part that touches strings, the tiles are filled straight from the file
+	std::vector<SubNode> palette;
+	for (const LevelTexture &texture : level_file.get_palette())
+	{
+		if (texture.type >= NT_COUNT)
+		{
+			logging.cerr("Level file has an unknown node type!", LOG_LEVEL);
+			return false;
+		}
+		add_sub_node(texture.key, texture.path, (NodeType)texture.type);
+		palette.push_back(get_sub_node(texture.key));
+	}
+	// Each kind's nodes are put together once, the tiles only pick theirs
+	std::vector<GameNode> kind_games;
+	std::vector<RenderNode> kind_renders;
+	for (uint16_t i = 0; i < header.kind_count; i++)
+	{
+		const uint8_t floor = level_file.get_kinds()[i * 2];
+		const uint8_t wall = level_file.get_kinds()[i * 2 + 1];
 
-	dijkstra_map = new Dijkstra;
-	dijkstra_map->build_map(this);
+		// A wall whose texture didn't load leaves the tile open, same as an unknown key in the text format
+		const SubNode *wall_node = (wall != LEVEL_FILE_EMPTY && palette[wall].sub_texture != nullptr) ? &palette[wall] : nullptr;
+		kind_games.push_back({ nullptr, (wall_node != nullptr) ? wall_node->sub_type : NT_NONE });
+		kind_renders.push_back({
+			(floor != LEVEL_FILE_EMPTY) ? palette[floor].sub_texture : nullptr,
+			(wall_node != nullptr) ? wall_node->sub_texture : nullptr,
+			{ 0, 0, 0, 0 }, { 0, 0, 0, 0 },
+			(wall_node != nullptr) ? wall_node->sub_animated : false, false, false
+		});
+	}
+	const uint32_t tiles = header.width * header.height;
+	const uint8_t *tile_kinds = level_file.get_tiles();
 
-	// Correct the frames for all map nodes (so that tiles connect to eachother nicely)
-	load_neighbor_rules();
-	for (uint8_t y = 0; y < map_height; y++)
+	game_nodes.resize(tiles);
+	render_nodes.resize(tiles);
+	for (uint32_t i = 0; i < tiles; i++)
 	{
-		for (uint8_t x = 0; x < map_width; x++)
+		if (tile_kinds[i] >= header.kind_count)
 		{
-			if (map_data[y][x].floor_texture != nullptr)
-				correct_frame(x, y, NT_FLOOR);
-			if (map_data[y][x].wall_texture != nullptr)
-				correct_frame(x, y, map_data[y][x].wall_type);
+			logging.cerr("Level file has a tile outside of its kinds!", LOG_LEVEL);
+			return false;
 		}
+		game_nodes[i] = kind_games[tile_kinds[i]];
+		render_nodes[i] = kind_renders[tile_kinds[i]];
 	}
-	neighbor_rules.clear();
-	init_map_texture();
+	map_width = header.width;
+	map_height = header.height;
+	return true;
+}
+void Level::add_sub_node(char key, const std::string &path, NodeType type)
+{
+	// If a node with the given key does not exist, we need to create it
+	if (sub_nodes.find(key) != sub_nodes.end())
+		return;
 
-	//camera.update_position(((map_width - 2) * 32) / 2, ((map_height - 1) * 32) / 2);
-	logging.cout(std::string("Map created, size: ") + std::to_string((int)map_width) + ", " + std::to_string((int)map_height), LOG_LEVEL);
+	// Without a texture manager (the headless tools) every node shares an empty texture,
+	// so the walls still end up wherever their textures would have been
+	static Texture headless_texture;
+	TextureManager *texture_manager = engine.get_texture_manager();
+
+	SubNode temp = { (texture_manager != nullptr) ? texture_manager->load_texture(path) : &headless_texture };
+	if (temp.sub_texture != nullptr)
+	{
+		textures.push_back(temp.sub_texture);
+		temp.sub_type = type;
+		temp.sub_animated = get_node_animated(temp.sub_texture);
+		sub_nodes[key] = temp;
+	}
 }
 void Level::render() const
 {
-	if (map_texture != nullptr)
+	const SDL_Rect visible = get_visible_chunks();
+	for (int32_t y = visible.y; y < visible.y + visible.h; y++)
 	{
-		const SDL_Rect clip = { 0, 0, (map_width + 1) * 32, (map_height + 1) * 32 };
-		const SDL_Rect quad = {
-			-camera.get_cam_x() - 16, -camera.get_cam_y() - 16,
-			(map_width + 1) * 32, (map_height + 1) * 32
-		};
-		SDL_RenderCopyEx(engine.get_renderer(), map_texture, &clip, &quad, 0.0, nullptr, SDL_FLIP_NONE);
+		for (int32_t x = visible.x; x < visible.x + visible.w; x++)
+		{
+			const MapChunk &chunk = map_chunks[y * chunk_columns + x];
+			if (chunk.layers[0] == nullptr)
+				continue;
+
+			SDL_Rect quad = get_chunk_rect(x, y);
+			quad.x -= camera.get_cam_x() + 16;
+			quad.y -= camera.get_cam_y() + 16;
+			SDL_Texture *layer = (chunk.layers[1] != nullptr) ? chunk.layers[anim_frame] : chunk.layers[0];
+			SDL_RenderCopyEx(engine.get_renderer(), layer, nullptr, &quad, 0.0, nullptr, SDL_FLIP_NONE);
+		}
+	}
+	for (uint32_t index : frame_overrides)
+	{
+		const coord_t x = index % map_width;
+		const coord_t y = index / map_width;
+		if (camera.get_in_camera_grid(x, y))
+			render_tile(index, x * 32 - camera.get_cam_x(), y * 32 - camera.get_cam_y(), anim_frame ^ 1);
 	}
-	if (dijkstra_map != nullptr && options.get_b("debug-render_dijkstra"))
-		dijkstra_map->render_map();
+	if (dijkstra_maps != nullptr && options.get_b("debug-render_dijkstra"))
+		dijkstra_maps->render_map(GOAL_BASE);
 }
 void Level::render_ui() const
 {
 	if (map_created && map_generator != nullptr)
 		map_generator->render_ui();
 }
+void Level::update()
+{
+	tiles_redrawn = 0;
+	target_switches = 0;
+
+	if (!map_created)
+		return;
+
+	refresh_map_chunks();
+	update_map_chunks();
+}
 void Level::animate()
 {
 	if (!map_created)
 		return;
 
-	bool refresh_texture = false;
-	for (uint8_t y = 0; y < map_height; y++)
+	// Every animated tile flips with the layer, hills that stay behind one tick are drawn over it
+	anim_frame ^= 1;
+	frame_overrides.clear();
+	for (uint32_t index : hill_tiles)
 	{
-		for (uint8_t x = 0; x < map_width; x++)
-		{
-			if (map_data[y][x].wall_animated && map_data[y][x].wall_texture != nullptr)
-			{
-				if (map_data[y][x].wall_type == NT_HILL && engine.get_rng() % 3 == 0)
-					continue;
-				if (map_data[y][x].wall_rect.y < map_data[y][x].wall_texture->get_height() / 2)
-					map_data[y][x].wall_rect.y += map_data[y][x].wall_texture->get_height() / 2;
-				else map_data[y][x].wall_rect.y -= map_data[y][x].wall_texture->get_height() / 2;
-
-				map_data[y][x].node_rendered = false;
-				refresh_texture = true;
-			}
-		}
+		RenderNode &node = render_nodes[index];
+		if (engine.get_rng(RNG_COSMETIC) % 3 == 0)
+			node.frame_flipped = !node.frame_flipped;
+		if (node.frame_flipped)
+			frame_overrides.push_back(index);
 	}
-	if (refresh_texture)
-		refresh_map_texture(true);
 }
 void Level::next_turn()
 {
 	if (map_generator != nullptr)
 		map_generator->next_turn(this);
 }
-bool Level::get_wall(int8_t xpos, int8_t ypos, bool check_occupying) const
+bool Level::get_wall(int32_t xpos, int32_t ypos, bool check_occupying) const
 {
-	if (!map_created || xpos < 0 || ypos < 0 || xpos >= map_width || ypos >= map_height)
+	if (!map_created)
 		return true;
+	return wall_grid.get(xpos, ypos) || (check_occupying && actor_grid.get(xpos, ypos));
+}
+uint8_t Level::get_wall_mask(int32_t xpos, int32_t ypos, bool check_occupying) const
+{
+	if (!map_created)
+		return UINT8_MAX;
 	if (check_occupying)
-	{
-		if (map_data[ypos][xpos].occupying_actor != nullptr)
-			return true;
-	}
-	if (map_data[ypos][xpos].wall_type == NT_ROAD || map_data[ypos][xpos].wall_type == NT_BASE)
-		return false;
-	return map_data[ypos][xpos].wall_texture != nullptr;
+		return wall_grid.get_neighbors(xpos, ypos) | actor_grid.get_neighbors(xpos, ypos);
+	return wall_grid.get_neighbors(xpos, ypos);
 }
-NodeType Level::get_wall_type(int8_t xpos, int8_t ypos) const
+uint8_t Level::get_actor_mask(int32_t xpos, int32_t ypos) const
+{
+	if (!map_created)
+		return 0;
+	return actor_grid.get_neighbors(xpos, ypos);
+}
+NodeType Level::get_wall_type(int32_t xpos, int32_t ypos) const
 {
 	if (!map_created || xpos < 0 || ypos < 0 || xpos >= map_width || ypos >= map_height)
 		return NT_NONE;
-	return map_data[ypos][xpos].wall_type;
+	return game_nodes[get_index(xpos, ypos)].wall_type;
 }
-Actor* Level::get_actor(uint8_t xpos, uint8_t ypos) const
+Actor* Level::get_actor(coord_t xpos, coord_t ypos) const
 {
 	if (!map_created || xpos >= map_width || ypos >= map_height)
 		return nullptr;
-	return map_data[ypos][xpos].occupying_actor;
+	return game_nodes[get_index(xpos, ypos)].occupying_actor;
+}
+uint8_t Level::get_actor_type(coord_t xpos, coord_t ypos) const
+{
+	const Actor *temp_actor = get_actor(xpos, ypos);
+	if (temp_actor == nullptr)
+		return ACTOR_NULL;
+	return temp_actor->get_actor_type();
+}
+Dijkstra* Level::get_dijkstra(DijkstraGoal goal)
+{
+	if (dijkstra_maps == nullptr)
+		return nullptr;
+	return dijkstra_maps->get_map(this, goal);
 }
-MapNode Level::get_node(uint8_t xpos, uint8_t ypos) const
+Dijkstra* Level::request_dijkstra(DijkstraGoal goal)
+{
+	if (dijkstra_maps == nullptr)
+		return nullptr;
+	return dijkstra_maps->request_map(this, goal);
+}
+std::shared_ptr<const PathGrid> Level::get_path_grid()
+{
+	// Snapshots are immutable, a new one is only taken once the map has changed
+	if (path_grid == nullptr || path_grid->get_revision() != map_revision)
+	{
+		std::shared_ptr<PathGrid> grid = std::make_shared<PathGrid>();
+		grid->init(this);
+		path_grid = grid;
+	}
+	return path_grid;
+}
+MapNode Level::get_node(coord_t xpos, coord_t ypos) const
 {
 	if (!map_created || xpos >= map_width || ypos >= map_height)
 		return { nullptr, nullptr, nullptr, 0, 0, NT_NONE, false, false };
-	return map_data[ypos][xpos];
+	const GameNode &game = game_nodes[get_index(xpos, ypos)];
+	const RenderNode &render = render_nodes[get_index(xpos, ypos)];
+
+	return {
+		game.occupying_actor, render.floor_texture, render.wall_texture, render.floor_rect,
+		render.wall_rect, game.wall_type, render.wall_animated, render.node_rendered
+	};
+}
+NodeView Level::get_node_view(coord_t xpos, coord_t ypos) const
+{
+	static const GameNode empty_game = { nullptr, NT_NONE };
+	static const RenderNode empty_render = { nullptr, nullptr, { 0, 0, 0, 0 }, { 0, 0, 0, 0 }, false, false };
+
+	if (!map_created || xpos >= map_width || ypos >= map_height)
+		return { empty_game, empty_render };
+	return { game_nodes[get_index(xpos, ypos)], render_nodes[get_index(xpos, ypos)] };
+}
+const SubNode& Level::get_sub_node(char key) const
+{
+	static const SubNode empty_sub_node = { nullptr, NT_NONE, false };
+
+	auto it = sub_nodes.find(key);
+	if (it == sub_nodes.end())
+		return empty_sub_node;
+	return it->second;
 }
-std::pair<uint8_t, uint8_t> Level::get_base_pos() const
+std::pair<coord_t, coord_t> Level::get_base_pos() const
 {
 	if (map_generator != nullptr)
 		return map_generator->get_base_pos();
 	return std::make_pair(0, 0);
 }
-std::pair<uint8_t, uint8_t> Level::get_spawn_pos() const
+std::pair<coord_t, coord_t> Level::get_spawn_pos() const
 {
 	if (map_generator != nullptr)
 		return map_generator->get_spawn_pos();
 	return std::make_pair(0, 0);
 }
-void Level::set_actor(uint8_t xpos, uint8_t ypos, Actor *actor, bool jump)
+void Level::set_actor(coord_t xpos, coord_t ypos, Actor *actor, bool jump)
 {
-	if (!map_created || xpos < 0 || ypos < 0 || xpos >= map_width || ypos >= map_height)
+	if (!map_created || xpos >= map_width || ypos >= map_height)
 		return;
-	map_data[ypos][xpos].occupying_actor = actor;
+
+	GameNode &node = game_nodes[get_index(xpos, ypos)];
+	if (node.occupying_actor != actor)
+	{
+		// Actors block paths too, cached ones from before this move are stale
+		map_revision += 1;
+		if (dijkstra_maps != nullptr)
+			dijkstra_maps->on_actor_changed(this, xpos, ypos, node.occupying_actor, actor);
+	}
+	node.occupying_actor = actor;
+	actor_grid.set(xpos, ypos, actor != nullptr);
+	set_actor_type(xpos, ypos, actor);
 
 	if (actor != nullptr && jump)
 	{
@@ -278,72 +592,375 @@ void Level::set_actor(uint8_t xpos, uint8_t ypos, Actor *actor, bool jump)
 		actor->set_grid_y(ypos); actor->set_y(ypos * 32);
 	}
 }
-void Level::set_node(uint8_t xpos, uint8_t ypos, MapNode node)
+void Level::set_node(coord_t xpos, coord_t ypos, MapNode node)
 {
 	if (!map_created || xpos >= map_width || ypos >= map_height)
 		return;
-	map_data[ypos][xpos] = node;
+
+	const uint32_t index = get_index(xpos, ypos);
+	const bool was_wall = get_wall(xpos, ypos);
+	const bool was_hill = get_animated_hill(index);
+	Actor *prev_actor = game_nodes[index].occupying_actor;
+	store_node(index, node);
+	mark_dirty(xpos, ypos);
+
+	// The actor swap goes through set_actor() below, once the walls are current
+	game_nodes[index].occupying_actor = prev_actor;
+
+	// A changed tile starts over in step with the shown layer
+	render_nodes[index].frame_flipped = false;
+	if (was_hill)
+	{
+		hill_tiles.erase(std::remove(hill_tiles.begin(), hill_tiles.end(), index), hill_tiles.end());
+		frame_overrides.erase(std::remove(frame_overrides.begin(), frame_overrides.end(), index), frame_overrides.end());
+	}
+	if (get_animated_hill(index))
+		hill_tiles.push_back(index);
+	wall_grid.set(xpos, ypos, get_node_wall(node.wall_type, node.wall_texture));
+	map_revision += 1;
+
+	// Keep the flow field and the path clusters current without rebuilding the whole thing
+	if (was_wall != get_wall(xpos, ypos))
+	{
+		if (dijkstra_maps != nullptr)
+			dijkstra_maps->on_tile_changed(this, xpos, ypos);
+		if (path_hierarchy != nullptr)
+			path_hierarchy->on_tile_changed(this, xpos, ypos);
+	}
+	set_actor(xpos, ypos, node.occupying_actor, false);
 }
 void Level::set_turn(uint8_t turn)
 {
 	map_generator->set_turn(turn);
 }
-void Level::init_map_texture()
+void Level::init_bit_grids()
 {
-	map_texture = SDL_CreateTexture(engine.get_renderer(),
-		SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET,
-		(map_width + 1) * 32, (map_height + 1) * 32
-	);
-	if (map_texture == NULL)
+	// Walls and actors get a bit per tile next to the nodes, the pathfinders only ever read these
+	wall_grid.init(map_width, map_height, true);
+	actor_grid.init(map_width, map_height, false);
+
+	// And one more actor grid per ActorType, for area queries that only care about heroes or monsters
+	actor_type_grids.resize(ACTOR_TYPE_COUNT);
+	for (BitGrid &grid : actor_type_grids)
+		grid.init(map_width, map_height, false);
+
+	for (coord_t y = 0; y < map_height; y++)
 	{
-		map_texture = nullptr;
-		logging.cerr(std::string("Unable to create blank texture! SDL Error: ") + SDL_GetError(), LOG_TEXTURE);
-		return;
+		for (coord_t x = 0; x < map_width; x++)
+		{
+			const uint32_t index = get_index(x, y);
+			wall_grid.set(x, y, get_node_wall(game_nodes[index].wall_type, render_nodes[index].wall_texture));
+			actor_grid.set(x, y, game_nodes[index].occupying_actor != nullptr);
+			set_actor_type(x, y, game_nodes[index].occupying_actor);
+		}
 	}
-	SDL_SetRenderTarget(engine.get_renderer(), map_texture);
-	ui.draw_box(0, 0, map_width + 1, map_height + 1, false);
-	SDL_SetRenderTarget(engine.get_renderer(), NULL);
+}
+void Level::set_actor_type(coord_t xpos, coord_t ypos, const Actor *actor)
+{
+	// Whatever stood here before may already be gone, so every grid gets rewritten instead of asking it
+	const uint8_t actor_type = (actor != nullptr) ? actor->get_actor_type() : ACTOR_NULL;
+	for (uint8_t i = 0; i < actor_type_grids.size(); i++)
+		actor_type_grids[i].set(xpos, ypos, actor_type == i && actor != nullptr);
+}
+uint32_t Level::find_actors(coord_t xpos, coord_t ypos, uint8_t actor_type, const Stencil &stencil) const
+{
+	if (actor_type == ACTOR_NULL || actor_type >= actor_type_grids.size())
+		return actor_grid.get_window(xpos, ypos) & stencil.get_cells();
+	return actor_type_grids[actor_type].get_window(xpos, ypos) & stencil.get_cells();
+}
+void Level::push_node(const MapNode &node)
+{
+	game_nodes.push_back({ node.occupying_actor, node.wall_type });
+	render_nodes.push_back({
+		node.floor_texture, node.wall_texture, node.floor_rect,
+		node.wall_rect, node.wall_animated, node.node_rendered, false
+	});
+}
+void Level::store_node(uint32_t index, const MapNode &node)
+{
+	// Whether the tile is on the map texture yet is up to the dirty region, not the caller
+	game_nodes[index] = { node.occupying_actor, node.wall_type };
+	render_nodes[index] = {
+		node.floor_texture, node.wall_texture, node.floor_rect,
+		node.wall_rect, node.wall_animated, render_nodes[index].node_rendered,
+		render_nodes[index].frame_flipped
+	};
+}
+bool Level::get_node_wall(NodeType wall_type, const Texture *wall_texture) const
+{
+	if (wall_type == NT_ROAD || wall_type == NT_BASE)
+		return false;
+	return wall_texture != nullptr;
+}
+void Level::init_map_chunks()
+{
+	free_map_chunks();
+	chunk_columns = ((map_width + 1) * 32 + MAP_CHUNK_SIZE - 1) / MAP_CHUNK_SIZE;
+	chunk_rows = ((map_height + 1) * 32 + MAP_CHUNK_SIZE - 1) / MAP_CHUNK_SIZE;
+	map_chunks.assign(chunk_columns * chunk_rows, { { nullptr, nullptr }, 0 });
 
-	refresh_map_texture();
+	// Every chunk draws the current tiles when it gets created, nothing is waiting on a redraw
+	for (RenderNode &node : render_nodes)
+		node.node_rendered = true;
+	dirty_region.clear();
+	init_frame_overrides();
+}
+void Level::free_map_chunks()
+{
+	for (MapChunk &chunk : map_chunks)
+		destroy_map_chunk(chunk);
+	map_chunks.clear();
+	chunk_columns = 0;
+	chunk_rows = 0;
+	chunks_live = 0;
 }
-void Level::refresh_map_texture(bool animated_only)
+void Level::update_map_chunks()
 {
-	SDL_SetRenderTarget(engine.get_renderer(), map_texture);
-	//SDL_Rect default_rect = { 0, 0, 16, 16 };
+	chunk_frame += 1;
 
-	//Texture *grass = engine.get_texture_manager()->load_texture("level/decor/grass.png");
-	for (uint8_t y = 0; y < map_height; y++)
+	const SDL_Rect visible = get_visible_chunks();
+	for (int32_t y = visible.y; y < visible.y + visible.h; y++)
+	{
+		for (int32_t x = visible.x; x < visible.x + visible.w; x++)
+		{
+			MapChunk &chunk = map_chunks[y * chunk_columns + x];
+			chunk.last_used = chunk_frame;
+			if (chunk.layers[0] == nullptr)
+				create_map_chunk(x, y);
+		}
+	}
+	// Chunks on screen are never evicted, even if they alone go past the budget
+	while (chunks_live > options.get_i("display-chunk_budget"))
 	{
-		for (uint8_t x = 0; x < map_width; x++)
+		MapChunk *oldest = nullptr;
+		for (MapChunk &chunk : map_chunks)
 		{
-			if (map_data[y][x].node_rendered)
+			if (chunk.layers[0] == nullptr || chunk.last_used == chunk_frame)
 				continue;
-			if (animated_only && !map_data[y][x].wall_animated)
+			if (oldest == nullptr || chunk.last_used < oldest->last_used)
+				oldest = &chunk;
+		}
+		if (oldest == nullptr)
+			break;
+		destroy_map_chunk(*oldest);
+	}
+}
+void Level::refresh_map_chunks()
+{
+	if (dirty_region.get_empty())
+		return;
+
+	const std::vector<SDL_Rect> &rects = dirty_region.coalesce();
+	int32_t first_x = chunk_columns, first_y = chunk_rows, last_x = -1, last_y = -1;
+	for (const SDL_Rect &tiles : rects)
+	{
+		// Tiles sit half a tile in from the chunk grid, so they can reach into the next chunk
+		first_x = std::min(first_x, (tiles.x * 32 + 16) / MAP_CHUNK_SIZE);
+		first_y = std::min(first_y, (tiles.y * 32 + 16) / MAP_CHUNK_SIZE);
+		last_x = std::max(last_x, ((tiles.x + tiles.w) * 32 + 15) / MAP_CHUNK_SIZE);
+		last_y = std::max(last_y, ((tiles.y + tiles.h) * 32 + 15) / MAP_CHUNK_SIZE);
+
+		for (int32_t y = tiles.y; y < tiles.y + tiles.h; y++)
+		{
+			for (int32_t x = tiles.x; x < tiles.x + tiles.w; x++)
+				render_nodes[get_index(x, y)].node_rendered = true;
+		}
+	}
+	// Tiles in chunks that don't exist yet get drawn whenever those are created
+	for (int32_t y = first_y; y <= last_y && y < chunk_rows; y++)
+	{
+		for (int32_t x = first_x; x <= last_x && x < chunk_columns; x++)
+		{
+			MapChunk &chunk = map_chunks[y * chunk_columns + x];
+			if (chunk.layers[0] == nullptr)
 				continue;
-			map_data[y][x].node_rendered = true;
 
-			if (map_data[y][x].floor_texture != nullptr)
+			// A tile that just started animating needs a layer this chunk doesn't have, so it gets rebuilt
+			const SDL_Rect chunk_rect = get_chunk_rect(x, y);
+			if (chunk.layers[1] == nullptr && get_chunk_animated(chunk_rect))
 			{
-				map_data[y][x].floor_texture->render(x * 32 + 16, y * 32 + 16, &map_data[y][x].floor_rect);
-				/*if (grass != nullptr && engine.get_rng() % 5 == 0 &&
-					map_data[y][x].floor_texture->get_name().find("_grass") != std::string::npos)
+				destroy_map_chunk(chunk);
+				continue;
+			}
+			for (uint8_t frame = 0; frame < 2 && chunk.layers[frame] != nullptr; frame++)
+			{
+				bool target_set = false;
+				for (const SDL_Rect &tiles : rects)
+				{
+					if (tiles.x * 32 + 16 >= chunk_rect.x + chunk_rect.w || (tiles.x + tiles.w) * 32 + 16 <= chunk_rect.x ||
+						tiles.y * 32 + 16 >= chunk_rect.y + chunk_rect.h || (tiles.y + tiles.h) * 32 + 16 <= chunk_rect.y)
+						continue;
+					if (!target_set)
+					{
+						SDL_SetRenderTarget(engine.get_renderer(), chunk.layers[frame]);
+						target_switches += 1;
+						target_set = true;
+					}
+					redraw_tiles(tiles, chunk_rect, frame);
+				}
+				if (target_set)
 				{
-					const SDL_Rect rect = { (engine.get_rng() % 2) * 16, (engine.get_rng() % 2) * 16, 16, 16 };
-					grass->render(x * 32 + 16, y * 32 + 16, &rect);
-				}*/
+					SDL_SetRenderTarget(engine.get_renderer(), NULL);
+					target_switches += 1;
+				}
 			}
-			if (map_data[y][x].wall_texture != nullptr && map_data[y][x].wall_type != NT_INVISIBLE)
-				map_data[y][x].wall_texture->render(x * 32 + 16, y * 32 + 16, &map_data[y][x].wall_rect);
 		}
 	}
-	//if (grass != nullptr)
-		//engine.get_texture_manager()->free_texture(grass->get_name());
+	dirty_region.clear();
+}
+void Level::create_map_chunk(uint16_t chunk_x, uint16_t chunk_y)
+{
+	MapChunk &chunk = map_chunks[chunk_y * chunk_columns + chunk_x];
+	const SDL_Rect chunk_rect = get_chunk_rect(chunk_x, chunk_y);
+	const uint8_t layer_count = get_chunk_animated(chunk_rect) ? 2 : 1;
+
+	// The box cells line up with the chunk grid exactly
+	const uint16_t chunk_cells = MAP_CHUNK_SIZE / 32;
+	for (uint8_t frame = 0; frame < layer_count; frame++)
+	{
+		SDL_Texture *layer = SDL_CreateTexture(engine.get_renderer(),
+			SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET,
+			chunk_rect.w, chunk_rect.h
+		);
+		if (layer == NULL)
+		{
+			logging.cerr(std::string("Unable to create blank texture! SDL Error: ") + SDL_GetError(), LOG_TEXTURE);
+			destroy_map_chunk(chunk);
+			return;
+		}
+		if (frame == 0)
+			chunks_live += 1;
+		chunk.layers[frame] = layer;
 
-	SDL_SetRenderTarget(engine.get_renderer(), NULL);
+		SDL_SetRenderTarget(engine.get_renderer(), layer);
+		target_switches += 1;
+		ui.draw_box_cells(-chunk_rect.x, -chunk_rect.y, map_width + 1, map_height + 1,
+			{ chunk_x * chunk_cells, chunk_y * chunk_cells, chunk_cells, chunk_cells }, false);
+		redraw_tiles({ 0, 0, map_width, map_height }, chunk_rect, frame);
+		SDL_SetRenderTarget(engine.get_renderer(), NULL);
+		target_switches += 1;
+	}
+}
+void Level::destroy_map_chunk(MapChunk &chunk)
+{
+	if (chunk.layers[0] != nullptr)
+		chunks_live -= 1;
+	for (SDL_Texture *&layer : chunk.layers)
+	{
+		if (layer != nullptr)
+			SDL_DestroyTexture(layer);
+		layer = nullptr;
+	}
 }
-void Level::load_neighbor_rules()
+void Level::redraw_tiles(const SDL_Rect &tiles, const SDL_Rect &chunk_rect, uint8_t frame)
 {
+	const int32_t first_x = std::max(tiles.x, chunk_rect.x / 32 - 1);
+	const int32_t first_y = std::max(tiles.y, chunk_rect.y / 32 - 1);
+	const int32_t end_x = std::min(tiles.x + tiles.w, (chunk_rect.x + chunk_rect.w) / 32);
+	const int32_t end_y = std::min(tiles.y + tiles.h, (chunk_rect.y + chunk_rect.h) / 32);
+
+	for (int32_t y = first_y; y < end_y; y++)
+	{
+		for (int32_t x = first_x; x < end_x; x++)
+		{
+			render_tile(get_index(x, y), x * 32 + 16 - chunk_rect.x, y * 32 + 16 - chunk_rect.y, frame);
+			tiles_redrawn += 1;
+		}
+	}
+}
+void Level::render_tile(uint32_t index, int16_t xpos, int16_t ypos, uint8_t frame) const
+{
+	const RenderNode &node = render_nodes[index];
+	if (node.floor_texture != nullptr)
+		node.floor_texture->render(xpos, ypos, &node.floor_rect);
+	if (node.wall_texture == nullptr || game_nodes[index].wall_type == NT_INVISIBLE)
+		return;
+
+	// The second frame of an animated wall sits in the bottom half of its texture
+	SDL_Rect wall_rect = node.wall_rect;
+	if (node.wall_animated && frame == 1)
+		wall_rect.y += node.wall_texture->get_height() / 2;
+	node.wall_texture->render(xpos, ypos, &wall_rect);
+}
+void Level::init_frame_overrides()
+{
+	hill_tiles.clear();
+	frame_overrides.clear();
+	for (uint32_t i = 0; i < render_nodes.size(); i++)
+	{
+		render_nodes[i].frame_flipped = false;
+		if (get_animated_hill(i))
+			hill_tiles.push_back(i);
+	}
+}
+bool Level::get_animated_hill(uint32_t index) const
+{
+	const RenderNode &node = render_nodes[index];
+	return node.wall_animated && node.wall_texture != nullptr && game_nodes[index].wall_type == NT_HILL;
+}
+bool Level::get_chunk_animated(const SDL_Rect &chunk_rect) const
+{
+	const int32_t end_x = std::min<int32_t>(map_width, (chunk_rect.x + chunk_rect.w) / 32);
+	const int32_t end_y = std::min<int32_t>(map_height, (chunk_rect.y + chunk_rect.h) / 32);
+	for (int32_t y = std::max(chunk_rect.y / 32 - 1, 0); y < end_y; y++)
+	{
+		for (int32_t x = std::max(chunk_rect.x / 32 - 1, 0); x < end_x; x++)
+		{
+			const RenderNode &node = render_nodes[get_index(x, y)];
+			if (node.wall_animated && node.wall_texture != nullptr)
+				return true;
+		}
+	}
+	return false;
+}
+void Level::mark_dirty(coord_t xpos, coord_t ypos)
+{
+	// A tile only goes on the list once until the next redraw picks it up
+	RenderNode &node = render_nodes[get_index(xpos, ypos)];
+	if (!node.node_rendered)
+		return;
+	node.node_rendered = false;
+	dirty_region.add_tile(xpos, ypos);
+}
+SDL_Rect Level::get_chunk_rect(uint16_t chunk_x, uint16_t chunk_y) const
+{
+	// In map texture pixels, chunks on the right and bottom edges are cut to the map
+	const int32_t xpos = chunk_x * MAP_CHUNK_SIZE;
+	const int32_t ypos = chunk_y * MAP_CHUNK_SIZE;
+	return {
+		xpos, ypos,
+		std::min<int32_t>(MAP_CHUNK_SIZE, (map_width + 1) * 32 - xpos),
+		std::min<int32_t>(MAP_CHUNK_SIZE, (map_height + 1) * 32 - ypos)
+	};
+}
+SDL_Rect Level::get_visible_chunks() const
+{
+	if (map_chunks.empty())
+		return { 0, 0, 0, 0 };
+
+	// The map is drawn 16 pixels up and to the left of the camera
+	const int32_t left = std::max(camera.get_cam_x() + 16, 0);
+	const int32_t top = std::max(camera.get_cam_y() + 16, 0);
+	const int32_t right = std::min(camera.get_cam_x() + 16 + camera.get_cam_w(), (map_width + 1) * 32);
+	const int32_t bottom = std::min(camera.get_cam_y() + 16 + camera.get_cam_h(), (map_height + 1) * 32);
+	if (right <= left || bottom <= top)
+		return { 0, 0, 0, 0 };
+
+	return {
+		left / MAP_CHUNK_SIZE, top / MAP_CHUNK_SIZE,
+		(right - 1) / MAP_CHUNK_SIZE - left / MAP_CHUNK_SIZE + 1,
+		(bottom - 1) / MAP_CHUNK_SIZE - top / MAP_CHUNK_SIZE + 1
+	};
+}
+void Level::load_autotile_rules()
+{
+	if (autotile_loaded)
+		return;
+
+	// Rules are grouped by the texture subfolder they're for, a repeated pattern keeps its last frame
+	std::unordered_map< std::string, std::vector< std::pair<std::string, uint8_t> > > rules;
 	std::ifstream rules_file(engine.get_base_path() + "texture/level/rules.txt");
+
 	if (rules_file.is_open())
 	{
 		uint8_t line_num = 0;
@@ -362,113 +979,136 @@ void Level::load_neighbor_rules()
 			{
 				// Lines starting with 'f' (free) are unused tiles in the texture
 				if (line[0] != 'f')
-					neighbor_rules[prefix + line] = line_num;
+				{
+					auto &prefix_rules = rules[prefix];
+					auto it = std::find_if(prefix_rules.begin(), prefix_rules.end(),
+						[&line](const std::pair<std::string, uint8_t> &rule) { return rule.first == line; });
+
+					if (it != prefix_rules.end())
+						it->second = line_num;
+					else prefix_rules.push_back(std::make_pair(line, line_num));
+				}
 				line_num += 1;
 			}
 		}
 		rules_file.close();
 	}
-}
-void Level::correct_frame(uint8_t xpos, uint8_t ypos, NodeType node_type)
-{
-	if (node_type == NT_INVISIBLE)
-		return;
-	if (node_type == NT_BASE)
-	{
-		map_data[ypos][xpos].wall_rect = { 0, 0, 16, 16 };
-		return;
-	}
-	const std::string surroundings = get_surroundings(xpos, ypos, (node_type == NT_FLOOR ? true : false));
+	else logging.cerr("Could not find 'rules.txt', tiles won't connect!", LOG_LEVEL);
 
-	std::string prefix;
-	switch (node_type)
+	// Resolve every possible neighbourhood up front, correct_frame then just indexes the table
+	for (uint8_t t = 0; t < NT_COUNT; t++)
 	{
-		case NT_HILL: prefix = "hill"; break;
-		case NT_HOLE: prefix = "hole"; break;
-		case NT_TREE: prefix = "tree"; break;
-		case NT_WALL: prefix = "wall"; break;
-		case NT_WOOD: prefix = "wood"; break;
-		case NT_ROAD: prefix = "map"; break;
-		case NT_RIVER: prefix = "map"; break;
-		default: prefix = "floor"; break;
+		std::string prefix;
+		switch (t)
+		{
+			case NT_HILL: prefix = "hill"; break;
+			case NT_HOLE: prefix = "hole"; break;
+			case NT_TREE: prefix = "tree"; break;
+			case NT_WALL: prefix = "wall"; break;
+			case NT_WOOD: prefix = "wood"; break;
+			case NT_ROAD: prefix = "map"; break;
+			case NT_RIVER: prefix = "map"; break;
+			default: prefix = "floor"; break;
+		}
+		auto it = rules.find(prefix);
+		for (uint16_t surroundings = 0; surroundings < 256; surroundings++)
+			autotile_frames[t][surroundings] = (it != rules.end()) ? match_autotile_rules(it->second, surroundings) : 0;
 	}
-	bool got_pair;
+	autotile_loaded = true;
+}
+uint8_t Level::match_autotile_rules(const std::vector< std::pair<std::string, uint8_t> > &rules, uint8_t surroundings)
+{
+	// The rule matching the most neighbours wins, '-' matches anything without counting.
+	// Ties go to the rule listed first, and the all '-' rule is used when nothing else fits.
 	uint8_t matches = 0;
-	uint8_t loop_matches;
-	int8_t char_num;
-
-	std::pair<std::string, uint8_t> default_pair;
-	std::pair<std::string, uint8_t> found_pair;
+	uint8_t frame = 0;
+	uint8_t default_frame = 0;
 
-	for (std::pair<std::string, uint8_t> pair : neighbor_rules)
+	for (const std::pair<std::string, uint8_t> &rule : rules)
 	{
-		const std::string key = pair.first;
-		if (key == prefix + "--------")
+		if (rule.first == "--------")
 		{
-			default_pair = pair;
+			default_frame = rule.second;
 			continue;
 		}
-		if (key.substr(0, prefix.length()) != prefix)
-			continue;
-
-		got_pair = true;
-		char_num = -1;
-		loop_matches = 0;
+		bool got_rule = true;
+		uint8_t rule_matches = 0;
 
-		const std::string loop_key = key.substr(prefix.length(), key.length() - prefix.length());
-		for (char c : loop_key)
+		for (uint8_t i = 0; i < rule.first.length(); i++)
 		{
-			char_num += 1;
-			if (c == surroundings[char_num])
-				loop_matches += 1;
+			const char c = rule.first[i];
+			const char neighbor = (i < 8) ? (((surroundings >> i) & 1) ? '1' : '0') : '\0';
+
+			if (c == neighbor)
+				rule_matches += 1;
 			else if (c != '-')
 			{
-				got_pair = false;
+				got_rule = false;
 				break;
 			}
 		}
-		if (got_pair && loop_matches > matches)
+		if (got_rule && rule_matches > matches)
 		{
-			matches = loop_matches;
-			found_pair = pair;
+			matches = rule_matches;
+			frame = rule.second;
 		}
 	}
-	if (matches == 0)
-		found_pair = default_pair;
+	return (matches == 0) ? default_frame : frame;
+}
+void Level::correct_frame(coord_t xpos, coord_t ypos, NodeType node_type)
+{
+	if (node_type == NT_INVISIBLE)
+		return;
 
+	RenderNode &node = render_nodes[get_index(xpos, ypos)];
+	mark_dirty(xpos, ypos);
+	if (node_type == NT_BASE)
+	{
+		node.wall_rect = { 0, 0, 16, 16 };
+		return;
+	}
 	uint8_t row;
-	uint8_t column = found_pair.second;
+	uint8_t column = autotile_frames[node_type][get_surroundings(xpos, ypos, node_type == NT_FLOOR)];
 
 	if (node_type == NT_FLOOR)
 	{
-		row = map_data[ypos][xpos].floor_texture->get_height() / 16;
-		map_data[ypos][xpos].floor_rect = { 0, 0, 16, 16 };
+		row = node.floor_texture->get_height() / 16;
+		node.floor_rect = { 0, 0, 16, 16 };
 
-		if (get_node_animated(map_data[ypos][xpos].floor_texture))
+		if (get_node_animated(node.floor_texture))
 			row /= 2;
 		while (column >= row)
 		{
 			column -= row;
-			map_data[ypos][xpos].floor_rect.x += 16;
+			node.floor_rect.x += 16;
 		}
-		map_data[ypos][xpos].floor_rect.y = column * 16;
+		node.floor_rect.y = column * 16;
 	}
 	else
 	{
-		row = map_data[ypos][xpos].wall_texture->get_height() / 16;
-		map_data[ypos][xpos].wall_rect = { 0, 0, 16, 16 };
+		row = node.wall_texture->get_height() / 16;
+		node.wall_rect = { 0, 0, 16, 16 };
 
-		if (get_node_animated(map_data[ypos][xpos].wall_texture))
+		if (get_node_animated(node.wall_texture))
 			row /= 2;
 		while (column >= row)
 		{
 			column -= row;
-			map_data[ypos][xpos].wall_rect.x += 16;
+			node.wall_rect.x += 16;
 		}
-		map_data[ypos][xpos].wall_rect.y = column * 16;
+		node.wall_rect.y = column * 16;
 	}
 }
-NodeType Level::get_node_type(const std::string &texture_name) const
+uint32_t Level::get_depth_seed(uint32_t world_seed, uint8_t depth)
+{
+	// Each depth gets a seed of its own, so a pooled level and one generated on the spot are the same level
+	uint32_t seed = world_seed ^ (depth * 0x9E3779B9);
+	seed ^= seed >> 16;
+	seed *= 0x85EBCA6B;
+	seed ^= seed >> 13;
+	return seed;
+}
+NodeType Level::get_node_type(const std::string &texture_name)
 {
 	if (texture_name.find("invis") != std::string::npos) return NT_INVISIBLE;
 	else if (texture_name.find("/tree/") != std::string::npos) return NT_TREE;
@@ -490,25 +1130,26 @@ bool Level::get_node_animated(const Texture *node_texture) const
 		return true;
 	return false;
 }
-std::string Level::get_surroundings(uint8_t xpos, uint8_t ypos, bool check_floor) const
+uint8_t Level::get_surroundings(coord_t xpos, coord_t ypos, bool check_floor) const
 {
-	std::string result = "";
+	uint8_t result = 0;
 	const int8_t offset_x[8] = { -1, 0, 1, -1, 1, -1, 0, 1 };
 	const int8_t offset_y[8] = { -1, -1, -1, 0, 0, 1, 1, 1 };
 
+	const uint32_t index = get_index(xpos, ypos);
 	if (check_floor)
 	{
-		if (map_data[ypos][xpos].wall_type == NT_WOOD)
-			return "00000000";
+		if (game_nodes[index].wall_type == NT_WOOD)
+			return 0;
 
-		const std::string name = map_data[ypos][xpos].floor_texture->get_name();
+		const std::string name = render_nodes[index].floor_texture->get_name();
 		std::string base_name = "";
 		if (name.find("base") != std::string::npos)
 		{
 			// Get the prefix of the texture name (e.g "dark1")
 			const std::size_t split = name.find('_');
 			if (split == std::string::npos)
-				return "00000000";
+				return 0;
 			base_name = name.substr(0, split);
 		}
 		for (uint8_t i = 0; i < 8; i++)
@@ -516,34 +1157,34 @@ std::string Level::get_surroundings(uint8_t xpos, uint8_t ypos, bool check_floor
 			if (xpos + offset_x[i] < 0 || xpos + offset_x[i] >= map_width ||
 				ypos + offset_y[i] < 0 || ypos + offset_y[i] >= map_height)
 			{
-				result += '1';
+				result |= 1 << i;
 				continue;
 			}
-			const MapNode mn = map_data[ypos + offset_y[i]][xpos + offset_x[i]];
-
-			if (mn.floor_texture == nullptr)
-				result += '0';
-			else if (base_name != "" && mn.floor_texture->get_name().find(base_name) != std::string::npos &&
-				mn.floor_texture->get_name().find("_wood") == std::string::npos &&
-				mn.floor_texture->get_name().find("_stone") == std::string::npos &&
-				mn.wall_type != NT_HOLE && mn.wall_type != NT_WALL && mn.wall_type != NT_WOOD)
-				result += '1';
-			else if (base_name == "" && mn.floor_texture == map_data[ypos][xpos].floor_texture)
-				result += '1';
-			else result += '0';
+			const uint32_t n = get_index(xpos + offset_x[i], ypos + offset_y[i]);
+			const Texture *floor_texture = render_nodes[n].floor_texture;
+			const NodeType wall_type = game_nodes[n].wall_type;
+
+			if (floor_texture == nullptr)
+				continue;
+			if (base_name != "" && floor_texture->get_name().find(base_name) != std::string::npos &&
+				floor_texture->get_name().find("_wood") == std::string::npos &&
+				floor_texture->get_name().find("_stone") == std::string::npos &&
+				wall_type != NT_HOLE && wall_type != NT_WALL && wall_type != NT_WOOD)
+				result |= 1 << i;
+			else if (base_name == "" && floor_texture == render_nodes[index].floor_texture)
+				result |= 1 << i;
 		}
 	}
 	else for (uint8_t i = 0; i < 8; i++)
 	{
 		if (xpos + offset_x[i] < 0 || xpos + offset_x[i] >= map_width ||
 			ypos + offset_y[i] < 0 || ypos + offset_y[i] >= map_height)
-			result += '1';
-		else if (map_data[ypos + offset_y[i]][xpos + offset_x[i]].wall_texture == map_data[ypos][xpos].wall_texture)
-			result += '1';
-		else if (map_data[ypos][xpos].wall_type == NT_ROAD &&
-			map_data[ypos + offset_y[i]][xpos + offset_x[i]].wall_type == NT_BASE)
-			result += '1';
-		else result += '0';
+			result |= 1 << i;
+		else if (render_nodes[get_index(xpos + offset_x[i], ypos + offset_y[i])].wall_texture == render_nodes[index].wall_texture)
+			result |= 1 << i;
+		else if (game_nodes[index].wall_type == NT_ROAD &&
+			game_nodes[get_index(xpos + offset_x[i], ypos + offset_y[i])].wall_type == NT_BASE)
+			result |= 1 << i;
 	}
 	return result;
 }
@@ -18,19 +18,32 @@
 #ifndef LEVEL_HPP
 #define LEVEL_HPP
 
+#include "bit_grid.hpp"
+#include "dirty_region.hpp"
+#include "dijkstra_map_set.hpp"
+
+#include <memory>
 #include <vector>
 #include <unordered_map>
 
 class Actor;
+class Stencil;
 class Dijkstra;
+class PathCache;
+class PathEngine;
+class PathGrid;
+class PathHierarchy;
+class PathJobs;
 class Texture;
 class Generator;
+class LevelFile;
+class LevelPool;
 
 enum NodeType
 {
 	NT_NONE, NT_FLOOR, NT_HILL, NT_HOLE,
 	NT_TREE, NT_WALL, NT_WOOD, NT_ROAD,
-	NT_RIVER, NT_BASE, NT_INVISIBLE
+	NT_RIVER, NT_BASE, NT_INVISIBLE, NT_COUNT
 };
 typedef struct
 {
@@ -45,6 +58,46 @@ typedef struct
 }
 MapNode;
 
+// The level stores its nodes as two planes, what the game logic reads
+// apart from what only the map texture needs
+typedef struct
+{
+	Actor *occupying_actor;
+	NodeType wall_type;
+}
+GameNode;
+
+typedef struct
+{
+	Texture *floor_texture;
+	Texture *wall_texture;
+	SDL_Rect floor_rect;
+	SDL_Rect wall_rect;
+	bool wall_animated;
+	bool node_rendered;
+	bool frame_flipped;
+}
+RenderNode;
+
+typedef struct
+{
+	const GameNode &game;
+	const RenderNode &render;
+}
+NodeView;
+
+// The map is drawn into square chunk textures of this many pixels (16 by 16 tiles)
+const uint16_t MAP_CHUNK_SIZE = 512;
+
+// Animated tiles are baked into a second layer with their other frame,
+// chunks without any only get the first
+typedef struct
+{
+	SDL_Texture *layers[2];
+	uint32_t last_used;
+}
+MapChunk;
+
 typedef struct
 {
 	Texture *sub_texture;
@@ -61,58 +114,161 @@ public:
 
 	void free();
 	void create(uint8_t depth);
+	bool load(const LevelFile &level_file, bool build_hierarchy = true);
+	bool load(const std::string &level_text, bool build_hierarchy = true);
 	void render() const;
 	void render_ui() const;
+	void update();
 	void animate();
 	void next_turn();
 
 	bool get_victory() const { return victory; }
 	uint8_t get_damage_base() const { return dmg_base; }
-	uint8_t get_map_width() const { return map_width; }
-	uint8_t get_map_height() const { return map_height; }
-	auto get_sub_nodes() const { return sub_nodes; }
+	coord_t get_map_width() const { return map_width; }
+	coord_t get_map_height() const { return map_height; }
+	const std::unordered_map<char, SubNode>& get_sub_nodes() const { return sub_nodes; }
+	const SubNode& get_sub_node(char key) const;
+
+	bool get_wall(int32_t xpos, int32_t ypos, bool check_occupying = false) const;
+	uint8_t get_wall_mask(int32_t xpos, int32_t ypos, bool check_occupying = false) const;
+	uint8_t get_actor_mask(int32_t xpos, int32_t ypos) const;
+	const BitGrid& get_wall_grid() const { return wall_grid; }
+	const BitGrid& get_actor_grid() const { return actor_grid; }
+
+	// Tiles in the stencil around (xpos, ypos) holding an actor of the given type (ACTOR_NULL for any), as window bits
+	uint32_t find_actors(coord_t xpos, coord_t ypos, uint8_t actor_type, const Stencil &stencil) const;
+	uint32_t get_wall_window(coord_t xpos, coord_t ypos) const { return wall_grid.get_window(xpos, ypos); }
+	NodeType get_wall_type(int32_t xpos, int32_t ypos) const;
 
-	bool get_wall(int8_t xpos, int8_t ypos, bool check_occupying = false) const;
-	NodeType get_wall_type(int8_t xpos, int8_t ypos) const;
+	Actor* get_actor(coord_t xpos, coord_t ypos) const;
+	uint8_t get_actor_type(coord_t xpos, coord_t ypos) const;
+	MapNode get_node(coord_t xpos, coord_t ypos) const;
+	NodeView get_node_view(coord_t xpos, coord_t ypos) const;
 
-	Actor* get_actor(uint8_t xpos, uint8_t ypos) const;
-	MapNode get_node(uint8_t xpos, uint8_t ypos) const;
-	Dijkstra* get_dijkstra() const { return dijkstra_map; }
+	template <class Predicate, class Visitor>
+	void for_each_tile(Predicate predicate, Visitor visitor) const;
+	Dijkstra* get_dijkstra(DijkstraGoal goal = GOAL_BASE);
+	Dijkstra* request_dijkstra(DijkstraGoal goal);
+	std::shared_ptr<const PathGrid> get_path_grid();
+	PathEngine* get_path_engine() const { return path_engine; }
+	PathHierarchy* get_path_hierarchy() const { return path_hierarchy; }
+	PathCache* get_path_cache() const { return path_cache; }
+	PathJobs* get_path_jobs() const { return path_jobs; }
+	uint32_t get_map_revision() const { return map_revision; }
+	uint32_t get_tiles_redrawn() const { return tiles_redrawn; }
+	uint32_t get_target_switches() const { return target_switches; }
+	uint16_t get_chunks_live() const { return chunks_live; }
 
-	std::pair<uint8_t, uint8_t> get_base_pos() const;
-	std::pair<uint8_t, uint8_t> get_spawn_pos() const;
+	std::pair<coord_t, coord_t> get_base_pos() const;
+	std::pair<coord_t, coord_t> get_spawn_pos() const;
 
 	void set_victory(bool win) { victory = win; }
 	void set_damage_base(uint8_t dmg) { dmg_base = dmg; }
-	void set_actor(uint8_t xpos, uint8_t ypos, Actor *actor, bool jump = true);
-	void set_node(uint8_t xpos, uint8_t ypos, MapNode node);
+	void set_actor(coord_t xpos, coord_t ypos, Actor *actor, bool jump = true);
+	void set_node(coord_t xpos, coord_t ypos, MapNode node);
 	void set_turn(uint8_t turn);
 
+	static uint32_t get_depth_seed(uint32_t world_seed, uint8_t depth);
+	static NodeType get_node_type(const std::string &texture_name);
+
 private:
-	void init_map_texture();
-	void refresh_map_texture(bool animated_only = false);
+	bool load_text(const std::string &level_text);
+	bool load_binary(const LevelFile &level_file);
+	bool init_loaded(bool loaded, bool build_hierarchy);
+	void add_sub_node(char key, const std::string &path, NodeType type);
+
+	void init_bit_grids();
+	void set_actor_type(coord_t xpos, coord_t ypos, const Actor *actor);
+	void push_node(const MapNode &node);
+	void store_node(uint32_t index, const MapNode &node);
+	bool get_node_wall(NodeType wall_type, const Texture *wall_texture) const;
+	uint32_t get_index(coord_t xpos, coord_t ypos) const { return ypos * map_width + xpos; }
 
-	void load_neighbor_rules();
-	void correct_frame(uint8_t xpos, uint8_t ypos, NodeType node_type);
+	void init_map_chunks();
+	void free_map_chunks();
+	void update_map_chunks();
+	void refresh_map_chunks();
+	void create_map_chunk(uint16_t chunk_x, uint16_t chunk_y);
+	void destroy_map_chunk(MapChunk &chunk);
+	void redraw_tiles(const SDL_Rect &tiles, const SDL_Rect &chunk_rect, uint8_t frame);
+	void render_tile(uint32_t index, int16_t xpos, int16_t ypos, uint8_t frame) const;
+	void init_frame_overrides();
+	bool get_animated_hill(uint32_t index) const;
+	bool get_chunk_animated(const SDL_Rect &chunk_rect) const;
+	void mark_dirty(coord_t xpos, coord_t ypos);
+	SDL_Rect get_chunk_rect(uint16_t chunk_x, uint16_t chunk_y) const;
+	SDL_Rect get_visible_chunks() const;
+
+	static void load_autotile_rules();
+	static uint8_t match_autotile_rules(const std::vector< std::pair<std::string, uint8_t> > &rules, uint8_t surroundings);
+	void correct_frame(coord_t xpos, coord_t ypos, NodeType node_type);
 
-	NodeType get_node_type(const std::string &texture_name) const;
 	bool get_node_animated(const Texture *node_texture) const;
-	std::string get_surroundings(uint8_t xpos, uint8_t ypos, bool check_floor) const;
+	uint8_t get_surroundings(coord_t xpos, coord_t ypos, bool check_floor) const;
 
 	bool victory;
 	bool map_created;
 	uint8_t dmg_base;
-	uint8_t map_width;
-	uint8_t map_height;
+	coord_t map_width;
+	coord_t map_height;
+	uint32_t map_revision;
 
-	std::vector< std::vector<MapNode> > map_data;
-	std::unordered_map<std::string, uint8_t> neighbor_rules;
+	std::vector<GameNode> game_nodes;
+	std::vector<RenderNode> render_nodes;
+	BitGrid wall_grid;
+	BitGrid actor_grid;
+	std::vector<BitGrid> actor_type_grids;
 	std::unordered_map<char, SubNode> sub_nodes;
 	std::vector<Texture*> textures;
 
-	SDL_Texture *map_texture;
+	// Compiled from rules.txt once, the autotile frame for every wall type and neighbourhood
+	static bool autotile_loaded;
+	static uint8_t autotile_frames[NT_COUNT][256];
+
+	// Tiles that changed since the map texture was last drawn, and what the last redraw cost
+	DirtyRegion dirty_region;
+	uint32_t tiles_redrawn;
+	uint32_t target_switches;
+
+	// Created for whatever the camera sees, the ones unseen the longest go first past the budget
+	std::vector<MapChunk> map_chunks;
+	uint16_t chunk_columns;
+	uint16_t chunk_rows;
+	uint16_t chunks_live;
+	uint32_t chunk_frame;
+
+	// Which baked layer is shown, and the hills that skipped a tick and show the other one
+	uint8_t anim_frame;
+	std::vector<uint32_t> hill_tiles;
+	std::vector<uint32_t> frame_overrides;
+
 	Generator *map_generator;
-	Dijkstra *dijkstra_map;
+	DijkstraMapSet *dijkstra_maps;
+	PathEngine *path_engine;
+	PathHierarchy *path_hierarchy;
+	PathCache *path_cache;
+	PathJobs *path_jobs;
+	std::shared_ptr<const PathGrid> path_grid;
+
+	// Outlives free(), so it can keep generating the next depth across create() calls
+	LevelPool *level_pool;
+	uint32_t world_seed;
 };
 
+template <class Predicate, class Visitor>
+void Level::for_each_tile(Predicate predicate, Visitor visitor) const
+{
+	// Walks both planes in place, visitors get references instead of node copies
+	uint32_t index = 0;
+	for (coord_t y = 0; y < map_height; y++)
+	{
+		for (coord_t x = 0; x < map_width; x++, index++)
+		{
+			const NodeView node = { game_nodes[index], render_nodes[index] };
+			if (predicate(x, y, node))
+				visitor(x, y, node);
+		}
+	}
+}
+
 #endif // LEVEL_HPP
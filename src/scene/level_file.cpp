@@ -0,0 +1,322 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+#include "engine.hpp"
+#include "level_file.hpp"
+#include "level.hpp"
+
+#include "logging.hpp"
+
+#include <algorithm> // for std::fill, std::min
+#include <cstring> // for std::memcpy, std::memcmp
+#include <fstream> // for std::ofstream
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+LevelWriter::LevelWriter() :
+	width(0), height(0), base_pos(0, 0)
+{
+
+}
+LevelWriter::~LevelWriter()
+{
+	free();
+}
+void LevelWriter::init(coord_t level_width, coord_t level_height)
+{
+	free();
+	width = level_width;
+	height = level_height;
+	floor_keys.assign(width * height, '_');
+	wall_keys.assign(width * height, '_');
+}
+void LevelWriter::free()
+{
+	width = 0;
+	height = 0;
+	base_pos = std::make_pair(0, 0);
+	spawn_positions.clear();
+	palette.clear();
+	floor_keys.clear();
+	wall_keys.clear();
+}
+void LevelWriter::add_texture(char key, const std::string &path)
+{
+	// Like the text loader, the first texture given for a key is the one that sticks
+	for (const LevelTexture &texture : palette)
+	{
+		if (texture.key == key)
+			return;
+	}
+	palette.push_back({ key, (uint8_t)Level::get_node_type(path), path });
+}
+void LevelWriter::set_tile(coord_t xpos, coord_t ypos, char floor_key, char wall_key)
+{
+	if (xpos >= width || ypos >= height)
+		return;
+	floor_keys[ypos * width + xpos] = floor_key;
+	wall_keys[ypos * width + xpos] = wall_key;
+}
+const std::string LevelWriter::get_text() const
+{
+	std::string level;
+	for (const LevelTexture &texture : palette)
+		level += std::string("l-") + texture.key + '-' + texture.path + '\n';
+
+	for (coord_t y = 0; y < height; y++)
+	{
+		for (coord_t x = 0; x < width; x++)
+		{
+			level += floor_keys[y * width + x];
+			level += wall_keys[y * width + x];
+		}
+		level += '\n';
+	}
+	return level;
+}
+const std::vector<uint8_t> LevelWriter::get_binary() const
+{
+	uint8_t key_index[256];
+	std::fill(key_index, key_index + 256, LEVEL_FILE_EMPTY);
+
+	uint32_t palette_bytes = 0;
+	for (uint8_t i = 0; i < palette.size() && i < LEVEL_FILE_EMPTY; i++)
+	{
+		key_index[(uint8_t)palette[i].key] = i;
+		palette_bytes += 4 + palette[i].path.length();
+	}
+	// Every floor and wall pair the level uses becomes a kind, in the order they first show up.
+	// Keys outside the palette leave that half of the tile empty.
+	const uint32_t tiles = width * height;
+	std::vector<uint16_t> kind_index(256 * 256, LEVEL_FILE_MAX_KINDS);
+	std::vector<uint8_t> kinds;
+	std::vector<uint8_t> tile_kinds(tiles);
+
+	for (uint32_t i = 0; i < tiles; i++)
+	{
+		const uint8_t floor = key_index[(uint8_t)floor_keys[i]];
+		const uint8_t wall = key_index[(uint8_t)wall_keys[i]];
+		uint16_t &kind = kind_index[floor * 256 + wall];
+		if (kind == LEVEL_FILE_MAX_KINDS)
+		{
+			if (kinds.size() / 2 == LEVEL_FILE_MAX_KINDS)
+				return std::vector<uint8_t>();
+			kind = kinds.size() / 2;
+			kinds.push_back(floor);
+			kinds.push_back(wall);
+		}
+		tile_kinds[i] = (uint8_t)kind;
+	}
+	LevelFileHeader header = {
+		{ LEVEL_FILE_MAGIC[0], LEVEL_FILE_MAGIC[1], LEVEL_FILE_MAGIC[2], LEVEL_FILE_MAGIC[3] },
+		LEVEL_FILE_VERSION, width, height, base_pos.first, base_pos.second,
+		(uint16_t)spawn_positions.size(), (uint16_t)std::min<size_t>(palette.size(), LEVEL_FILE_EMPTY),
+		(uint16_t)(kinds.size() / 2), palette_bytes
+	};
+	std::vector<uint8_t> data(sizeof(LevelFileHeader) + header.spawn_count * 4 + palette_bytes + kinds.size() + tiles);
+	std::memcpy(data.data(), &header, sizeof(LevelFileHeader));
+
+	uint8_t *out = data.data() + sizeof(LevelFileHeader);
+	for (uint16_t i = 0; i < header.spawn_count; i++)
+	{
+		const uint16_t pos[2] = { spawn_positions[i].first, spawn_positions[i].second };
+		std::memcpy(out, pos, 4);
+		out += 4;
+	}
+	for (uint8_t i = 0; i < header.palette_count; i++)
+	{
+		const uint16_t length = palette[i].path.length();
+		out[0] = palette[i].key;
+		out[1] = palette[i].type;
+		std::memcpy(out + 2, &length, 2);
+		std::memcpy(out + 4, palette[i].path.data(), length);
+		out += 4 + length;
+	}
+	std::memcpy(out, kinds.data(), kinds.size());
+	std::memcpy(out + kinds.size(), tile_kinds.data(), tiles);
+	return data;
+}
+bool LevelWriter::write(const std::string &path) const
+{
+	std::ofstream file(path, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+	if (!file.is_open())
+	{
+		logging.cerr("Could not write level file '" + path + "'", LOG_LEVEL);
+		return false;
+	}
+	const std::vector<uint8_t> data = get_binary();
+	if (data.empty())
+	{
+		logging.cerr("Level has too many tile kinds for '" + path + "'", LOG_LEVEL);
+		return false;
+	}
+	file.write((const char*)data.data(), data.size());
+	return file.good();
+}
+
+LevelFile::LevelFile() :
+	data(nullptr), data_size(0), mapping(nullptr), mapping_size(0),
+	kinds(nullptr), tiles(nullptr)
+{
+
+}
+LevelFile::~LevelFile()
+{
+	free();
+}
+bool LevelFile::open(const std::string &path)
+{
+	free();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER file_size;
+	if (GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0)
+	{
+		// The view keeps the mapping alive on its own, neither handle is needed after this
+		HANDLE file_mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		if (file_mapping != NULL)
+		{
+			mapping = MapViewOfFile(file_mapping, FILE_MAP_READ, 0, 0, 0);
+			mapping_size = (size_t)file_size.QuadPart;
+			CloseHandle(file_mapping);
+		}
+	}
+	CloseHandle(file);
+#else
+	const int file = ::open(path.c_str(), O_RDONLY);
+	if (file < 0)
+		return false;
+
+	struct stat file_info;
+	if (fstat(file, &file_info) == 0 && file_info.st_size > 0)
+	{
+		void *view = mmap(nullptr, file_info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+		if (view != MAP_FAILED)
+		{
+			mapping = view;
+			mapping_size = (size_t)file_info.st_size;
+		}
+	}
+	::close(file);
+#endif
+
+	if (mapping == nullptr)
+	{
+		logging.cerr("Could not map level file '" + path + "'", LOG_LEVEL);
+		mapping_size = 0;
+		return false;
+	}
+	data = (const uint8_t*)mapping;
+	data_size = mapping_size;
+	if (!parse())
+	{
+		logging.cerr("Level file '" + path + "' is broken or from another version", LOG_LEVEL);
+		free();
+		return false;
+	}
+	return true;
+}
+bool LevelFile::open(const uint8_t *buffer, size_t buffer_size)
+{
+	free();
+	data = buffer;
+	data_size = buffer_size;
+	if (!parse())
+	{
+		free();
+		return false;
+	}
+	return true;
+}
+void LevelFile::free()
+{
+	if (mapping != nullptr)
+	{
+#ifdef _WIN32
+		UnmapViewOfFile(mapping);
+#else
+		munmap(mapping, mapping_size);
+#endif
+		mapping = nullptr;
+		mapping_size = 0;
+	}
+	data = nullptr;
+	data_size = 0;
+	spawn_positions.clear();
+	palette.clear();
+	kinds = nullptr;
+	tiles = nullptr;
+}
+bool LevelFile::parse()
+{
+	if (data == nullptr || data_size < sizeof(LevelFileHeader))
+		return false;
+
+	std::memcpy(&header, data, sizeof(LevelFileHeader));
+	if (std::memcmp(header.magic, LEVEL_FILE_MAGIC, 4) != 0 || header.version != LEVEL_FILE_VERSION ||
+		header.width == 0 || header.height == 0 || header.palette_count >= LEVEL_FILE_EMPTY)
+		return false;
+
+	const uint64_t tile_count = (uint64_t)header.width * header.height;
+	const uint64_t palette_start = sizeof(LevelFileHeader) + (uint64_t)header.spawn_count * 4;
+	const uint64_t palette_end = palette_start + header.palette_bytes;
+	if (header.kind_count > LEVEL_FILE_MAX_KINDS || palette_end + header.kind_count * 2 + tile_count > data_size)
+		return false;
+
+	for (uint16_t i = 0; i < header.spawn_count; i++)
+	{
+		uint16_t pos[2];
+		std::memcpy(pos, data + sizeof(LevelFileHeader) + i * 4, 4);
+		spawn_positions.push_back(std::make_pair(pos[0], pos[1]));
+	}
+	uint64_t offset = palette_start;
+	for (uint16_t i = 0; i < header.palette_count; i++)
+	{
+		uint16_t length;
+		if (offset + 4 > palette_end)
+			return false;
+		std::memcpy(&length, data + offset + 2, 2);
+		if (offset + 4 + length > palette_end)
+			return false;
+
+		palette.push_back({ (char)data[offset], data[offset + 1], std::string((const char*)data + offset + 4, length) });
+		offset += 4 + length;
+	}
+	kinds = data + palette_end;
+	tiles = kinds + header.kind_count * 2;
+
+	// Kinds can only point into the palette, the tiles get checked against the kinds as they're loaded
+	for (uint16_t i = 0; i < header.kind_count * 2; i++)
+	{
+		if (kinds[i] != LEVEL_FILE_EMPTY && kinds[i] >= header.palette_count)
+			return false;
+	}
+	return true;
+}
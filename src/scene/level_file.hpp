@@ -0,0 +1,127 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef LEVEL_FILE_HPP
+#define LEVEL_FILE_HPP
+
+#include <vector>
+
+// Binary levels are laid out as the header, the spawn positions, the texture palette,
+// the tile kinds (a floor and a wall palette index each) and then one kind byte per tile.
+// Wall types come from the palette, so a tile costs a byte against the text format's two.
+const char LEVEL_FILE_MAGIC[4] = { 'E', 'O', 'S', 'L' };
+const uint16_t LEVEL_FILE_VERSION = 2;
+const uint8_t LEVEL_FILE_EMPTY = 0xFF;
+const uint16_t LEVEL_FILE_MAX_KINDS = 256;
+
+typedef struct
+{
+	char magic[4];
+	uint16_t version;
+	uint16_t width;
+	uint16_t height;
+	uint16_t base_x;
+	uint16_t base_y;
+	uint16_t spawn_count;
+	uint16_t palette_count;
+	uint16_t kind_count;
+	uint32_t palette_bytes;
+}
+LevelFileHeader;
+
+typedef struct
+{
+	char key;
+	uint8_t type;
+	std::string path;
+}
+LevelTexture;
+
+// Collects a level as the generator builds it, and hands it back in either format
+class LevelWriter
+{
+public:
+	LevelWriter();
+	~LevelWriter();
+
+	void init(coord_t level_width, coord_t level_height);
+	void free();
+
+	void add_texture(char key, const std::string &path);
+	void add_spawn_pos(std::pair<coord_t, coord_t> pos) { spawn_positions.push_back(pos); }
+	void set_base_pos(std::pair<coord_t, coord_t> pos) { base_pos = pos; }
+	void set_tile(coord_t xpos, coord_t ypos, char floor_key, char wall_key);
+
+	coord_t get_width() const { return width; }
+	coord_t get_height() const { return height; }
+	char get_wall_key(coord_t xpos, coord_t ypos) const { return wall_keys[ypos * width + xpos]; }
+	std::pair<coord_t, coord_t> get_base_pos() const { return base_pos; }
+	const std::vector< std::pair<coord_t, coord_t> >& get_spawn_positions() const { return spawn_positions; }
+
+	const std::string get_text() const;
+	// Empty if the level has more floor and wall pairs than a kind byte can tell apart
+	const std::vector<uint8_t> get_binary() const;
+	bool write(const std::string &path) const;
+
+private:
+	coord_t width;
+	coord_t height;
+
+	std::pair<coord_t, coord_t> base_pos;
+	std::vector< std::pair<coord_t, coord_t> > spawn_positions;
+	std::vector<LevelTexture> palette;
+	std::vector<char> floor_keys;
+	std::vector<char> wall_keys;
+};
+
+// Reads a binary level straight from a memory mapped file or a buffer, the tile planes are never copied
+class LevelFile
+{
+public:
+	LevelFile();
+	~LevelFile();
+
+	bool open(const std::string &path);
+	bool open(const uint8_t *buffer, size_t buffer_size);
+	void free();
+
+	bool get_open() const { return data != nullptr; }
+	const LevelFileHeader& get_header() const { return header; }
+	const std::vector<LevelTexture>& get_palette() const { return palette; }
+	std::pair<coord_t, coord_t> get_base_pos() const { return std::make_pair(header.base_x, header.base_y); }
+	const std::vector< std::pair<coord_t, coord_t> >& get_spawn_positions() const { return spawn_positions; }
+
+	// Floor and wall palette indices of each kind, two bytes a kind
+	const uint8_t* get_kinds() const { return kinds; }
+	const uint8_t* get_tiles() const { return tiles; }
+
+private:
+	bool parse();
+
+	const uint8_t *data;
+	size_t data_size;
+	void *mapping;
+	size_t mapping_size;
+
+	LevelFileHeader header;
+	std::vector< std::pair<coord_t, coord_t> > spawn_positions;
+	std::vector<LevelTexture> palette;
+	const uint8_t *kinds;
+	const uint8_t *tiles;
+};
+
+#endif // LEVEL_FILE_HPP
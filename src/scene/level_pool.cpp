@@ -0,0 +1,136 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+#include "engine.hpp"
+#include "level_pool.hpp"
+#include "level.hpp"
+#include "level_file.hpp"
+#include "generator_forest.hpp"
+
+LevelPool::LevelPool() :
+	running(false), stopping(false), pool_size(0), target_depth(0), world_seed(0)
+{
+
+}
+LevelPool::~LevelPool()
+{
+	free();
+}
+void LevelPool::init(uint8_t size, uint32_t seed)
+{
+	if (running || size == 0)
+		return;
+
+	pool_size = size;
+	target_depth = 0;
+	world_seed = seed;
+
+	stopping = false;
+	running = true;
+	worker = std::thread(&LevelPool::run, this);
+}
+void LevelPool::free()
+{
+	if (running)
+	{
+		{
+			std::lock_guard<std::mutex> lock(pool_mutex);
+			stopping = true;
+		}
+		pool_changed.notify_one();
+
+		worker.join();
+		running = false;
+	}
+	levels.clear();
+}
+bool LevelPool::pop(uint8_t depth, std::vector<uint8_t> &level_data)
+{
+	{
+		std::lock_guard<std::mutex> lock(pool_mutex);
+		auto it = levels.begin();
+		while (it != levels.end() && it->depth != depth)
+			++it;
+		if (it == levels.end())
+			return false;
+
+		level_data = std::move(it->level_data);
+		levels.erase(it);
+	}
+	pool_changed.notify_one();
+	return true;
+}
+void LevelPool::request(uint8_t depth)
+{
+	{
+		std::lock_guard<std::mutex> lock(pool_mutex);
+		if (target_depth == depth)
+			return;
+
+		// Nobody goes back up, anything above the new depth is never getting used
+		target_depth = depth;
+		for (auto it = levels.begin(); it != levels.end();)
+		{
+			if (it->depth < depth)
+				it = levels.erase(it);
+			else ++it;
+		}
+	}
+	pool_changed.notify_one();
+}
+bool LevelPool::get_missing_depth(uint8_t &depth) const
+{
+	if (target_depth == 0)
+		return false;
+
+	for (uint16_t d = target_depth; d < target_depth + pool_size && d <= 255; d++)
+	{
+		bool found = false;
+		for (const PooledLevel &level : levels)
+			found = found || level.depth == d;
+
+		if (!found)
+		{
+			depth = d;
+			return true;
+		}
+	}
+	return false;
+}
+void LevelPool::run()
+{
+	// A generator of its own, generate() never touches anything the main thread uses
+	GeneratorForest generator;
+	while (true)
+	{
+		uint8_t depth = 0;
+		{
+			std::unique_lock<std::mutex> lock(pool_mutex);
+			pool_changed.wait(lock, [this, &depth]() { return stopping || get_missing_depth(depth); });
+
+			if (stopping)
+				return;
+		}
+		LevelWriter writer;
+		generator.generate(depth, Level::get_depth_seed(world_seed, depth), writer);
+		PooledLevel level = { depth, writer.get_binary() };
+
+		std::lock_guard<std::mutex> lock(pool_mutex);
+		if (depth >= target_depth)
+			levels.push_back(std::move(level));
+	}
+}
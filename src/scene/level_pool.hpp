@@ -0,0 +1,64 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef LEVEL_POOL_HPP
+#define LEVEL_POOL_HPP
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+typedef struct
+{
+	uint8_t depth;
+	std::vector<uint8_t> level_data;
+}
+PooledLevel;
+
+// Keeps the next few depths generated ahead of time on a worker thread,
+// so going down a level only has to load one
+class LevelPool
+{
+public:
+	LevelPool();
+	~LevelPool();
+
+	void init(uint8_t size, uint32_t seed);
+	void free();
+
+	bool pop(uint8_t depth, std::vector<uint8_t> &level_data);
+	void request(uint8_t depth);
+
+private:
+	bool get_missing_depth(uint8_t &depth) const;
+	void run();
+
+	bool running;
+	bool stopping;
+	uint8_t pool_size;
+	uint8_t target_depth;
+	uint32_t world_seed;
+
+	std::thread worker;
+	std::mutex pool_mutex;
+	std::condition_variable pool_changed;
+	std::deque<PooledLevel> levels;
+};
+
+#endif // LEVEL_POOL_HPP
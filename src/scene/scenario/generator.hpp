@@ -18,7 +18,10 @@
 #ifndef GENERATOR_HPP
 #define GENERATOR_HPP
 
+#include <vector>
+
 class Level;
+class LevelWriter;
 
 class Generator
 {
@@ -29,12 +32,14 @@ public:
 	virtual void init() = 0;
 	virtual void render_ui() = 0;
 
-	virtual const std::string generate(uint8_t depth) = 0;
+	// Builds a level from nothing but the depth and the seed, returns how many layouts it threw away
+	virtual uint16_t generate(uint8_t depth, uint32_t seed, LevelWriter &writer) const = 0;
+	virtual void load_layout(uint8_t depth, uint32_t seed, std::pair<coord_t, coord_t> base, const std::vector< std::pair<coord_t, coord_t> > &spawns) = 0;
 	virtual void post_process(Level *level) = 0;
 	virtual void next_turn(Level *level) = 0;
 
-	virtual std::pair<uint8_t, uint8_t> get_base_pos() const = 0;
-	virtual std::pair<uint8_t, uint8_t> get_spawn_pos() const = 0;
+	virtual std::pair<coord_t, coord_t> get_base_pos() const = 0;
+	virtual std::pair<coord_t, coord_t> get_spawn_pos() const = 0;
 
 	virtual void set_turn(uint8_t turn) = 0;
 };
@@ -18,6 +18,7 @@
 #include "engine.hpp"
 #include "generator_forest.hpp"
 #include "level.hpp"
+#include "level_file.hpp"
 #include "astar.hpp"
 
 #include "actor_manager.hpp"
@@ -33,6 +34,10 @@
 
 #include <unordered_map>
 
+// Every forest level is the same size, only the layout changes
+const coord_t FOREST_WIDTH = 25;
+const coord_t FOREST_HEIGHT = 15;
+
 GeneratorForest::GeneratorForest() :
 	pathfinder(nullptr), wave_class(WAVE_NONE), wave_boss(MONSTER_NONE),
 	boss_name("???"), boss_desc("???"), peon(false)
@@ -62,32 +67,29 @@ void GeneratorForest::render_ui()
 	ui.get_bitmap_font()->render_text(16, 16, "Level: " + std::to_string(current_depth));
 	ui.get_bitmap_font()->render_text(16, 27, "Wave: " + std::to_string(current_wave));
 }
-const std::string GeneratorForest::generate(uint8_t depth)
+uint16_t GeneratorForest::generate(uint8_t depth, uint32_t seed, LevelWriter &writer) const
 {
+	// Only reads the depth and the seed, so the same pair always builds the same level on any thread
+	std::mt19937 rng(seed);
 	const int8_t offset_x[8] = { 0, 0, -1, 1, -1, 1, -1, 1 };
 	const int8_t offset_y[8] = { -1, 1, 0, 0, -1, -1, 1, 1 };
 
-	width = 25; height = 15;
-	uint8_t map_data[width * height];
-	base_pos = std::make_pair(5, 7 + ((engine.get_rng() % 5) - 2));
-
-	calm_timer = 3;
-	spawned_mobs = 0;
-	current_wave = 0;
-	current_turn = 0;
-	current_depth = depth;
-	wave_monsters.clear();
-	peon = false;
+	const coord_t width = FOREST_WIDTH;
+	const coord_t height = FOREST_HEIGHT;
+	std::vector<uint8_t> map_data(width * height);
+	std::vector< std::pair<coord_t, coord_t> > spawn_positions;
+	const std::pair<coord_t, coord_t> base_pos = std::make_pair(5, 7 + ((rng() % 5) - 2));
+	uint16_t maps_discarded = 0;
 
 	bool map_fine = false;
 	while (!map_fine)
 	{
 		spawn_positions.clear();
-		std::fill(map_data, map_data + (width * height), 1);
+		std::fill(map_data.begin(), map_data.end(), 1);
 
 		uint8_t floor_num = 1;
-		uint8_t xpos = base_pos.first;
-		uint8_t ypos = base_pos.second;
+		coord_t xpos = base_pos.first;
+		coord_t ypos = base_pos.second;
 		map_data[ypos * width + xpos] = 0;
 
 		while (floor_num < 180)
@@ -104,7 +106,7 @@ const std::string GeneratorForest::generate(uint8_t depth)
 				xpos = base_pos.first;
 				ypos = base_pos.second;
 			}
-			const uint8_t dir = engine.get_rng() % 4;
+			const uint8_t dir = rng() % 4;
 			xpos += offset_x[dir];
 			ypos += offset_y[dir];
 
@@ -115,49 +117,70 @@ const std::string GeneratorForest::generate(uint8_t depth)
 			}
 		}
 		if (!map_fine)
-			logging.cout("Map discarded, no access to right edge", LOG_LEVEL);
+			maps_discarded += 1;
 	}
 	const std::string woods = (depth % 2 == 0) ? "spruce_dead" : "oak_dead";
 	const std::string bases[4] = { "base_camp", "base_outpost", "base_garrison", "base_fort" };
-	std::string level =
-		"l-0-level/floor/dark2_base.png\n"
-		"l-1-level/floor/dark2_grass.png\n"
-		"l-2-level/floor/dark2_hill.png\n"
-		"l-3-level/floor/dark2_field.png\n"
-		"l-M-level/hill/dark_blue.png\n"
-		"l-#-level/map/road_dark2.png\n";
-	level += "l-T-level/tree/" + woods +  ".png\n";
-	level += "l-B-level/map/" + ((depth < 5) ? bases[depth-1] : bases[3]) + ".png\n";
+
+	writer.init(width, height);
+	writer.set_base_pos(base_pos);
+	for (const std::pair<coord_t, coord_t> &spawn : spawn_positions)
+		writer.add_spawn_pos(spawn);
+
+	writer.add_texture('0', "level/floor/dark2_base.png");
+	writer.add_texture('1', "level/floor/dark2_grass.png");
+	writer.add_texture('2', "level/floor/dark2_hill.png");
+	writer.add_texture('3', "level/floor/dark2_field.png");
+	writer.add_texture('M', "level/hill/dark_blue.png");
+	writer.add_texture('#', "level/map/road_dark2.png");
+	writer.add_texture('T', "level/tree/" + woods + ".png");
+	writer.add_texture('B', "level/map/" + ((depth < 5) ? bases[depth-1] : bases[3]) + ".png");
 
 	const uint8_t field_probability = (depth < 5) ? 11 - depth : 7;
-	for (uint8_t y = 0; y < height; y++)
+	for (coord_t y = 0; y < height; y++)
 	{
-		for (uint8_t x = 0; x < width; x++)
+		for (coord_t x = 0; x < width; x++)
 		{
 			const uint8_t node = map_data[y * width + x];
 			bool field = false;
+			char floor_key, wall_key = '_';
 
 			if (node != 1 && x < 10 && x > 1 && y < 11 && y > 3)
 			{
-				level += (engine.get_rng() % field_probability == 0) ? '3' : '0';
+				floor_key = (rng() % field_probability == 0) ? '3' : '0';
 				field = true;
 			}
 			else if (x < 15)
-				level += (engine.get_rng() % 5 < 2) ? '0' : '1';
-			else level += (engine.get_rng() % 4 == 0) ? '1' : '2';
+				floor_key = (rng() % 5 < 2) ? '0' : '1';
+			else floor_key = (rng() % 4 == 0) ? '1' : '2';
 
 			if (node == 1 && !field)
 			{
-				if (engine.get_rng() % ((x + 1) * 4) > 20)
-					level += 'M';
-				else level += 'T';
+				if (rng() % ((x + 1) * 4) > 20)
+					wall_key = 'M';
+				else wall_key = 'T';
 			}
-			else level += '_';
+			writer.set_tile(x, y, floor_key, wall_key);
 		}
-		level += '\n';
 	}
-	logging.cout(level, LOG_LEVEL);
-	return level;
+	return maps_discarded;
+}
+void GeneratorForest::load_layout(uint8_t depth, uint32_t seed, std::pair<coord_t, coord_t> base, const std::vector< std::pair<coord_t, coord_t> > &spawns)
+{
+	width = FOREST_WIDTH; height = FOREST_HEIGHT;
+	calm_timer = 3;
+	spawned_mobs = 0;
+	current_wave = 0;
+	current_turn = 0;
+	current_depth = depth;
+	wave_monsters.clear();
+	peon = false;
+
+	base_pos = base;
+	spawn_positions = spawns;
+
+	// Decorating the level draws from its own stream, apart from the one the layout came from
+	level_rng.seed(seed ^ 0x9E3779B9);
 }
 void GeneratorForest::post_process(Level *level)
 {
@@ -168,26 +191,28 @@ void GeneratorForest::post_process(Level *level)
 	}
 	else pathfinder->clear_path();
 
-	const std::pair<uint8_t, uint8_t> start = spawn_positions[engine.get_rng() % spawn_positions.size()];
-	const uint8_t start_x = start.first;
-	const uint8_t start_y = start.second;
+	const std::pair<coord_t, coord_t> start = spawn_positions[level_rng() % spawn_positions.size()];
+	const coord_t start_x = start.first;
+	const coord_t start_y = start.second;
 
 	spawn_positions.clear();
 	spawn_positions.push_back(start);
 
-	auto sub_nodes = level->get_sub_nodes();
+	const SubNode &floor = level->get_sub_node('0');
+	const SubNode &road = level->get_sub_node('#');
+	const SubNode &base = level->get_sub_node('B');
 	MapNode new_node = { nullptr, nullptr, nullptr, 0, 0, NT_NONE, false, false };
 	MapNode base_node = { nullptr, nullptr, nullptr, 0, 0, NT_NONE, false, false };
 
-	new_node.floor_texture = sub_nodes['0'].sub_texture;
-	new_node.wall_texture = sub_nodes['#'].sub_texture;
-	new_node.wall_animated = sub_nodes['#'].sub_animated;
-	new_node.wall_type = sub_nodes['#'].sub_type;
+	new_node.floor_texture = floor.sub_texture;
+	new_node.wall_texture = road.sub_texture;
+	new_node.wall_animated = road.sub_animated;
+	new_node.wall_type = road.sub_type;
 
-	base_node.floor_texture = sub_nodes['0'].sub_texture;
-	base_node.wall_texture = sub_nodes['B'].sub_texture;
-	base_node.wall_animated = sub_nodes['B'].sub_animated;
-	base_node.wall_type = sub_nodes['B'].sub_type;
+	base_node.floor_texture = floor.sub_texture;
+	base_node.wall_texture = base.sub_texture;
+	base_node.wall_animated = base.sub_animated;
+	base_node.wall_type = base.sub_type;
 
 	pathfinder->find_path(level, Point(start_x, start_y), Point(base_pos.first, base_pos.second), 0);
 	while (pathfinder->get_path_found())
@@ -198,28 +223,26 @@ void GeneratorForest::post_process(Level *level)
 	level->set_node(start_x, start_y, new_node);
 	level->set_node(base_pos.first, base_pos.second, base_node);
 
+	// Fields are the only floor using the '3' texture, compare pointers instead of texture names
+	const Texture *field_texture = level->get_sub_node('3').sub_texture;
 	const std::string crops[6] = { "1", "2", "3", "4", "5", "6" };
-	MapNode temp_node;
 
-	for (uint8_t y = 0; y < height; y++)
-	{
-		for (uint8_t x = 0; x < width; x++)
+	level->for_each_tile(
+		[this, field_texture](coord_t x, coord_t y, const NodeView &node)
 		{
-			if (x == base_pos.first && y == base_pos.second)
-				continue;
-
-			temp_node = level->get_node(x, y);
-			if (temp_node.floor_texture->get_name().find("_field") != std::string::npos)
+			return field_texture != nullptr && node.render.floor_texture == field_texture &&
+				(x != base_pos.first || y != base_pos.second);
+		},
+		[this, level, &crops](coord_t x, coord_t y, const NodeView &node)
+		{
+			if (level_rng() % 4 != 0)
 			{
-				if (engine.get_rng() % 4 != 0)
-				{
-					const std::string crop_name = "level/decor/crop_" + crops[engine.get_rng() % 6] + ".png";
-					engine.get_actor_manager()->spawn_actor(level, ACTOR_PROP, x, y, crop_name, false);
-				}
-				else engine.get_actor_manager()->spawn_actor(level, ACTOR_MOUNT, x, y, "actor/sheep_white.png", false);
+				const std::string crop_name = "level/decor/crop_" + crops[level_rng() % 6] + ".png";
+				engine.get_actor_manager()->spawn_actor(level, ACTOR_PROP, x, y, crop_name, false);
 			}
+			else engine.get_actor_manager()->spawn_actor(level, ACTOR_MOUNT, x, y, "actor/sheep_white.png", false);
 		}
-	}
+	);
 }
 void GeneratorForest::next_turn(Level *level)
 {
@@ -253,7 +276,7 @@ void GeneratorForest::next_turn(Level *level)
 
 		if (monster != nullptr && wave_monsters.size() > 1)
 		{
-			const uint8_t i = (engine.get_rng() % wave_monsters.size());
+			const uint8_t i = (engine.get_rng(RNG_AI) % wave_monsters.size());
 			MonsterClass mc = (MonsterClass)wave_monsters[i];
 
 			if (current_wave == current_depth + 1 && spawned_mobs == (current_wave * 5 + 4))
@@ -267,7 +290,7 @@ void GeneratorForest::next_turn(Level *level)
 					engine.get_sound_manager()->set_playlist(PT_BOSS);
 				}
 			}
-			else if (mount_name.length() > 0 && engine.get_rng() % 20 == 0)
+			else if (mount_name.length() > 0 && engine.get_rng(RNG_AI) % 20 == 0)
 			{
 				Actor *mount = engine.get_actor_manager()->spawn_actor(level, ACTOR_MOUNT, pos.first, pos.second, mount_name);
 				if (mount != nullptr)
@@ -287,11 +310,11 @@ void GeneratorForest::next_turn(Level *level)
 	else if (current_turn == 2)
 		ui.clear_message_box();
 }
-std::pair<uint8_t, uint8_t> GeneratorForest::get_spawn_pos() const
+std::pair<coord_t, coord_t> GeneratorForest::get_spawn_pos() const
 {
 	if (spawn_positions.size() == 0)
 		return std::make_pair(0, 0);
-	return spawn_positions[engine.get_rng() % spawn_positions.size()];
+	return spawn_positions[engine.get_rng(RNG_AI) % spawn_positions.size()];
 }
 void GeneratorForest::init_wave()
 {
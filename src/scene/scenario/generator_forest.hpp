@@ -20,6 +20,7 @@
 
 #include "generator.hpp"
 
+#include <random>
 #include <vector>
 
 class AStar;
@@ -42,12 +43,13 @@ public:
 	virtual void init();
 	virtual void render_ui();
 
-	virtual const std::string generate(uint8_t depth);
+	virtual uint16_t generate(uint8_t depth, uint32_t seed, LevelWriter &writer) const;
+	virtual void load_layout(uint8_t depth, uint32_t seed, std::pair<coord_t, coord_t> base, const std::vector< std::pair<coord_t, coord_t> > &spawns);
 	virtual void post_process(Level *level);
 	virtual void next_turn(Level *level);
 
-	virtual std::pair<uint8_t, uint8_t> get_base_pos() const { return base_pos; }
-	virtual std::pair<uint8_t, uint8_t> get_spawn_pos() const;
+	virtual std::pair<coord_t, coord_t> get_base_pos() const { return base_pos; }
+	virtual std::pair<coord_t, coord_t> get_spawn_pos() const;
 
 	virtual void set_turn(uint8_t turn) { current_turn = turn; }
 
@@ -55,8 +57,8 @@ private:
 	void init_wave();
 
 	bool peon;
-	uint8_t width;
-	uint8_t height;
+	coord_t width;
+	coord_t height;
 	AStar *pathfinder;
 
 	uint8_t calm_timer;
@@ -71,8 +73,9 @@ private:
 	std::string boss_desc;
 	std::string mount_name;
 	std::vector<uint8_t> wave_monsters;
-	std::pair<uint8_t, uint8_t> base_pos;
-	std::vector< std::pair<uint8_t, uint8_t> > spawn_positions;
+	std::pair<coord_t, coord_t> base_pos;
+	std::vector< std::pair<coord_t, coord_t> > spawn_positions;
+	std::mt19937 level_rng;
 };
 
 #endif // GENERATOR_FOREST_HPP
@@ -34,7 +34,7 @@
 #include <cmath> // for std::floor
 
 Scenario::Scenario() :
-	state(GAME_IN_PROGRESS), base_health(20), anim_timer(0), current_depth(1), hovered_actor(nullptr),
+	state(GAME_IN_PROGRESS), base_health(20), anim_timer(0), current_depth(1), hovered_actor(ACTOR_HANDLE_NONE),
 	current_level(nullptr), node_highlight(nullptr), base_healthbar(nullptr), frames(0), display_fps(0),
 	frame_counter(0), dir_x(0), dir_y(0)
 {
@@ -67,7 +67,7 @@ void Scenario::free()
 		engine.get_texture_manager()->free_texture(t->get_name());
 
 	pointers.clear();
-	hovered_actor = nullptr;
+	hovered_actor = ACTOR_HANDLE_NONE;
 
 	ui.free();
 }
@@ -271,22 +271,24 @@ bool Scenario::update()
 
 	if (current_level != nullptr)
 	{
-		const int8_t map_x = (mouse_x + camera.get_cam_x()) / 32;
-		const int8_t map_y = (mouse_y + camera.get_cam_y()) / 32;
+		const int32_t map_x = (mouse_x + camera.get_cam_x()) / 32;
+		const int32_t map_y = (mouse_y + camera.get_cam_y()) / 32;
 
 		if (!ui.get_overlap(mouse_x, mouse_y) && map_x >= 0 && map_y >= 0 &&
 			map_x < current_level->get_map_width() && map_y < current_level->get_map_height())
 		{
+			// A handle to an actor that has since died just resolves to nothing
 			Actor *temp_actor = current_level->get_actor(map_x, map_y);
-			if (temp_actor != hovered_actor)
+			Actor *prev_actor = engine.get_actor_manager()->get_actor(hovered_actor);
+			if (temp_actor != prev_actor)
 			{
-				if (hovered_actor != nullptr && hovered_actor->get_hovered() != HOVER_UI)
-					hovered_actor->set_hovered(HOVER_NONE);
+				if (prev_actor != nullptr && prev_actor->get_hovered() != HOVER_UI)
+					prev_actor->set_hovered(HOVER_NONE);
 
-				hovered_actor = temp_actor;
+				hovered_actor = (temp_actor != nullptr) ? temp_actor->get_handle() : ACTOR_HANDLE_NONE;
 
-				if (hovered_actor != nullptr)
-					hovered_actor->set_hovered(HOVER_MAP);
+				if (temp_actor != nullptr)
+					temp_actor->set_hovered(HOVER_MAP);
 			}
 		}
 	}
@@ -309,8 +311,7 @@ bool Scenario::update()
 		}
 		engine.get_actor_manager()->animate();
 	}
-	if (engine.get_actor_manager()->update(current_level))
-		hovered_actor = nullptr;
+	engine.get_actor_manager()->update(current_level);
 	if (engine.get_actor_manager()->get_next_turn())
 		next_turn();
 
@@ -329,7 +330,7 @@ bool Scenario::update()
 					const std::string defeats[1] = {
 						"Press %A[Escape]%F to continue",
 					};
-					ui.spawn_message_box("Defeat", defeats[engine.get_rng() % 1], true);
+					ui.spawn_message_box("Defeat", defeats[engine.get_rng(RNG_COSMETIC) % 1], true);
 					engine.get_actor_manager()->clear_heroes(current_level);
 					state = GAME_OVER;
 				}
@@ -360,6 +361,8 @@ bool Scenario::update()
 	ui.update();
 
 	camera.update();
+	if (current_level != nullptr)
+		current_level->update();
 	engine.get_sound_manager()->update();
 	return true;
 }
@@ -372,8 +375,8 @@ void Scenario::render() const
 		current_level->render();
 		engine.get_actor_manager()->render(current_level);
 	}
-	int8_t map_x = (mouse_x + camera.get_cam_x()) / 32;
-	int8_t map_y = (mouse_y + camera.get_cam_y()) / 32;
+	int32_t map_x = (mouse_x + camera.get_cam_x()) / 32;
+	int32_t map_y = (mouse_y + camera.get_cam_y()) / 32;
 
 	if (node_highlight != nullptr && current_level != nullptr)
 	{
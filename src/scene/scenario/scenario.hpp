@@ -19,8 +19,8 @@
 #define OVERWORLD_HPP
 
 #include "scene.hpp"
+#include "actor.hpp"
 
-class Actor;
 class Level;
 class Texture;
 
@@ -54,7 +54,7 @@ private:
 	uint8_t anim_timer;
 	uint8_t current_depth;
 
-	Actor *hovered_actor;
+	ActorHandle hovered_actor;
 	Level *current_level;
 
 	Texture *node_highlight;
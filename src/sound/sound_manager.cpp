@@ -209,7 +209,7 @@ void SoundManager::set_playlist(PlaylistType playlist, bool instant)
 		while (next_song != prev_song)
 		{*/
 			if (playlists[current_playlist].size() > 1) // Start with a random song if there's more than one
-				next_song = engine.get_rng() % playlists[current_playlist].size();
+				next_song = engine.get_rng(RNG_COSMETIC) % playlists[current_playlist].size();
 			else next_song = 0;
 
 			/*loops += 1;
@@ -32,6 +32,8 @@
 #include "level_up_box.hpp"
 #include "text_input.hpp"
 
+#include <algorithm> // for std::min, std::max
+
 template Widget* UI::spawn_widget<LevelUpBox>(const std::string &widget_name);
 template Widget* UI::spawn_widget<TextInput>(const std::string &widget_name);
 
@@ -275,9 +277,19 @@ void UI::draw_box(uint16_t xpos, uint16_t ypos, uint8_t width, uint8_t height, b
 		}
 		return;
 	}
-	for (uint8_t x = 0; x < width; x++) // Otherwise, just draw the box
+	draw_box_cells(xpos, ypos, width, height, { 0, 0, width, height }, highlight); // Otherwise, just draw the box
+}
+void UI::draw_box_cells(int32_t xpos, int32_t ypos, uint16_t width, uint16_t height, const SDL_Rect &cells, bool highlight) const
+{
+	// Only the cells inside the given rect, for drawing a box a piece at a time
+	if (ui_background == nullptr)
+		return;
+
+	const int32_t end_x = std::min<int32_t>(cells.x + cells.w, width);
+	const int32_t end_y = std::min<int32_t>(cells.y + cells.h, height);
+	for (int32_t x = std::max<int32_t>(cells.x, 0); x < end_x; x++)
 	{
-		for (uint8_t y = 0; y < height; y++)
+		for (int32_t y = std::max<int32_t>(cells.y, 0); y < end_y; y++)
 		{
 			SDL_Rect temp_rect = { 16, 16, 16, 16 };
 			if (x == 0)
@@ -59,6 +59,7 @@ public:
 	void clear_message_box(bool pass_lock = false);
 
 	void draw_box(uint16_t xpos, uint16_t ypos, uint8_t width, uint8_t height, bool highlight = false) const;
+	void draw_box_cells(int32_t xpos, int32_t ypos, uint16_t width, uint16_t height, const SDL_Rect &cells, bool highlight = false) const;
 
 	bool get_overlap(int16_t xpos, int16_t ypos);
 	bool get_click(int16_t xpos, int16_t ypos);
@@ -260,7 +260,7 @@ bool LevelUpBox::get_click(int16_t mouse_x, int16_t mouse_y)
 		{
 			temp_hero->level_up();
 			temp_hero->set_status(STATUS_NONE);
-			temp_hero->remove_ability("level-up");
+			temp_hero->remove_ability(ABILITY_LEVEL_UP);
 
 			auto health = temp_hero->get_health();
 			if (temp_hero->get_hero_class() == HC_PEON)
@@ -0,0 +1,70 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+#include "engine.hpp"
+#include "bench.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+// Headless benchmarks for the pathfinding and level code. Every case builds its own
+// data and prints its own table, run them all or just the ones named on the command line.
+// Like eosos-genbench, nothing here touches SDL.
+
+Engine engine;
+
+const BenchCase bench_cases[] =
+{
+	{ "turns", "passing the turn with the turn scheduler against the old scan over every actor", bench_turns },
+	{ "downhill", "flow field downhill step, dense grid against the old whole-map scan", bench_downhill },
+	{ "large", "1024x1024 map, flood field and A* past the old 8-bit limits", bench_large_map },
+	{ "hierarchy", "HPA* query latency percentiles and path cost against the full grid A*", bench_hierarchy },
+	{ "layout", "tile loops on the old MapNode rows against the game and render planes", bench_layout },
+	{ "masks", "neighbour masks tile by tile against whole rows at once, and 5x5 windows", bench_masks },
+	{ "load", "loading a level from generator text, a binary buffer and a mapped file", bench_level_load }
+};
+
+int main(int argc, char *argv[])
+{
+	if (argc > 1 && (std::strcmp(argv[1], "-h") == 0 || std::strcmp(argv[1], "--help") == 0))
+	{
+		std::cout << "Usage: eosos-bench [case ...]" << std::endl;
+		for (const BenchCase &bench : bench_cases)
+			std::printf("  %-12s %s\n", bench.name, bench.description);
+		return 0;
+	}
+	uint8_t ran = 0;
+	for (const BenchCase &bench : bench_cases)
+	{
+		bool selected = (argc < 2);
+		for (int i = 1; i < argc && !selected; i++)
+			selected = (std::strcmp(argv[i], bench.name) == 0);
+		if (!selected)
+			continue;
+
+		std::cout << "== " << bench.name << ": " << bench.description << std::endl;
+		bench.run();
+		std::cout << std::endl;
+		ran += 1;
+	}
+	if (ran == 0)
+	{
+		std::cerr << "No such benchmark, see eosos-bench --help" << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,52 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+#include <chrono>
+#include <vector>
+
+typedef struct
+{
+	const char *name;
+	const char *description;
+	void (*run)();
+}
+BenchCase;
+
+inline uint64_t get_bench_us()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// The cases, grouped by the file they live in
+
+// bench_actor.cpp
+void bench_turns();
+
+// bench_path.cpp
+void bench_downhill();
+void bench_large_map();
+void bench_hierarchy();
+
+// bench_level.cpp
+void bench_layout();
+void bench_masks();
+void bench_level_load();
+
+#endif // BENCH_HPP
@@ -0,0 +1,140 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "engine.hpp"
+#include "bench.hpp"
+#include "headless.hpp"
+#include "actor.hpp"
+#include "actor_pool.hpp"
+#include "actor_world.hpp"
+#include "turn_scheduler.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+void bench_turns()
+{
+	// Passing the turn around a crowd of actors, then the same with one dying and one rising every turn
+	const uint32_t sizes[3] = { 100, 1000, 10000 };
+
+	std::printf("%6s  %-6s  %10s  %12s  %7s\n", "actors", "turns", "scan ns", "scheduler ns", "speedup");
+	for (uint32_t size : sizes)
+	{
+		ActorPool pool;
+		ActorWorld world;
+		TurnScheduler scheduler;
+		std::vector<Actor*> actors;
+
+		for (uint32_t i = 0; i < size; i++)
+		{
+			Actor *actor = pool.create(ACTOR_PROP);
+			world.attach(actor);
+			actors.push_back(actor);
+			scheduler.insert(actor);
+		}
+		scheduler.set_current(actors.front());
+
+		// The scan is quadratic over a round, so it only gets one
+		const uint32_t scan_turns = size;
+		const uint32_t scheduler_turns = std::max<uint32_t>(size, 2000000);
+		bool round_over = false;
+		uint32_t rounds = 0;
+
+		Actor *current = actors.front();
+		uint64_t start = get_bench_us();
+		for (uint32_t turn = 0; turn < scan_turns; turn++)
+		{
+			current = scan_next_actor(actors, current->get_ID(), round_over);
+			rounds += round_over;
+		}
+		const uint64_t scan_us = get_bench_us() - start;
+
+		start = get_bench_us();
+		for (uint32_t turn = 0; turn < scheduler_turns; turn++)
+		{
+			scheduler.advance(round_over);
+			rounds += round_over;
+		}
+		const uint64_t scheduler_us = get_bench_us() - start;
+
+		// Deleting went through the actor list the same way, and so did spawning after it
+		const uint32_t churn_turns = std::min<uint32_t>(size, 1000);
+		current = actors.front();
+		start = get_bench_us();
+		for (uint32_t turn = 0; turn < churn_turns; turn++)
+		{
+			Actor *dead = actors[(turn * 7919) % actors.size()];
+			if (dead == current)
+				continue;
+			actors.erase(std::remove(actors.begin(), actors.end(), dead), actors.end());
+			world.detach(dead);
+			pool.destroy(dead);
+
+			Actor *actor = pool.create(ACTOR_PROP);
+			world.attach(actor);
+			actors.push_back(actor);
+			current = scan_next_actor(actors, current->get_ID(), round_over);
+		}
+		const uint64_t scan_churn_us = get_bench_us() - start;
+
+		// The scheduler gets the same deaths and births, its list is only there to pick who dies
+		scheduler.free();
+		for (Actor *actor : actors)
+			scheduler.insert(actor);
+		current = actors.front();
+		scheduler.set_current(current);
+
+		start = get_bench_us();
+		for (uint32_t turn = 0; turn < churn_turns; turn++)
+		{
+			const uint32_t index = (turn * 7919) % actors.size();
+			Actor *dead = actors[index];
+			if (dead == current)
+				continue;
+			actors[index] = actors.back();
+			actors.pop_back();
+			scheduler.remove(dead);
+			world.detach(dead);
+			pool.destroy(dead);
+
+			Actor *actor = pool.create(ACTOR_PROP);
+			world.attach(actor);
+			actors.push_back(actor);
+			scheduler.insert(actor);
+			current = scheduler.advance(round_over);
+		}
+		const uint64_t scheduler_churn_us = get_bench_us() - start;
+
+		const double scan_ns = 1000.0 * scan_us / scan_turns;
+		const double scheduler_ns = 1000.0 * scheduler_us / scheduler_turns;
+		const double scan_churn_ns = 1000.0 * scan_churn_us / churn_turns;
+		const double scheduler_churn_ns = 1000.0 * scheduler_churn_us / churn_turns;
+		std::printf("%6u  %-6s  %10.1f  %12.1f  %6.0fx\n", size, "pass", scan_ns, scheduler_ns, scan_ns / std::max(scheduler_ns, 0.001));
+		std::printf("%6s  %-6s  %10.1f  %12.1f  %6.0fx\n", "", "churn", scan_churn_ns, scheduler_churn_ns,
+			scan_churn_ns / std::max(scheduler_churn_ns, 0.001));
+
+		scheduler.free();
+		for (Actor *actor : actors)
+		{
+			world.detach(actor);
+			pool.destroy(actor);
+		}
+		pool.free();
+		world.free();
+	}
+}
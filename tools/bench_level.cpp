@@ -0,0 +1,362 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "engine.hpp"
+#include "bench.hpp"
+#include "headless.hpp"
+#include "level.hpp"
+#include "level_file.hpp"
+#include "texture.hpp"
+
+#include <cstdio>
+#include <string>
+
+// Used for looping all neighbouring nodes
+const int8_t offset_x[8] = { 0, 0, -1, 1, -1, 1, -1, 1 };
+const int8_t offset_y[8] = { -1, 1, 0, 0, -1, -1, 1, 1 };
+
+// The tile loops as they ran on the old row vectors, one MapNode per tile
+static bool animate_rows(std::vector< std::vector<MapNode> > &map_data, std::mt19937 &rng)
+{
+	bool refresh_texture = false;
+	for (coord_t y = 0; y < map_data.size(); y++)
+	{
+		for (coord_t x = 0; x < map_data[y].size(); x++)
+		{
+			if (map_data[y][x].wall_animated && map_data[y][x].wall_texture != nullptr)
+			{
+				if (map_data[y][x].wall_type == NT_HILL && rng() % 3 == 0)
+					continue;
+				if (map_data[y][x].wall_rect.y < map_data[y][x].wall_texture->get_height() / 2)
+					map_data[y][x].wall_rect.y += map_data[y][x].wall_texture->get_height() / 2;
+				else map_data[y][x].wall_rect.y -= map_data[y][x].wall_texture->get_height() / 2;
+
+				map_data[y][x].node_rendered = false;
+				refresh_texture = true;
+			}
+		}
+	}
+	return refresh_texture;
+}
+static uint32_t refresh_rows(std::vector< std::vector<MapNode> > &map_data, bool animated_only)
+{
+	// Stands in for the draw calls, the walk over the nodes is what's measured
+	uint32_t drawn = 0;
+	for (coord_t y = 0; y < map_data.size(); y++)
+	{
+		for (coord_t x = 0; x < map_data[y].size(); x++)
+		{
+			if (map_data[y][x].node_rendered)
+				continue;
+			if (animated_only && !map_data[y][x].wall_animated)
+				continue;
+			map_data[y][x].node_rendered = true;
+
+			if (map_data[y][x].floor_texture != nullptr)
+				drawn += map_data[y][x].floor_rect.x + 1;
+			if (map_data[y][x].wall_texture != nullptr && map_data[y][x].wall_type != NT_INVISIBLE)
+				drawn += map_data[y][x].wall_rect.y + 1;
+		}
+	}
+	return drawn;
+}
+static bool get_wall_rows(const std::vector< std::vector<MapNode> > &map_data, int32_t xpos, int32_t ypos)
+{
+	if (xpos < 0 || ypos < 0 || ypos >= (int32_t)map_data.size() || xpos >= (int32_t)map_data[ypos].size())
+		return true;
+	if (map_data[ypos][xpos].wall_type == NT_ROAD || map_data[ypos][xpos].wall_type == NT_BASE)
+		return false;
+	return map_data[ypos][xpos].wall_texture != nullptr;
+}
+
+// The same loops over the two planes, gameplay reads never touch the render plane
+static bool animate_planes(const std::vector<GameNode> &game_nodes, std::vector<RenderNode> &render_nodes, std::mt19937 &rng)
+{
+	bool refresh_texture = false;
+	for (uint32_t i = 0; i < render_nodes.size(); i++)
+	{
+		RenderNode &render = render_nodes[i];
+		if (render.wall_animated && render.wall_texture != nullptr)
+		{
+			if (game_nodes[i].wall_type == NT_HILL && rng() % 3 == 0)
+				continue;
+			if (render.wall_rect.y < render.wall_texture->get_height() / 2)
+				render.wall_rect.y += render.wall_texture->get_height() / 2;
+			else render.wall_rect.y -= render.wall_texture->get_height() / 2;
+
+			render.node_rendered = false;
+			refresh_texture = true;
+		}
+	}
+	return refresh_texture;
+}
+static uint32_t refresh_planes(const std::vector<GameNode> &game_nodes, std::vector<RenderNode> &render_nodes, bool animated_only)
+{
+	uint32_t drawn = 0;
+	for (uint32_t i = 0; i < render_nodes.size(); i++)
+	{
+		RenderNode &render = render_nodes[i];
+		if (render.node_rendered)
+			continue;
+		if (animated_only && !render.wall_animated)
+			continue;
+		render.node_rendered = true;
+
+		if (render.floor_texture != nullptr)
+			drawn += render.floor_rect.x + 1;
+		if (render.wall_texture != nullptr && game_nodes[i].wall_type != NT_INVISIBLE)
+			drawn += render.wall_rect.y + 1;
+	}
+	return drawn;
+}
+void bench_layout()
+{
+	// Animating, redrawing and the neighbour reads a search does for every tile, on the old rows
+	// and on the planes. The draw calls themselves need a renderer and are left out.
+	const coord_t sizes[3] = { 64, 255, 1024 };
+	static Texture texture;
+
+	std::printf("%9s  %-10s  %10s  %10s  %7s\n", "map", "loop", "rows us", "planes us", "speedup");
+	for (coord_t size : sizes)
+	{
+		LevelWriter writer;
+		fill_level(writer, size, size, 20, 9);
+
+		Level level;
+		if (!load_level(level, writer))
+		{
+			std::cerr << "Could not load the benchmark level" << std::endl;
+			return;
+		}
+		// Both layouts get the same nodes, every fourth wall animated and every eighth a hill
+		std::vector< std::vector<MapNode> > map_data(size, std::vector<MapNode>(size));
+		std::vector<GameNode> game_nodes;
+		std::vector<RenderNode> render_nodes;
+		uint32_t walls = 0;
+		for (coord_t y = 0; y < size; y++)
+		{
+			for (coord_t x = 0; x < size; x++)
+			{
+				MapNode node = level.get_node(x, y);
+				node.floor_texture = &texture;
+				if (node.wall_texture != nullptr)
+				{
+					node.wall_texture = &texture;
+					node.wall_animated = (walls % 4 == 0);
+					node.wall_type = (walls % 8 == 0) ? NT_HILL : node.wall_type;
+					walls += 1;
+				}
+				node.node_rendered = true;
+				map_data[y][x] = node;
+				game_nodes.push_back({ node.occupying_actor, node.wall_type });
+				render_nodes.push_back({ node.floor_texture, node.wall_texture, node.floor_rect, node.wall_rect,
+					node.wall_animated, node.node_rendered, false });
+			}
+		}
+		const uint32_t rounds = std::max(1, 4000000 / (size * size));
+		uint32_t rows_sum = 0, planes_sum = 0;
+
+		std::mt19937 rows_rng(1);
+		uint64_t start = get_bench_us();
+		for (uint32_t round = 0; round < rounds; round++)
+		{
+			if (animate_rows(map_data, rows_rng))
+				rows_sum += refresh_rows(map_data, true);
+		}
+		const uint64_t rows_animate_us = get_bench_us() - start;
+
+		std::mt19937 planes_rng(1);
+		start = get_bench_us();
+		for (uint32_t round = 0; round < rounds; round++)
+		{
+			if (animate_planes(game_nodes, render_nodes, planes_rng))
+				planes_sum += refresh_planes(game_nodes, render_nodes, true);
+		}
+		const uint64_t planes_animate_us = get_bench_us() - start;
+
+		// Every tile asks about its eight neighbours, the old way one get_wall at a time
+		// and now through the wall mask the searches read
+		uint32_t rows_blocked = 0, planes_blocked = 0;
+		start = get_bench_us();
+		for (uint32_t round = 0; round < rounds; round++)
+		{
+			for (coord_t y = 0; y < size; y++)
+			{
+				for (coord_t x = 0; x < size; x++)
+				{
+					for (uint8_t i = 0; i < 8; i++)
+						rows_blocked += get_wall_rows(map_data, x + offset_x[i], y + offset_y[i]);
+				}
+			}
+		}
+		const uint64_t rows_wall_us = get_bench_us() - start;
+
+		start = get_bench_us();
+		for (uint32_t round = 0; round < rounds; round++)
+		{
+			for (coord_t y = 0; y < size; y++)
+			{
+				for (coord_t x = 0; x < size; x++)
+					planes_blocked += __builtin_popcount(level.get_wall_mask(x, y));
+			}
+		}
+		const uint64_t planes_wall_us = get_bench_us() - start;
+
+		// Both sides did the same work, otherwise the timings don't mean anything
+		if (rows_sum != planes_sum || rows_blocked != planes_blocked)
+			std::cerr << "The layouts disagree on " << size << "x" << size << std::endl;
+
+		std::printf("%4dx%-4d  %-10s  %10.1f  %10.1f  %6.1fx\n", size, size, "animate",
+			(double)rows_animate_us / rounds, (double)planes_animate_us / rounds,
+			(double)rows_animate_us / std::max<uint64_t>(planes_animate_us, 1));
+		std::printf("%9s  %-10s  %10.1f  %10.1f  %6.1fx\n", "", "walls",
+			(double)rows_wall_us / rounds, (double)planes_wall_us / rounds,
+			(double)rows_wall_us / std::max<uint64_t>(planes_wall_us, 1));
+	}
+}
+void bench_masks()
+{
+	// What a search reads per tile, the neighbour mask and the 5x5 window, against every mask
+	// of a row coming out of the same few words at once
+	const coord_t sizes[3] = { 64, 255, 1024 };
+
+	std::printf("%9s  %10s  %10s  %7s  %10s\n", "map", "tile us", "row us", "speedup", "window us");
+	for (coord_t size : sizes)
+	{
+		LevelWriter writer;
+		fill_level(writer, size, size, 20, 9);
+
+		Level level;
+		if (!load_level(level, writer))
+		{
+			std::cerr << "Could not load the benchmark level" << std::endl;
+			return;
+		}
+		const BitGrid &grid = level.get_wall_grid();
+		const uint32_t rounds = std::max(1, 4000000 / (size * size));
+		uint32_t tile_sum = 0, row_sum = 0, window_north = 0;
+
+		uint64_t start = get_bench_us();
+		for (uint32_t round = 0; round < rounds; round++)
+		{
+			for (coord_t y = 0; y < size; y++)
+			{
+				for (coord_t x = 0; x < size; x++)
+					tile_sum += grid.get_neighbors(x, y);
+			}
+		}
+		const uint64_t tile_us = get_bench_us() - start;
+
+		std::vector<uint8_t> masks(size);
+		start = get_bench_us();
+		for (uint32_t round = 0; round < rounds; round++)
+		{
+			for (coord_t y = 0; y < size; y++)
+			{
+				grid.get_row_neighbors(0, y, size, masks.data());
+				for (coord_t x = 0; x < size; x++)
+					row_sum += masks[x];
+			}
+		}
+		const uint64_t row_us = get_bench_us() - start;
+
+		start = get_bench_us();
+		for (uint32_t round = 0; round < rounds; round++)
+		{
+			for (coord_t y = 0; y < size; y++)
+			{
+				for (coord_t x = 0; x < size; x++)
+					window_north += (grid.get_window(x, y) >> 7) & 1;
+			}
+		}
+		const uint64_t window_us = get_bench_us() - start;
+
+		// Bit 7 of a window is the tile north of its middle, the same tile as bit 0 of the mask
+		uint32_t north = 0;
+		for (coord_t y = 0; y < size; y++)
+		{
+			for (coord_t x = 0; x < size; x++)
+				north += grid.get_neighbors(x, y) & 1;
+		}
+		if (tile_sum != row_sum || window_north != north * rounds)
+			std::cerr << "The masks disagree on " << size << "x" << size << std::endl;
+
+		std::printf("%4dx%-4d  %10.1f  %10.1f  %6.1fx  %10.1f\n", size, size,
+			(double)tile_us / rounds, (double)row_us / rounds,
+			(double)tile_us / std::max<uint64_t>(row_us, 1), (double)window_us / rounds);
+	}
+}
+void bench_level_load()
+{
+	// The same level loaded from generator text, from a binary buffer and from a mapped file.
+	// The cluster graph is left out, it would cost both formats the same and hide the difference.
+	const coord_t sizes[3] = { 64, 255, 1024 };
+	const std::string path = "eosos-bench.lvl";
+
+	std::printf("%7s  %9s  %9s  %9s  %9s  %9s\n", "map", "text KB", "binary KB", "text us", "buffer us", "file us");
+	for (coord_t size : sizes)
+	{
+		LevelWriter writer;
+		fill_level(writer, size, size, 20, 17);
+		const std::string text = writer.get_text();
+		const std::vector<uint8_t> binary = writer.get_binary();
+		if (!writer.write(path))
+		{
+			std::cerr << "Could not write " << path << std::endl;
+			return;
+		}
+		const uint32_t rounds = std::max(1, 1000000 / (size * size));
+		Level text_level, binary_level;
+		bool loaded = true;
+
+		uint64_t start = get_bench_us();
+		for (uint32_t round = 0; round < rounds; round++)
+			loaded &= text_level.load(text, false);
+		const uint64_t text_us = get_bench_us() - start;
+
+		start = get_bench_us();
+		for (uint32_t round = 0; round < rounds; round++)
+		{
+			LevelFile level_file;
+			loaded &= level_file.open(binary.data(), binary.size()) && binary_level.load(level_file, false);
+		}
+		const uint64_t buffer_us = get_bench_us() - start;
+
+		start = get_bench_us();
+		for (uint32_t round = 0; round < rounds; round++)
+		{
+			LevelFile level_file;
+			loaded &= level_file.open(path) && binary_level.load(level_file, false);
+		}
+		const uint64_t file_us = get_bench_us() - start;
+		std::remove(path.c_str());
+
+		// Both formats have to end up with the same walls
+		uint32_t mismatched = 0;
+		for (coord_t y = 0; y < size; y++)
+		{
+			for (coord_t x = 0; x < size; x++)
+				mismatched += (text_level.get_wall(x, y) != binary_level.get_wall(x, y));
+		}
+		if (!loaded || mismatched != 0)
+			std::cerr << "The formats loaded differently on " << size << "x" << size << std::endl;
+
+		std::printf("%3dx%-3d  %9.1f  %9.1f  %9.1f  %9.1f  %9.1f\n", size, size, text.size() / 1024.0, binary.size() / 1024.0,
+			(double)text_us / rounds, (double)buffer_us / rounds, (double)file_us / rounds);
+	}
+}
@@ -0,0 +1,292 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+#include "engine.hpp"
+#include "bench.hpp"
+#include "headless.hpp"
+#include "level.hpp"
+#include "level_file.hpp"
+#include "dijkstra.hpp"
+#include "path_engine.hpp"
+#include "path_hierarchy.hpp"
+#include "actor.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+// The flow field as it used to be, one entry per reached tile in a flat list
+typedef struct
+{
+	coord_t x, y;
+	dist_t distance;
+}
+ScanNode;
+
+static Point scan_downhill(Level &level, const std::vector<ScanNode> &nodes, Point pos)
+{
+	// What Dijkstra::get_node_downhill did before the dense grid, every step went through the whole list
+	std::vector<ScanNode> neighbors;
+	for (const ScanNode &n : nodes)
+	{
+		if (std::abs(n.x - pos.x) < 2 && std::abs(n.y - pos.y) < 2)
+			neighbors.push_back(n);
+	}
+	ScanNode next = { pos.x, pos.y, DIJKSTRA_UNREACHED };
+	dist_t prev_dist = DIJKSTRA_UNREACHED;
+
+	for (const ScanNode &n : neighbors)
+	{
+		if (n.x == pos.x && n.y == pos.y)
+		{
+			if (n.distance > 0)
+			{
+				prev_dist = n.distance;
+				continue;
+			}
+			else return pos;
+		}
+		Actor *temp_actor = level.get_actor(n.x, n.y);
+		if (temp_actor != nullptr && temp_actor->get_actor_type() == ACTOR_MONSTER)
+			continue;
+
+		if (n.distance < next.distance)
+			next = n;
+		else if (n.distance == next.distance && n.y == pos.y)
+			next = n;
+	}
+	return (prev_dist < next.distance) ? pos : Point(next.x, next.y);
+}
+void bench_downhill()
+{
+	const coord_t sizes[2][2] = { { 25, 15 }, { 255, 255 } };
+
+	std::printf("%9s  %7s  %10s  %10s  %7s  %8s\n", "map", "queries", "scan ns", "grid ns", "speedup", "uphill");
+	for (const coord_t *size : sizes)
+	{
+		LevelWriter writer;
+		fill_level(writer, size[0], size[1], 20, 1);
+
+		Level level;
+		if (!load_level(level, writer))
+		{
+			std::cerr << "Could not load the benchmark level" << std::endl;
+			return;
+		}
+		// Flowing towards the open tile closest to the middle, the way monsters walk to the base
+		const std::vector<int32_t> open = get_open_tiles(level);
+		const int32_t middle = (size[1] / 2) * size[0] + size[0] / 2;
+		int32_t goal = open[0];
+		for (int32_t tile : open)
+		{
+			if (std::abs(tile - middle) < std::abs(goal - middle))
+				goal = tile;
+		}
+		Dijkstra map;
+		map.build_map(&level, std::vector<int32_t>(1, goal));
+
+		std::vector<ScanNode> nodes;
+		std::vector<Point> queries;
+		for (int32_t tile : open)
+		{
+			const coord_t x = tile % size[0], y = tile / size[0];
+			if (map.get_distance(x, y) == DIJKSTRA_UNREACHED)
+				continue;
+			nodes.push_back({ x, y, map.get_distance(x, y) });
+			queries.push_back(Point(x, y));
+		}
+		// The scan is quadratic over a whole pass, so the big map only gets a sample of it
+		const uint32_t query_count = std::min<uint32_t>(queries.size(), (size[0] * size[1] > 1000) ? 2000 : queries.size());
+		const uint32_t grid_rounds = 200000 / query_count + 1;
+		const uint32_t scan_rounds = (size[0] * size[1] > 1000) ? 1 : grid_rounds;
+
+		// Every step has to go downhill (or stay at the goal), otherwise the monsters would wander
+		uint32_t uphill = 0;
+		const uint64_t scan_start = get_bench_us();
+		for (uint32_t round = 0; round < scan_rounds; round++)
+		{
+			for (uint32_t i = 0; i < query_count; i++)
+			{
+				const Point next = scan_downhill(level, nodes, queries[i]);
+				uphill += (round == 0 && map.get_distance(next.x, next.y) >= map.get_distance(queries[i].x, queries[i].y) &&
+					map.get_distance(queries[i].x, queries[i].y) > 0);
+			}
+		}
+		const uint64_t scan_us = get_bench_us() - scan_start;
+
+		const uint64_t grid_start = get_bench_us();
+		for (uint32_t round = 0; round < grid_rounds; round++)
+		{
+			for (uint32_t i = 0; i < query_count; i++)
+			{
+				const Point next = map.get_node_downhill(&level, queries[i]);
+				uphill += (round == 0 && map.get_distance(next.x, next.y) >= map.get_distance(queries[i].x, queries[i].y) &&
+					map.get_distance(queries[i].x, queries[i].y) > 0);
+			}
+		}
+		const uint64_t grid_us = get_bench_us() - grid_start;
+
+		const double scan_ns = 1000.0 * scan_us / ((uint64_t)scan_rounds * query_count);
+		const double grid_ns = 1000.0 * grid_us / ((uint64_t)grid_rounds * query_count);
+		std::printf("%4dx%-4d  %7u  %10.1f  %10.1f  %6.0fx  %8u\n", size[0], size[1], query_count,
+			scan_ns, grid_ns, scan_ns / std::max(grid_ns, 0.001), uphill);
+	}
+}
+void bench_large_map()
+{
+	// An endless mode sized map, everything past 255 tiles used to wrap or saturate
+	const coord_t width = 1024, height = 1024;
+
+	LevelWriter writer;
+	fill_level(writer, width, height, 15, 5);
+
+	Level level;
+	const uint64_t load_start = get_bench_us();
+	if (!load_level(level, writer))
+	{
+		std::cerr << "Could not load the benchmark level" << std::endl;
+		return;
+	}
+	const uint64_t load_us = get_bench_us() - load_start;
+
+	const std::vector<int32_t> open = get_open_tiles(level);
+	const int32_t goal = open.front();
+	Dijkstra map;
+	const uint64_t flood_start = get_bench_us();
+	map.build_map(&level, std::vector<int32_t>(1, goal));
+	const uint64_t flood_us = get_bench_us() - flood_start;
+
+	// The farthest reached tile, walked back down to the goal one step at a time
+	Point far(goal % width, goal / width);
+	dist_t max_distance = 0;
+	uint32_t reached = 0;
+	for (int32_t tile : open)
+	{
+		const dist_t distance = map.get_distance(tile % width, tile / width);
+		if (distance == DIJKSTRA_UNREACHED)
+			continue;
+		reached += 1;
+		if (distance > max_distance)
+		{
+			max_distance = distance;
+			far = Point(tile % width, tile / width);
+		}
+	}
+	uint32_t steps = 0, bad_steps = 0;
+	for (Point pos = far; map.get_distance(pos.x, pos.y) > 0 && steps <= max_distance; steps++)
+	{
+		const Point next = map.get_node_downhill(&level, pos);
+		bad_steps += (map.get_distance(next.x, next.y) + 1 != map.get_distance(pos.x, pos.y));
+		pos = next;
+	}
+	bad_steps += (steps != max_distance);
+
+	// A* across the same span, every step has to stay next to the previous one
+	std::vector<Point> path;
+	const uint64_t path_start = get_bench_us();
+	const bool found = level.get_path_engine()->find_path(&level, Point(goal % width, goal / width), far, 0, path);
+	const uint64_t path_us = get_bench_us() - path_start;
+
+	uint32_t bad_links = (!found || path.empty());
+	for (size_t i = 1; i < path.size(); i++)
+	{
+		bad_links += (std::abs(path[i].x - path[i - 1].x) > 1 || std::abs(path[i].y - path[i - 1].y) > 1 ||
+			path[i].x >= width || path[i].y >= height);
+	}
+	std::printf("%-22s %4dx%d\n", "map", width, height);
+	std::printf("%-22s %u of %u\n", "reached tiles", reached, (uint32_t)open.size());
+	std::printf("%-22s %.1f ms\n", "load", load_us / 1000.0);
+	std::printf("%-22s %.1f ms\n", "flood field", flood_us / 1000.0);
+	std::printf("%-22s %u\n", "max distance", (uint32_t)max_distance);
+	std::printf("%-22s %u steps, %u wrong\n", "downhill walk", steps, bad_steps);
+	std::printf("%-22s %.1f ms\n", "A* 4-way to far", path_us / 1000.0);
+	std::printf("%-22s %u nodes, %u broken links\n", "A* path", (uint32_t)path.size(), bad_links);
+}
+static double get_path_cost(const std::vector<Point> &path)
+{
+	double cost = 0.0;
+	for (size_t i = 1; i < path.size(); i++)
+		cost += (path[i].x != path[i - 1].x && path[i].y != path[i - 1].y) ? 1.4 : 1.0;
+	return cost;
+}
+static double get_percentile(std::vector<uint64_t> &samples, uint8_t percent)
+{
+	if (samples.empty())
+		return 0.0;
+	std::sort(samples.begin(), samples.end());
+	return (double)samples[std::min<size_t>(samples.size() - 1, samples.size() * percent / 100)];
+}
+void bench_hierarchy()
+{
+	// Random clicks the way the hero walks, 8-way, against a full grid search for every one
+	const coord_t sizes[2] = { 256, 512 };
+	const uint32_t query_count = 500;
+
+	std::printf("%7s  %-6s  %9s  %9s  %9s  %6s  %10s\n", "map", "search", "p50 us", "p95 us", "p99 us", "found", "cost ratio");
+	for (coord_t size : sizes)
+	{
+		LevelWriter writer;
+		fill_level(writer, size, size, 20, 7);
+
+		Level level;
+		if (!load_level(level, writer))
+		{
+			std::cerr << "Could not load the benchmark level" << std::endl;
+			return;
+		}
+		const std::vector<int32_t> open = get_open_tiles(level);
+		std::mt19937 rng(11);
+
+		std::vector<uint64_t> grid_us, cluster_us;
+		uint32_t grid_found = 0, cluster_found = 0;
+		double grid_cost = 0.0, cluster_cost = 0.0;
+		for (uint32_t i = 0; i < query_count; i++)
+		{
+			// Shorter trips never reach the cluster graph, even PATH_CLUSTER queries go straight to the grid for them
+			int32_t a, b;
+			do
+			{
+				a = open[rng() % open.size()];
+				b = open[rng() % open.size()];
+			}
+			while (std::abs(a % size - b % size) < PATH_HIERARCHY_MIN_DISTANCE && std::abs(a / size - b / size) < PATH_HIERARCHY_MIN_DISTANCE);
+			const Point start(a % size, a / size), end(b % size, b / size);
+
+			std::vector<Point> grid_path, cluster_path;
+			uint64_t start_us = get_bench_us();
+			const bool grid_ok = level.get_path_engine()->find_path(&level, start, end, 1, grid_path);
+			grid_us.push_back(get_bench_us() - start_us);
+
+			start_us = get_bench_us();
+			const bool cluster_ok = level.get_path_hierarchy()->find_path(&level, start, end, 1, cluster_path);
+			cluster_us.push_back(get_bench_us() - start_us);
+
+			grid_found += grid_ok;
+			cluster_found += cluster_ok;
+			// Only pairs both found count towards how much longer the cluster paths run
+			if (grid_ok && cluster_ok)
+			{
+				grid_cost += get_path_cost(grid_path);
+				cluster_cost += get_path_cost(cluster_path);
+			}
+		}
+		std::printf("%3dx%-3d  %-6s  %9.0f  %9.0f  %9.0f  %6u  %10s\n", size, size, "grid",
+			get_percentile(grid_us, 50), get_percentile(grid_us, 95), get_percentile(grid_us, 99), grid_found, "1.000");
+		std::printf("%7s  %-6s  %9.0f  %9.0f  %9.0f  %6u  %10.3f\n", "", "hpa",
+			get_percentile(cluster_us, 50), get_percentile(cluster_us, 95), get_percentile(cluster_us, 99), cluster_found,
+			cluster_cost / std::max(grid_cost, 1.0));
+	}
+}
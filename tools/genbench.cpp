@@ -0,0 +1,186 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+#include "engine.hpp"
+#include "level.hpp"
+#include "level_file.hpp"
+#include "generator_forest.hpp"
+#include "path_engine.hpp"
+#include "path_grid.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+// Headless level generator benchmark. Generates a batch of forest levels per depth
+// on every core, checks that each spawn has a road to the base and writes the stats.
+// Nothing here touches SDL, the game objects are only linked in for the generator.
+
+Engine engine;
+
+typedef struct
+{
+	uint8_t depth;
+	uint32_t seed;
+	uint16_t discarded;
+	uint16_t spawns;
+	bool connected;
+	uint32_t road_length;
+	uint32_t base_distance;
+	uint32_t time_us;
+}
+BenchLevel;
+
+typedef struct
+{
+	uint32_t levels;
+	uint32_t attempts;
+	uint32_t invalid;
+	uint64_t road_length;
+	uint64_t base_distance;
+	uint64_t time_us;
+}
+BenchDepth;
+
+static void bench_level(const GeneratorForest &generator, PathEngine &path_engine, BenchLevel &level)
+{
+	const auto start = std::chrono::steady_clock::now();
+
+	LevelWriter writer;
+	level.discarded = generator.generate(level.depth, level.seed, writer);
+
+	// The road gets dug along the spawn to base path later on, so an unreachable base means a broken level
+	PathGrid grid;
+	grid.init(writer);
+
+	const std::pair<coord_t, coord_t> base = writer.get_base_pos();
+	const std::vector< std::pair<coord_t, coord_t> > &spawns = writer.get_spawn_positions();
+	std::vector<Point> path;
+
+	level.spawns = spawns.size();
+	level.connected = !spawns.empty();
+	level.road_length = 0;
+	level.base_distance = 0;
+
+	for (const std::pair<coord_t, coord_t> &spawn : spawns)
+	{
+		path.clear();
+		if (!path_engine.find_path(&grid, Point(spawn.first, spawn.second), Point(base.first, base.second), 0, path))
+		{
+			level.connected = false;
+			continue;
+		}
+		const uint32_t distance = std::max(std::abs(spawn.first - base.first), std::abs(spawn.second - base.second));
+		level.road_length += path.size();
+		level.base_distance += distance;
+	}
+	if (!spawns.empty())
+	{
+		level.road_length /= spawns.size();
+		level.base_distance /= spawns.size();
+	}
+	const auto end = std::chrono::steady_clock::now();
+	level.time_us = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+}
+int main(int argc, char *argv[])
+{
+	if (argc > 1 && (std::string(argv[1]) == "-h" || std::string(argv[1]) == "--help"))
+	{
+		std::cout << "Usage: eosos-genbench [levels per depth] [max depth] [threads] [seed] [output.csv]" << std::endl;
+		return 0;
+	}
+	const uint32_t level_count = (argc > 1) ? std::max(1, std::atoi(argv[1])) : 1000;
+	const uint8_t max_depth = (argc > 2) ? std::min(std::max(1, std::atoi(argv[2])), 255) : 5;
+	const uint32_t thread_count = (argc > 3) ? std::max(1, std::atoi(argv[3])) : std::max(1u, std::thread::hardware_concurrency());
+	const uint32_t world_seed = (argc > 4) ? (uint32_t)std::strtoul(argv[4], nullptr, 10) : std::random_device()();
+	const std::string output_path = (argc > 5) ? argv[5] : "genbench.csv";
+
+	// Level i of every depth gets its seed the same way the game does for world seed + i,
+	// so any level in the output can be reproduced from the seed column alone
+	std::vector<BenchLevel> levels(level_count * max_depth);
+	for (uint8_t depth = 1; depth <= max_depth; depth++)
+	{
+		for (uint32_t i = 0; i < level_count; i++)
+		{
+			BenchLevel &level = levels[(depth - 1) * level_count + i];
+			level.depth = depth;
+			level.seed = Level::get_depth_seed(world_seed + i, depth);
+		}
+	}
+	std::atomic<uint32_t> next_level(0);
+	std::vector<std::thread> workers;
+
+	const auto start = std::chrono::steady_clock::now();
+	for (uint32_t t = 0; t < thread_count; t++)
+	{
+		workers.push_back(std::thread([&levels, &next_level]()
+		{
+			// Every worker has its own generator and search state, generate() only reads its arguments
+			GeneratorForest generator;
+			PathEngine path_engine;
+
+			for (uint32_t i = next_level++; i < levels.size(); i = next_level++)
+				bench_level(generator, path_engine, levels[i]);
+		}));
+	}
+	for (std::thread &worker : workers)
+		worker.join();
+
+	const auto end = std::chrono::steady_clock::now();
+	const uint64_t total_ms = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+
+	std::ofstream output(output_path);
+	if (output.is_open())
+	{
+		output << "depth,seed,discarded,spawns,connected,road_length,base_distance,time_us\n";
+		for (const BenchLevel &level : levels)
+		{
+			output << (int)level.depth << ',' << level.seed << ',' << level.discarded << ',' << level.spawns << ','
+				<< level.connected << ',' << level.road_length << ',' << level.base_distance << ',' << level.time_us << '\n';
+		}
+	}
+	else std::cerr << "Could not write " << output_path << std::endl;
+
+	std::vector<BenchDepth> depths(max_depth, { 0, 0, 0, 0, 0, 0 });
+	for (const BenchLevel &level : levels)
+	{
+		BenchDepth &depth = depths[level.depth - 1];
+		depth.levels += 1;
+		depth.attempts += level.discarded + 1;
+		depth.invalid += !level.connected;
+		depth.road_length += level.road_length;
+		depth.base_distance += level.base_distance;
+		depth.time_us += level.time_us;
+	}
+	std::cout << "seed " << world_seed << ", " << levels.size() << " levels on " << thread_count << " threads in " << total_ms << " ms" << std::endl;
+	std::cout << "depth  discard%  invalid  road  distance  us/level" << std::endl;
+
+	for (uint8_t i = 0; i < max_depth; i++)
+	{
+		const BenchDepth &depth = depths[i];
+		std::printf("%5d  %8.2f  %7u  %4.1f  %8.1f  %8.1f\n", i + 1,
+			100.0 * (depth.attempts - depth.levels) / depth.attempts, depth.invalid,
+			(double)depth.road_length / depth.levels, (double)depth.base_distance / depth.levels,
+			(double)depth.time_us / depth.levels);
+	}
+	return 0;
+}
@@ -0,0 +1,71 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+#include "engine.hpp"
+#include "headless.hpp"
+#include "level.hpp"
+#include "level_file.hpp"
+#include "actor.hpp"
+
+void fill_level(LevelWriter &writer, coord_t width, coord_t height, uint8_t wall_percent, uint32_t seed)
+{
+	std::mt19937 rng(seed);
+
+	writer.init(width, height);
+	writer.add_texture('0', "level/floor/dark2_base.png");
+	writer.add_texture('T', "level/tree/dark2.png");
+
+	for (coord_t y = 0; y < height; y++)
+	{
+		for (coord_t x = 0; x < width; x++)
+			writer.set_tile(x, y, '0', (rng() % 100 < wall_percent) ? 'T' : ' ');
+	}
+}
+bool load_level(Level &level, const LevelWriter &writer)
+{
+	// The level copies the tiles out of the file, the buffer only has to live through load()
+	const std::vector<uint8_t> data = writer.get_binary();
+	LevelFile level_file;
+	return level_file.open(data.data(), data.size()) && level.load(level_file);
+}
+std::vector<int32_t> get_open_tiles(const Level &level)
+{
+	std::vector<int32_t> tiles;
+	for (coord_t y = 0; y < level.get_map_height(); y++)
+	{
+		for (coord_t x = 0; x < level.get_map_width(); x++)
+		{
+			if (!level.get_wall(x, y))
+				tiles.push_back(y * level.get_map_width() + x);
+		}
+	}
+	return tiles;
+}
+Actor* scan_next_actor(const std::vector<Actor*> &actors, uint32_t current_ID, bool &round_over)
+{
+	Actor *next_actor = nullptr;
+	Actor *first_actor = nullptr;
+	for (Actor *a : actors)
+	{
+		if (a->get_ID() > current_ID && (next_actor == nullptr || a->get_ID() < next_actor->get_ID()))
+			next_actor = a;
+		if (first_actor == nullptr || a->get_ID() < first_actor->get_ID())
+			first_actor = a;
+	}
+	round_over = (next_actor == nullptr);
+	return round_over ? first_actor : next_actor;
+}
@@ -0,0 +1,39 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef HEADLESS_HPP
+#define HEADLESS_HPP
+
+#include <vector>
+
+class Actor;
+class Level;
+class LevelWriter;
+
+// Shared by the headless benchmarks and tests. Levels are put together in a LevelWriter
+// and loaded into a Level without a renderer, walls where the textures would have been.
+
+void fill_level(LevelWriter &writer, coord_t width, coord_t height, uint8_t wall_percent, uint32_t seed);
+bool load_level(Level &level, const LevelWriter &writer);
+
+// Open tiles as level indices, in row order
+std::vector<int32_t> get_open_tiles(const Level &level);
+
+// The next actor after current_ID the way ActorManager::update used to find it, scanning every actor
+Actor* scan_next_actor(const std::vector<Actor*> &actors, uint32_t current_ID, bool &round_over);
+
+#endif // HEADLESS_HPP
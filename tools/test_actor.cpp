@@ -0,0 +1,164 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "engine.hpp"
+#include "tests.hpp"
+#include "headless.hpp"
+#include "actor.hpp"
+#include "actor_pool.hpp"
+#include "actor_world.hpp"
+#include "turn_scheduler.hpp"
+
+#include <algorithm>
+
+uint32_t test_turn_order()
+{
+	// Spawning and deleting between turns, the scheduler has to pick the same actor as the old scan every time
+	const uint32_t start_count = 2000;
+	const uint32_t turn_count = 50000;
+
+	uint32_t failures = 0;
+	ActorPool pool;
+	ActorWorld world;
+	TurnScheduler scheduler;
+	std::vector<Actor*> actors;
+	std::mt19937 rng(23);
+
+	for (uint32_t i = 0; i < start_count; i++)
+	{
+		Actor *actor = pool.create(ACTOR_PROP);
+		world.attach(actor);
+		actors.push_back(actor);
+	}
+	// Inserted out of order, the turns still have to go by ID
+	std::vector<Actor*> shuffled = actors;
+	std::shuffle(shuffled.begin(), shuffled.end(), rng);
+	for (Actor *actor : shuffled)
+		scheduler.insert(actor);
+
+	Actor *current = *std::min_element(actors.begin(), actors.end(),
+		[](const Actor *a, const Actor *b) { return a->get_ID() < b->get_ID(); });
+	scheduler.set_current(current);
+
+	uint32_t rounds = 0, removed_current = 0;
+	for (uint32_t turn = 0; turn < turn_count; turn++)
+	{
+		const uint32_t current_ID = current->get_ID();
+
+		// A necromancer raising a skeleton, or something dying, sometimes the actor whose turn it was
+		const uint32_t event = rng() % 10;
+		if (event == 0)
+		{
+			Actor *actor = pool.create(ACTOR_PROP);
+			world.attach(actor);
+			actors.push_back(actor);
+			scheduler.insert(actor);
+		}
+		else if (event == 1 && actors.size() > 1)
+		{
+			const uint32_t index = (rng() % 4 == 0) ? std::find(actors.begin(), actors.end(), current) - actors.begin() : rng() % actors.size();
+			Actor *actor = actors[index];
+			removed_current += (actor == current);
+
+			scheduler.remove(actor);
+			actors.erase(actors.begin() + index);
+			world.detach(actor);
+			pool.destroy(actor);
+		}
+		bool scan_round_over = false, round_over = false;
+		Actor *expected = scan_next_actor(actors, current_ID, scan_round_over);
+		current = scheduler.advance(round_over);
+
+		if (current != expected || round_over != scan_round_over)
+		{
+			failures = check_failed(failures, "scheduler picked a different actor than the scan");
+			scheduler.set_current(expected);
+			current = expected;
+		}
+		if (scheduler.get_size() != actors.size())
+			failures = check_failed(failures, "scheduler lost track of an actor");
+		rounds += scan_round_over;
+	}
+	std::printf("  %u turns over %u rounds, %u actors removed on their own turn\n", turn_count, rounds, removed_current);
+
+	scheduler.free();
+	for (Actor *actor : actors)
+	{
+		world.detach(actor);
+		pool.destroy(actor);
+	}
+	pool.free();
+	world.free();
+	return failures;
+}
+uint32_t test_pool_handles()
+{
+	// Bigger levels hold more actors than a 16 bit slot could address, handles past it still have to resolve
+	const uint32_t actor_count = 70000;
+
+	uint32_t failures = 0;
+	ActorPool pool;
+	ActorWorld world;
+	std::vector<Actor*> actors;
+
+	for (uint32_t i = 0; i < actor_count; i++)
+	{
+		Actor *actor = pool.create(ACTOR_MONSTER);
+		if (actor == nullptr)
+		{
+			failures = check_failed(failures, "pool ran out of slots");
+			break;
+		}
+		world.attach(actor);
+		actors.push_back(actor);
+	}
+	for (Actor *actor : actors)
+	{
+		if (pool.get(actor->get_handle()) != actor)
+			failures = check_failed(failures, "handle resolved to a different actor");
+		if (world.get_position(actor->get_handle()) == nullptr)
+			failures = check_failed(failures, "handle has no components");
+	}
+
+	// Reusing a slot past the old limit must not bring the stale handle back
+	Actor *last = actors.back();
+	const ActorHandle stale = last->get_handle();
+	world.detach(last);
+	pool.destroy(last);
+
+	Actor *reused = pool.create(ACTOR_MONSTER);
+	world.attach(reused);
+	actors.back() = reused;
+
+	if (get_handle_slot(reused->get_handle()) != get_handle_slot(stale))
+		failures = check_failed(failures, "freed slot wasn't reused first");
+	if (pool.get(stale) != nullptr || world.get_position(stale) != nullptr)
+		failures = check_failed(failures, "stale handle still resolves");
+	if (pool.get(reused->get_handle()) != reused)
+		failures = check_failed(failures, "reused slot doesn't resolve");
+	std::printf("  %u actors, highest slot %u\n", pool.get_live_count(), get_handle_slot(stale));
+
+	for (Actor *actor : actors)
+	{
+		world.detach(actor);
+		pool.destroy(actor);
+	}
+	pool.free();
+	world.free();
+	return failures;
+}
@@ -0,0 +1,82 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "engine.hpp"
+#include "tests.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Every allocation in the test binary goes through here, so a test can count what a loop allocates.
+// The array, nothrow and sized forms all end up in the same malloc/free pair, so whichever form
+// the library picks for a delete it always matches the new. There's no aligned new before C++17.
+// They live apart from the tests so no caller can inline the free next to its new.
+static std::atomic<uint32_t> allocations(0);
+
+uint32_t get_allocation_count()
+{
+	return allocations;
+}
+
+void* operator new(std::size_t size)
+{
+	allocations += 1;
+	void *memory = std::malloc(size ? size : 1);
+	if (memory == nullptr)
+		throw std::bad_alloc();
+	return memory;
+}
+void* operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	try { return operator new(size); }
+	catch (const std::bad_alloc&) { return nullptr; }
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+	try { return operator new[](size); }
+	catch (const std::bad_alloc&) { return nullptr; }
+}
+void operator delete(void *memory) noexcept
+{
+	std::free(memory);
+}
+void operator delete[](void *memory) noexcept
+{
+	operator delete(memory);
+}
+void operator delete(void *memory, std::size_t) noexcept
+{
+	operator delete(memory);
+}
+void operator delete[](void *memory, std::size_t) noexcept
+{
+	operator delete[](memory);
+}
+void operator delete(void *memory, const std::nothrow_t&) noexcept
+{
+	operator delete(memory);
+}
+void operator delete[](void *memory, const std::nothrow_t&) noexcept
+{
+	operator delete[](memory);
+}
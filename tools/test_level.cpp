@@ -0,0 +1,275 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+
+#include "engine.hpp"
+#include "tests.hpp"
+#include "headless.hpp"
+#include "level.hpp"
+#include "level_file.hpp"
+#include "bit_grid.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <random>
+
+uint32_t test_tile_walk()
+{
+	// GeneratorForest::post_process also digs the road and spawns the crops, which needs a renderer
+	// and an actor manager, but its walk over every tile is this one and shouldn't allocate at all
+	uint32_t failures = 0;
+
+	LevelWriter writer;
+	fill_level(writer, 255, 255, 20, 13);
+	Level level;
+	if (!load_level(level, writer))
+		return check_failed(failures, "could not load the test level");
+
+	uint32_t before = get_allocation_count();
+	std::vector<int32_t> counted(1);
+	if (get_allocation_count() == before)
+		failures = check_failed(failures, "allocations aren't being counted");
+
+	before = get_allocation_count();
+	const Texture *field_texture = level.get_sub_node('0').sub_texture;
+	uint32_t fields = 0, walls = 0, found = 0;
+
+	level.for_each_tile(
+		[field_texture](coord_t x, coord_t y, const NodeView &node)
+		{
+			return field_texture != nullptr && node.render.floor_texture == field_texture && (x != 0 || y != 0);
+		},
+		[&fields](coord_t, coord_t, const NodeView &)
+		{
+			fields += 1;
+		}
+	);
+	for (coord_t y = 0; y < level.get_map_height(); y++)
+	{
+		for (coord_t x = 0; x < level.get_map_width(); x++)
+		{
+			const NodeView node = level.get_node_view(x, y);
+			walls += (node.game.wall_type != NT_NONE);
+			found += (level.get_sub_nodes().find('T') != level.get_sub_nodes().end());
+			found += (level.get_sub_node('#').sub_texture == nullptr);
+		}
+	}
+	const uint32_t walk_allocations = get_allocation_count() - before;
+
+	if (walk_allocations != 0)
+		failures = check_failed(failures, "walking the tiles allocated");
+	if (fields + 1 != 255 * 255 || found != 2 * 255 * 255)
+		failures = check_failed(failures, "the walk missed tiles");
+	if (walls == 0)
+		failures = check_failed(failures, "the test level has no walls");
+
+	std::printf("  %u tiles walked, %u allocations\n", 255 * 255, walk_allocations);
+	return failures;
+}
+static uint32_t check_level_file(const LevelWriter &writer, const LevelFile &level_file, const std::vector<LevelTexture> &palette,
+	const std::vector<char> &floor_keys, const std::vector<char> &wall_keys, uint32_t failures)
+{
+	// Everything the writer was given has to come back out of the file as it went in
+	const LevelFileHeader &header = level_file.get_header();
+	if (header.width != writer.get_width() || header.height != writer.get_height() || level_file.get_base_pos() != writer.get_base_pos())
+		failures = check_failed(failures, "level file header doesn't match the writer");
+	if (level_file.get_spawn_positions() != writer.get_spawn_positions())
+		failures = check_failed(failures, "level file spawn positions don't match the writer");
+
+	const std::vector<LevelTexture> &file_palette = level_file.get_palette();
+	bool palette_ok = (file_palette.size() == palette.size());
+	for (uint8_t i = 0; palette_ok && i < palette.size(); i++)
+	{
+		palette_ok = (file_palette[i].key == palette[i].key && file_palette[i].path == palette[i].path &&
+			file_palette[i].type == (uint8_t)Level::get_node_type(palette[i].path));
+	}
+	if (!palette_ok)
+		failures = check_failed(failures, "level file palette doesn't match the writer");
+
+	// Keys outside the palette come back empty, the kind of every tile has to point at its own pair
+	uint8_t key_index[256];
+	std::fill(key_index, key_index + 256, LEVEL_FILE_EMPTY);
+	for (uint8_t i = 0; i < palette.size(); i++)
+		key_index[(uint8_t)palette[i].key] = i;
+
+	uint32_t bad_tiles = 0;
+	for (uint32_t i = 0; i < floor_keys.size(); i++)
+	{
+		const uint8_t kind = level_file.get_tiles()[i];
+		if (kind >= header.kind_count)
+		{
+			bad_tiles += 1;
+			continue;
+		}
+		bad_tiles += (level_file.get_kinds()[kind * 2] != key_index[(uint8_t)floor_keys[i]] ||
+			level_file.get_kinds()[kind * 2 + 1] != key_index[(uint8_t)wall_keys[i]]);
+	}
+	if (bad_tiles != 0)
+		failures = check_failed(failures, "level file tiles don't match the writer");
+	return failures;
+}
+uint32_t test_level_file()
+{
+	// A level goes from the writer to a buffer and a file and back, and loads the same as its text
+	uint32_t failures = 0;
+	const coord_t width = 300, height = 40;
+	const std::vector<LevelTexture> palette = {
+		{ '0', NT_FLOOR, "level/floor/dark2_base.png" },
+		{ 'T', NT_TREE, "level/tree/dark2.png" },
+		{ 'H', NT_HILL, "level/hill/dark2.png" },
+		{ '#', NT_ROAD, "level/map/road_dark.png" },
+		{ 'B', NT_BASE, "level/map/base_dark.png" }
+	};
+	const char floor_choices[3] = { '0', '0', '_' };
+	const char wall_choices[6] = { ' ', ' ', 'T', 'H', '#', '?' };
+
+	LevelWriter writer;
+	writer.init(width, height);
+	for (const LevelTexture &texture : palette)
+		writer.add_texture(texture.key, texture.path);
+	writer.add_texture('0', "level/floor/ignored.png");
+	writer.set_base_pos(std::make_pair(280, 20));
+	writer.add_spawn_pos(std::make_pair(1, 1));
+	writer.add_spawn_pos(std::make_pair(299, 39));
+
+	std::mt19937 rng(19);
+	std::vector<char> floor_keys, wall_keys;
+	for (coord_t y = 0; y < height; y++)
+	{
+		for (coord_t x = 0; x < width; x++)
+		{
+			floor_keys.push_back(floor_choices[rng() % 3]);
+			wall_keys.push_back((x == 280 && y == 20) ? 'B' : wall_choices[rng() % 6]);
+			writer.set_tile(x, y, floor_keys.back(), wall_keys.back());
+		}
+	}
+	const std::vector<uint8_t> data = writer.get_binary();
+	const std::string text = writer.get_text();
+	if (data.empty() || data.size() * 3 > text.size() * 2)
+		failures = check_failed(failures, "binary level isn't at least a third smaller than its text");
+
+	LevelFile buffer_file;
+	if (!buffer_file.open(data.data(), data.size()))
+		return check_failed(failures, "could not open the level from a buffer");
+	failures = check_level_file(writer, buffer_file, palette, floor_keys, wall_keys, failures);
+
+	const std::string path = "eosos-tests.lvl";
+	LevelFile mapped_file;
+	if (!writer.write(path) || !mapped_file.open(path))
+		failures = check_failed(failures, "could not open the level from a file");
+	else failures = check_level_file(writer, mapped_file, palette, floor_keys, wall_keys, failures);
+	mapped_file.free();
+	std::remove(path.c_str());
+
+	// Cut short or from some other format, the file has to be turned down
+	LevelFile bad_file;
+	if (bad_file.open(data.data(), data.size() - 1))
+		failures = check_failed(failures, "a truncated level file opened");
+	std::vector<uint8_t> bad_magic = data;
+	bad_magic[0] = 'X';
+	if (bad_file.open(bad_magic.data(), bad_magic.size()))
+		failures = check_failed(failures, "a level file with the wrong magic opened");
+
+	// More floor and wall pairs than a kind byte holds can't be written, the game falls back to text for those
+	LevelWriter crowded;
+	crowded.init(32, 32);
+	for (uint16_t i = 0; i < 20; i++)
+		crowded.add_texture('a' + i, "level/floor/crowded" + std::to_string(i) + ".png");
+	for (coord_t y = 0; y < 32; y++)
+	{
+		for (coord_t x = 0; x < 32; x++)
+			crowded.set_tile(x, y, 'a' + x % 20, 'a' + y % 20);
+	}
+	if (!crowded.get_binary().empty())
+		failures = check_failed(failures, "a level with too many tile kinds was written");
+
+	Level text_level, binary_level;
+	if (!text_level.load(text, false) || !binary_level.load(buffer_file, false))
+		return check_failed(failures, "could not load the level");
+
+	uint32_t mismatched = 0;
+	for (coord_t y = 0; y < height; y++)
+	{
+		for (coord_t x = 0; x < width; x++)
+		{
+			mismatched += (text_level.get_wall(x, y) != binary_level.get_wall(x, y) ||
+				text_level.get_wall_type(x, y) != binary_level.get_wall_type(x, y));
+		}
+	}
+	if (text_level.get_map_width() != width || text_level.get_map_height() != height ||
+		binary_level.get_map_width() != width || binary_level.get_map_height() != height || mismatched != 0)
+		failures = check_failed(failures, "text and binary levels loaded differently");
+	return failures;
+}
+uint32_t test_bit_masks()
+{
+	// Masks and windows built from whole words against reading every tile on its own,
+	// on widths either side of the word size so rows straddle words everywhere
+	const coord_t widths[7] = { 1, 5, 62, 63, 64, 65, 200 };
+	const int8_t offset_x[8] = { 0, 0, -1, 1, -1, 1, -1, 1 };
+	const int8_t offset_y[8] = { -1, 1, 0, 0, -1, -1, 1, 1 };
+
+	uint32_t failures = 0, masks = 0;
+	std::mt19937 rng(10);
+	for (coord_t width : widths)
+	{
+		for (uint8_t border = 0; border < 2; border++)
+		{
+			const coord_t height = 1 + rng() % 20;
+			BitGrid grid;
+			grid.init(width, height, border);
+			for (coord_t y = 0; y < height; y++)
+			{
+				for (coord_t x = 0; x < width; x++)
+					grid.set(x, y, rng() % 3 == 0);
+			}
+			std::vector<uint8_t> row(width);
+			for (coord_t y = 0; y < height; y++)
+			{
+				grid.get_row_neighbors(0, y, width, row.data());
+				for (coord_t x = 0; x < width; x++)
+				{
+					uint8_t expected = 0;
+					for (uint8_t i = 0; i < 8; i++)
+						expected |= grid.get(x + offset_x[i], y + offset_y[i]) << i;
+
+					uint32_t window = 0;
+					for (int8_t wy = 0; wy < 5; wy++)
+					{
+						for (int8_t wx = 0; wx < 5; wx++)
+							window |= grid.get(x + wx - 2, y + wy - 2) << (wy * 5 + wx);
+					}
+					if (grid.get_neighbors(x, y) != expected)
+						failures = check_failed(failures, "neighbour mask doesn't match its tiles");
+					if (row[x] != expected)
+						failures = check_failed(failures, "row mask doesn't match its tiles");
+					if (grid.get_window(x, y) != window)
+						failures = check_failed(failures, "window doesn't match its tiles");
+					masks += 1;
+				}
+				// A span starting partway along the row has to line up with the whole row
+				const coord_t first = rng() % width;
+				std::vector<uint8_t> span(width - first);
+				grid.get_row_neighbors(first, y, width, span.data());
+				if (!std::equal(span.begin(), span.end(), row.begin() + first))
+					failures = check_failed(failures, "row span doesn't match the whole row");
+			}
+		}
+	}
+	std::printf("  %u masks compared\n", masks);
+	return failures;
+}
@@ -0,0 +1,310 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+#include "engine.hpp"
+#include "tests.hpp"
+#include "level.hpp"
+#include "actor.hpp"
+#include "level_file.hpp"
+#include "generator_forest.hpp"
+#include "astar.hpp"
+#include "dijkstra.hpp"
+#include "path_engine.hpp"
+#include "path_grid.hpp"
+#include "path_hierarchy.hpp"
+#include "headless.hpp"
+
+#include <cmath>
+#include <functional>
+#include <queue>
+
+// Same neighbour order as the wall masks
+const int8_t offset_x[8] = { 0, 0, -1, 1, -1, 1, -1, 1 };
+const int8_t offset_y[8] = { -1, 1, 0, 0, -1, -1, 1, 1 };
+
+static bool get_path_cost(const PathGrid &grid, Point start, Point end, uint8_t finder, const std::vector<Point> &path, float &cost, uint32_t &passed)
+{
+	// Paths run goal first and leave out the start, every step has to be one the wall mask allows
+	// and none may land on an actor of the finder's own type. Other actors are counted as passed.
+	cost = 0.0f;
+	if (path.empty() || path.front().x != end.x || path.front().y != end.y)
+		return false;
+
+	Point pos = start;
+	for (auto it = path.rbegin(); it != path.rend(); ++it)
+	{
+		const int32_t dx = it->x - pos.x, dy = it->y - pos.y;
+		uint8_t i = 0;
+		while (i < 8 && (offset_x[i] != dx || offset_y[i] != dy))
+			i++;
+		if (i == 8 || ((grid.get_wall_mask(pos.x, pos.y) >> i) & 1) || grid.get_actor_type(it->x, it->y) == finder)
+			return false;
+
+		passed += (grid.get_actor_type(it->x, it->y) != ACTOR_NULL);
+		cost += (i > 3) ? 1.4f : 1.0f;
+		pos = *it;
+	}
+	return true;
+}
+static bool get_best_cost(const PathGrid &grid, Point start, Point end, uint8_t finder, float &cost)
+{
+	// Plain Dijkstra under the same rules, in tenths of a step so the costs add up exactly
+	const coord_t width = grid.get_map_width();
+	std::vector<uint32_t> best(width * grid.get_map_height(), UINT32_MAX);
+	std::priority_queue< std::pair<uint32_t, int32_t>, std::vector< std::pair<uint32_t, int32_t> >,
+		std::greater< std::pair<uint32_t, int32_t> > > open;
+
+	best[start.y * width + start.x] = 0;
+	open.push(std::make_pair(0, start.y * width + start.x));
+	while (!open.empty())
+	{
+		const std::pair<uint32_t, int32_t> q = open.top();
+		open.pop();
+		const coord_t x = q.second % width, y = q.second / width;
+		if (q.first != best[q.second])
+			continue;
+		if (x == end.x && y == end.y)
+		{
+			cost = q.first / 10.0f;
+			return true;
+		}
+		const uint8_t blocked = grid.get_wall_mask(x, y);
+		for (uint8_t i = 0; i < 8; i++)
+		{
+			const coord_t nx = x + offset_x[i], ny = y + offset_y[i];
+			if (((blocked >> i) & 1) || grid.get_actor_type(nx, ny) == finder)
+				continue;
+
+			const int32_t n = ny * width + nx;
+			const uint32_t g = q.first + ((i > 3) ? 14 : 10);
+			if (g < best[n])
+			{
+				best[n] = g;
+				open.push(std::make_pair(g, n));
+			}
+		}
+	}
+	return false;
+}
+uint32_t test_jump_lengths()
+{
+	// Plain A* stops once it sees the goal and its straight line estimate runs a little over
+	// the diagonal cost, so it may come out longer but jump point search never should. Both have
+	// to go around heroes like the finder and straight through the monsters and mounts.
+	const uint32_t map_count = 2000;
+	const uint8_t pairs_per_map = 8;
+	const uint8_t finder = ACTOR_HERO;
+
+	GeneratorForest generator;
+	PathEngine path_engine;
+	std::mt19937 rng(3);
+	uint32_t failures = 0, compared = 0, shorter = 0, passed = 0;
+
+	for (uint32_t m = 0; m < map_count; m++)
+	{
+		LevelWriter writer;
+		generator.generate(m % 5 + 1, Level::get_depth_seed(1000 + m, m % 5 + 1), writer);
+		PathGrid grid;
+		grid.init(writer);
+
+		// About one open tile in eight gets somebody standing on it
+		const uint8_t actor_types[3] = { ACTOR_HERO, ACTOR_MONSTER, ACTOR_MOUNT };
+		std::vector<Point> open;
+		for (coord_t y = 0; y < grid.get_map_height(); y++)
+		{
+			for (coord_t x = 0; x < grid.get_map_width(); x++)
+			{
+				if (grid.get_wall(x, y))
+					continue;
+				if (rng() % 8 == 0)
+					grid.set_actor_type(x, y, actor_types[rng() % 3]);
+				else open.push_back(Point(x, y));
+			}
+		}
+		if (open.size() < 2)
+		{
+			failures = check_failed(failures, "generated map without open tiles");
+			continue;
+		}
+		for (uint8_t p = 0; p < pairs_per_map; p++)
+		{
+			const Point start = open[rng() % open.size()], end = open[rng() % open.size()];
+			if (start.x == end.x && start.y == end.y)
+				continue;
+
+			std::vector<Point> grid_path, jump_path;
+			float grid_cost = 0.0f, jump_cost = 0.0f, best_cost = 0.0f;
+			uint32_t grid_passed = 0, jump_passed = 0;
+
+			// The grid search hands back the closest node when the goal can't be reached, so it only counts if it got there
+			const bool best_found = get_best_cost(grid, start, end, finder, best_cost);
+			const bool grid_found = path_engine.find_path(&grid, start, end, finder, grid_path) &&
+				get_path_cost(grid, start, end, finder, grid_path, grid_cost, grid_passed);
+			const bool jump_found = path_engine.find_path_jump(&grid, start, end, finder, jump_path);
+
+			if (grid_found != best_found)
+				failures = check_failed(failures, "A* and Dijkstra disagree on whether a path exists");
+			if (jump_found != best_found)
+				failures = check_failed(failures, "jump point search and Dijkstra disagree on whether a path exists");
+			else if (jump_found && !get_path_cost(grid, start, end, finder, jump_path, jump_cost, jump_passed))
+				failures = check_failed(failures, "jump point path steps through a wall or a hero, or misses the goal");
+			else if (jump_found && std::fabs(jump_cost - best_cost) > 0.01f * jump_path.size())
+				failures = check_failed(failures, "jump point path is not the shortest one");
+			else if (jump_found && grid_found && jump_cost > grid_cost + 0.01f * jump_path.size())
+				failures = check_failed(failures, "jump point path is longer than the A* one");
+			else if (jump_found)
+			{
+				compared += 1;
+				shorter += (grid_found && jump_cost < grid_cost - 0.01f * jump_path.size());
+				passed += jump_passed;
+			}
+		}
+	}
+	// Nobody got walked through otherwise, and going around everyone would look just as fine
+	if (passed == 0)
+		failures = check_failed(failures, "no path went through a monster or a mount");
+
+	std::printf("  %u maps, %u paths compared, %u shorter than A*, %u steps through other actors\n", map_count, compared, shorter, passed);
+	return failures;
+}
+uint32_t test_goal_repair()
+{
+	// Goals moving one at a time through the repair have to leave the same distances as a map built from scratch
+	const uint8_t map_count = 8;
+	const uint16_t moves_per_map = 300;
+
+	std::mt19937 rng(5);
+	uint32_t failures = 0;
+
+	for (uint8_t m = 0; m < map_count; m++)
+	{
+		LevelWriter writer;
+		fill_level(writer, 48, 32, 25, 100 + m);
+		Level level;
+		if (!load_level(level, writer))
+		{
+			failures = check_failed(failures, "filled level did not load");
+			continue;
+		}
+		const coord_t width = level.get_map_width();
+		const std::vector<int32_t> open = get_open_tiles(level);
+
+		// Goals may share a tile, removing one of them must leave the other seeded
+		std::vector<int32_t> goals;
+		for (uint8_t i = 0; i < 4; i++)
+			goals.push_back(open[rng() % open.size()]);
+
+		Dijkstra map;
+		map.build_map(&level, goals);
+
+		// Goals can also end up under a wall, they must not be seeded until it's gone again
+		int32_t wall = 0;
+		while (!level.get_wall(wall % width, wall / width))
+			wall++;
+		const MapNode wall_node = level.get_node(wall % width, wall / width);
+		const MapNode open_node = level.get_node(open[0] % width, open[0] / width);
+
+		auto check = [&](const char *what)
+		{
+			Dijkstra fresh;
+			fresh.build_map(&level, goals);
+
+			bool same = true;
+			for (coord_t y = 0; y < level.get_map_height() && same; y++)
+			{
+				for (coord_t x = 0; x < width && same; x++)
+					same = (map.get_distance(x, y) == fresh.get_distance(x, y));
+			}
+			if (!same)
+				failures = check_failed(failures, what);
+		};
+		for (uint16_t i = 0; i < moves_per_map; i++)
+		{
+			const uint8_t g = rng() % goals.size();
+			const int32_t from = goals[g], to = open[rng() % open.size()];
+			const bool walled = (i % 3 == 0);
+			if (walled)
+			{
+				level.set_node(from % width, from / width, wall_node);
+				map.on_tile_changed(&level, from % width, from / width);
+				check("goal map differs from a fresh build after walling a goal in");
+				if (map.get_distance(from % width, from / width) != DIJKSTRA_UNREACHED)
+					failures = check_failed(failures, "goal under a wall is still seeded");
+			}
+			map.add_source(&level, to % width, to / width);
+			map.remove_source(&level, from % width, from / width);
+			goals[g] = to;
+			check("goal map differs from a fresh build after a goal moved");
+
+			if (walled)
+			{
+				level.set_node(from % width, from / width, open_node);
+				map.on_tile_changed(&level, from % width, from / width);
+				check("goal map differs from a fresh build after a wall opened");
+			}
+		}
+	}
+	return failures;
+}
+uint32_t test_exact_modes()
+{
+	// Only PATH_CLUSTER may hand back a cluster graph path, the other modes have to match
+	// the plain searches even for trips long enough that the hierarchy would take them
+	const uint16_t size = 160;
+	const uint16_t pair_count = 200;
+
+	LevelWriter writer;
+	fill_level(writer, size, size, 20, 9);
+	Level level;
+	if (!load_level(level, writer) || level.get_path_hierarchy() == nullptr)
+		return check_failed(0, "filled level did not load with a cluster graph");
+
+	const std::vector<int32_t> open = get_open_tiles(level);
+	PathEngine *path_engine = level.get_path_engine();
+	std::mt19937 rng(13);
+	uint32_t failures = 0, cluster_found = 0;
+
+	for (uint16_t i = 0; i < pair_count; i++)
+	{
+		int32_t a, b;
+		do
+		{
+			a = open[rng() % open.size()];
+			b = open[rng() % open.size()];
+		}
+		while (std::abs(a % size - b % size) < PATH_HIERARCHY_MIN_DISTANCE && std::abs(a / size - b / size) < PATH_HIERARCHY_MIN_DISTANCE);
+		const Point start(a % size, a / size), end(b % size, b / size);
+
+		std::vector<Point> grid_path, jump_path, cluster_path;
+		const bool grid_found = path_engine->find_path(&level, start, end, 1, grid_path);
+		const bool jump_found = path_engine->find_path_jump(&level, start, end, 1, jump_path) ||
+			path_engine->find_path(&level, start, end, 1, jump_path);
+		cluster_found += level.get_path_hierarchy()->find_path(&level, start, end, 1, cluster_path);
+
+		AStar grid_finder, jump_finder;
+		if (grid_finder.find_path(&level, start, end, 1, PATH_GRID) != grid_found ||
+			grid_finder.get_length() != grid_path.size())
+			failures = check_failed(failures, "PATH_GRID query did not match the grid search");
+		if (jump_finder.find_path(&level, start, end, 1, PATH_JUMP) != jump_found ||
+			jump_finder.get_length() != jump_path.size())
+			failures = check_failed(failures, "PATH_JUMP query did not match the jump point search");
+	}
+	// Otherwise the pairs never got far enough apart for the check to mean anything
+	if (cluster_found == 0)
+		failures = check_failed(failures, "the cluster graph found none of the pairs");
+	return failures;
+}
@@ -0,0 +1,72 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+#include "engine.hpp"
+#include "tests.hpp"
+
+#include <cstring>
+
+// Headless tests for the level and pathfinding code, run by make check.
+// Exits with 1 if any check fails, run them all or just the ones named on the command line.
+
+Engine engine;
+
+const TestCase test_cases[] =
+{
+	{ "turn_order", "the turn scheduler goes in the same order as the old actor scan", test_turn_order },
+	{ "pool_handles", "actor handles keep resolving past 65536 actors and go stale when their slot is reused", test_pool_handles },
+	{ "tile_walk", "walking every tile of a level with views and for_each_tile allocates nothing", test_tile_walk },
+	{ "level_file", "levels survive the binary format and load the same as their text", test_level_file },
+	{ "bit_masks", "neighbour masks, row masks and windows read from whole words match the single tiles", test_bit_masks },
+	{ "jump", "jump point paths are the shortest ones and only go around the finder's own kind", test_jump_lengths },
+	{ "goal_repair", "goal maps repaired as goals move match maps built from scratch", test_goal_repair },
+	{ "exact_modes", "grid and jump point queries never come back over the cluster graph", test_exact_modes }
+};
+
+int main(int argc, char *argv[])
+{
+	if (argc > 1 && (std::strcmp(argv[1], "-h") == 0 || std::strcmp(argv[1], "--help") == 0))
+	{
+		std::cout << "Usage: eosos-tests [test ...]" << std::endl;
+		for (const TestCase &test : test_cases)
+			std::printf("  %-12s %s\n", test.name, test.description);
+		return 0;
+	}
+	uint8_t ran = 0, failed = 0;
+	for (const TestCase &test : test_cases)
+	{
+		bool selected = (argc < 2);
+		for (int i = 1; i < argc && !selected; i++)
+			selected = (std::strcmp(argv[i], test.name) == 0);
+		if (!selected)
+			continue;
+
+		const uint32_t failures = test.run();
+		std::printf("%-12s %s\n", test.name, (failures == 0) ? "ok" : "FAILED");
+		if (failures != 0)
+			std::printf("  %u failed checks\n", failures);
+		ran += 1;
+		failed += (failures != 0);
+	}
+	if (ran == 0)
+	{
+		std::cerr << "No such test, see eosos-tests --help" << std::endl;
+		return 1;
+	}
+	std::printf("%u of %u tests passed\n", ran - failed, ran);
+	return (failed == 0) ? 0 : 1;
+}
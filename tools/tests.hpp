@@ -0,0 +1,59 @@
+//	Copyright (C) 2018 Jere Oikarinen
+//
+//	This file is part of Eosos.
+//
+//	Eosos is free software : you can redistribute it and / or modify
+//	it under the terms of the GNU General Public License as published by
+//	the Free Software Foundation, either version 3 of the License, or
+//	(at your option) any later version.
+//
+//	Eosos is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//	GNU General Public License for more details.
+//
+//	You should have received a copy of the GNU General Public License
+//	along with Eosos. If not, see <http://www.gnu.org/licenses/>.
+
+#ifndef TESTS_HPP
+#define TESTS_HPP
+
+#include <cstdio>
+
+// Every test returns how many of its checks failed
+typedef struct
+{
+	const char *name;
+	const char *description;
+	uint32_t (*run)();
+}
+TestCase;
+
+// Prints the first few failures of a test, the rest only go into the count
+inline uint32_t check_failed(uint32_t failures, const char *what)
+{
+	if (failures < 10)
+		std::printf("  failed: %s\n", what);
+	return failures + 1;
+}
+
+// Allocations made so far by the whole test binary, counted in test_alloc.cpp
+uint32_t get_allocation_count();
+
+// The tests, grouped by the file they live in
+
+// test_actor.cpp
+uint32_t test_turn_order();
+uint32_t test_pool_handles();
+
+// test_level.cpp
+uint32_t test_tile_walk();
+uint32_t test_level_file();
+uint32_t test_bit_masks();
+
+// test_path.cpp
+uint32_t test_jump_lengths();
+uint32_t test_goal_repair();
+uint32_t test_exact_modes();
+
+#endif // TESTS_HPP